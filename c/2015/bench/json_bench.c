@@ -0,0 +1,338 @@
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "json/cursor.h"
+#include "json/dom.h"
+#include "json/index.h"
+#include "json/lexer.h"
+#include "json/parser.h"
+#include "json/sax.h"
+
+/*
+ * Throughput of every way of reading a JSON document, on generated documents of four shapes:
+ *
+ *  bin/json_bench [kilobytes per document] [repetitions]
+ *
+ * Every reader runs in a child process of its own, so the peak resident memory the kernel reports for the child is the
+ * memory that reader needed. It is given above that of a child which does nothing, so the document itself is left out.
+ * Throughput is the best of the repetitions. The project builds in Debug, so compare readers and commits with each
+ * other rather than against other libraries.
+ */
+
+#define BENCH_DEFAULT_KILOBYTES     16384
+#define BENCH_DEFAULT_REPETITIONS   5
+
+typedef struct bench_buffer_t {
+    char    *data;
+    size_t  length;
+    size_t  capacity;
+} bench_buffer_t;
+
+static void bench_append(bench_buffer_t *buffer, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void bench_append(bench_buffer_t *buffer, const char *format, ...) {
+    va_list arguments;
+    for(;;) {
+        va_start(arguments, format);
+        int written = vsnprintf(buffer->data + buffer->length, buffer->capacity - buffer->length, format, arguments);
+        va_end(arguments);
+
+        if(written < 0) {
+            fprintf(stderr, "%s:%s:%d: failed to format the document\n", __FILE__, __func__, __LINE__);
+            exit(EXIT_FAILURE);
+        }
+        if((size_t)written < buffer->capacity - buffer->length) {
+            buffer->length += (size_t)written;
+            return;
+        }
+
+        buffer->capacity    = buffer->capacity * 2 + (size_t)written;
+        buffer->data        = realloc(buffer->data, buffer->capacity);
+        if(buffer->data == NULL) {
+            fprintf(stderr, "%s:%s:%d: failed to grow the document\n", __FILE__, __func__, __LINE__);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// Records nested 64 levels deep, alternating between objects and arrays.
+static void bench_generate_deep(bench_buffer_t *buffer, size_t i) {
+    for(size_t depth = 0; depth < 32; depth++) {
+        bench_append(buffer, "{\"level\": %zu, \"next\": [", depth);
+    }
+    bench_append(buffer, "%zu", i);
+    for(size_t depth = 0; depth < 32; depth++) {
+        bench_append(buffer, "]}");
+    }
+}
+
+// Records with many short members, enough for every object to get a key index.
+static void bench_generate_wide(bench_buffer_t *buffer, size_t i) {
+    bench_append(buffer, "{");
+    for(size_t k = 0; k < 24; k++) {
+        bench_append(buffer, "%s\"field_%02zu\": %s", k == 0 ? "" : ", ", k, k % 3 == 0 ? "true" : k % 3 == 1 ? "null" : "\"x\"");
+    }
+    bench_append(buffer, ", \"id\": %zu}", i);
+}
+
+// Long strings with the occasional escape sequence, which is where the structural index skips the most.
+static void bench_generate_strings(bench_buffer_t *buffer, size_t i) {
+    bench_append(buffer, "\"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et "
+        "dolore magna aliqua. \\\"Record %zu\\\"\\n\\tUt enim ad minim veniam, quis nostrud exercitation ullamco laboris.\"", i);
+}
+
+// Integers of every size and doubles in the forms the fast paths of number_parse_f64 do and do not take.
+static void bench_generate_numbers(bench_buffer_t *buffer, size_t i) {
+    uint64_t x = i * 0x9e3779b97f4a7c15ull;
+    bench_append(buffer, "[%zu, -%llu, %llu, %zu.%03zu, %.17g, -%llu.5e-%zu]", i, (unsigned long long)(x >> 40), (unsigned long long)(x >> 1), i % 1000,
+        i % 997, (double)(x >> 11) * 0x1.0p-53 * 1e6, (unsigned long long)(x >> 44), i % 300);
+}
+
+typedef struct bench_document_t {
+    const char  *name;
+    void        (*generate)(bench_buffer_t *buffer, size_t i);
+} bench_document_t;
+
+static const bench_document_t bench_documents[] = {
+    { "deep",       bench_generate_deep },
+    { "wide",       bench_generate_wide },
+    { "strings",    bench_generate_strings },
+    { "numbers",    bench_generate_numbers }
+};
+
+/**
+ * bench_generate: Generate an array of records of one shape that is at least as long as asked for.
+ */
+static char *bench_generate(const bench_document_t *document, size_t length, size_t *out_length) {
+    bench_buffer_t buffer = { .data = malloc(length + 4096), .length = 0, .capacity = length + 4096 };
+    if(buffer.data == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate the document\n", __FILE__, __func__, __LINE__);
+        exit(EXIT_FAILURE);
+    }
+
+    bench_append(&buffer, "[");
+    for(size_t i = 0; i == 0 || buffer.length < length; i++) {
+        bench_append(&buffer, i == 0 ? "\n" : ",\n");
+        document->generate(&buffer, i);
+    }
+    bench_append(&buffer, "\n]\n");
+
+    *out_length = buffer.length;
+    return buffer.data;
+}
+
+static bool bench_index(const char *data, size_t length) {
+    size_t index_length = 0;
+    uint32_t *index     = json_index_build(data, length, &index_length);
+    free(index);
+    return index != NULL;
+}
+
+static bool bench_lex(const char *data, size_t length) {
+    (void)length;
+    size_t number_of_tokens = 0;
+    json_token_t *tokens    = json_lex(data, &number_of_tokens);
+    free(tokens);
+    return tokens != NULL;
+}
+
+static bool bench_parse(const char *data, size_t length) {
+    (void)length;
+    json_node_t *node = json_parse_string(data);
+    json_node_destroy(node);
+    return node != NULL;
+}
+
+static bool bench_sax(const char *data, size_t length) {
+    static const json_sax_handler_t handler = { 0 };
+    return json_sax_parse(data, length, &handler, NULL);
+}
+
+/**
+ * bench_cursor: Read every value with the cursor, which is the most an on-demand reader would ever be asked to do.
+ */
+static bool bench_cursor(const char *data, size_t length) {
+    json_cursor_t cursor;
+    if(!json_cursor_init(&cursor, data, length)) {
+        return false;
+    }
+
+    size_t depth = 0;
+    json_value_type_t type;
+    string_view_t view;
+    json_number_t number;
+    bool boolean;
+    bool result = true;
+
+    do {
+        if(!json_cursor_peek(&cursor, &type)) {
+            result = false;
+            break;
+        }
+        switch(type) {
+            case JSON_VALUE_TYPE_OBJECT:
+            case JSON_VALUE_TYPE_ARRAY:
+                result = json_cursor_enter(&cursor);
+                depth++;
+                break;
+            case JSON_VALUE_TYPE_STRING:
+                result = json_cursor_get_string(&cursor, &view);
+                break;
+            case JSON_VALUE_TYPE_NUMBER:
+                result = json_cursor_get_number(&cursor, &number);
+                break;
+            case JSON_VALUE_TYPE_BOOL:
+                result = json_cursor_get_bool(&cursor, &boolean);
+                break;
+            default:
+                result = json_cursor_skip(&cursor);
+                break;
+        }
+        while(result && depth > 0 && !json_cursor_next(&cursor, &view)) {
+            result = !cursor.error;
+            depth--;
+        }
+    } while(result && depth > 0);
+
+    json_cursor_free(&cursor);
+    return result;
+}
+
+static bool bench_dom(const char *data, size_t length) {
+    (void)length;
+    json_document_t *document = json_document_parse(data);
+    json_document_destroy(document);
+    return document != NULL;
+}
+
+static bool bench_dom_parallel(const char *data, size_t length) {
+    (void)length;
+    long number_of_processors   = sysconf(_SC_NPROCESSORS_ONLN);
+    json_document_t *document   = json_document_parse_parallel(data, number_of_processors > 0 ? (size_t)number_of_processors : 1);
+    json_document_destroy(document);
+    return document != NULL;
+}
+
+static bool bench_nothing(const char *data, size_t length) {
+    (void)data;
+    (void)length;
+    return true;
+}
+
+typedef struct bench_reader_t {
+    const char  *name;
+    bool        (*read)(const char *data, size_t length);
+} bench_reader_t;
+
+static const bench_reader_t bench_readers[] = {
+    { "json_index_build",               bench_index },
+    { "json_lex",                       bench_lex },
+    { "json_parse_string",              bench_parse },
+    { "json_sax_parse",                 bench_sax },
+    { "json_cursor",                    bench_cursor },
+    { "json_document_parse",            bench_dom },
+    { "json_document_parse_parallel",   bench_dom_parallel }
+};
+
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * bench_run: Time a reader in a child process.
+ * @param out_seconds Receives the fastest of the repetitions.
+ * @param out_peak_kilobytes Receives the peak resident memory of the child.
+ * @return False if the reader rejected the document or the child could not be run.
+ */
+static bool bench_run(const bench_reader_t *reader, const char *data, size_t length, size_t repetitions, double *out_seconds, long *out_peak_kilobytes) {
+    int fds[2];
+    if(pipe(fds) != 0) {
+        fprintf(stderr, "%s:%s:%d: failed to create a pipe\n", __FILE__, __func__, __LINE__);
+        return false;
+    }
+
+    pid_t pid = fork();
+    if(pid < 0) {
+        fprintf(stderr, "%s:%s:%d: failed to fork\n", __FILE__, __func__, __LINE__);
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if(pid == 0) {
+        close(fds[0]);
+        double best = -1;
+        for(size_t i = 0; i < repetitions; i++) {
+            double start = bench_now();
+            if(!reader->read(data, length)) {
+                _exit(EXIT_FAILURE);
+            }
+            double elapsed = bench_now() - start;
+            best = best < 0 || elapsed < best ? elapsed : best;
+        }
+        ssize_t written = write(fds[1], &best, sizeof(best));
+        _exit(written == sizeof(best) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+    ssize_t received = read(fds[0], out_seconds, sizeof(*out_seconds));
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    if(wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS || received != sizeof(*out_seconds)) {
+        return false;
+    }
+    *out_peak_kilobytes = usage.ru_maxrss;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    size_t kilobytes    = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_KILOBYTES;
+    size_t repetitions  = argc > 2 ? strtoul(argv[2], NULL, 10) : BENCH_DEFAULT_REPETITIONS;
+    if(kilobytes == 0 || repetitions == 0) {
+        fprintf(stderr, "usage: %s [kilobytes per document] [repetitions]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bool failed = false;
+    printf("%-10s %10s  %-30s %10s %12s\n", "document", "MB", "reader", "MB/s", "peak MB");
+
+    for(size_t d = 0; d < sizeof(bench_documents) / sizeof(bench_documents[0]); d++) {
+        size_t length;
+        char *data = bench_generate(&bench_documents[d], kilobytes * 1024, &length);
+
+        double seconds;
+        long baseline_kilobytes;
+        bench_reader_t nothing = { "nothing", bench_nothing };
+        if(!bench_run(&nothing, data, length, 1, &seconds, &baseline_kilobytes)) {
+            fprintf(stderr, "%s:%s:%d: failed to measure the baseline\n", __FILE__, __func__, __LINE__);
+            return EXIT_FAILURE;
+        }
+
+        for(size_t r = 0; r < sizeof(bench_readers) / sizeof(bench_readers[0]); r++) {
+            long peak_kilobytes;
+            if(!bench_run(&bench_readers[r], data, length, repetitions, &seconds, &peak_kilobytes)) {
+                printf("%-10s %10.2f  %-30s %10s %12s\n", bench_documents[d].name, length / 1e6, bench_readers[r].name, "failed", "-");
+                failed = true;
+                continue;
+            }
+
+            long extra_kilobytes = peak_kilobytes > baseline_kilobytes ? peak_kilobytes - baseline_kilobytes : 0;
+            printf("%-10s %10.2f  %-30s %10.1f %12.2f\n", bench_documents[d].name, length / 1e6, bench_readers[r].name, length / 1e6 / seconds,
+                extra_kilobytes * 1024 / 1e6);
+        }
+        free(data);
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#ifndef ARENA4C_H
+#define ARENA4C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * arena_t: A bump allocator for objects that live and die together, such as the nodes of a parsed document. Memory is
+ * taken from large blocks by moving a pointer, individual allocations are never freed, and destroying the arena releases
+ * every block at once. When a block runs out, a new one at least twice as large is chained on, so the number of blocks
+ * grows with the logarithm of the total size.
+ */
+typedef struct arena_t arena_t;
+
+/**
+ * arena_create: Create an arena.
+ * @param capacity The size of the first block in bytes. Sizing it for the expected total keeps everything in one block.
+ * @return The arena, or NULL if memory could not be allocated.
+ */
+arena_t *arena_create(size_t capacity);
+
+void arena_destroy(arena_t *arena);
+
+/**
+ * arena_alloc: Allocate memory aligned for any type. The memory is not initialised.
+ * @return The memory, which lives until the arena is destroyed or reset, or NULL if memory could not be allocated.
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * arena_reset: Make all memory available again without returning it to the system. Every earlier allocation becomes
+ * invalid. Only the largest block is kept.
+ */
+void arena_reset(arena_t *arena);
+
+/**
+ * arena_merge: Move every block of other into arena, so that memory allocated from either lives until arena is destroyed.
+ * Lets allocations be made from separate arenas, such as one per thread, and end up owned by one. Other is destroyed.
+ */
+void arena_merge(arena_t *arena, arena_t *other);
+
+/**
+ * arena_get_used: Get the number of bytes handed out since the arena was created or reset, including alignment padding.
+ */
+size_t arena_get_used(const arena_t *arena);
+
+/**
+ * arena_get_capacity: Get the number of bytes the arena holds across all of its blocks.
+ */
+size_t arena_get_capacity(const arena_t *arena);
+
+#endif
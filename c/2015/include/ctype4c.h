@@ -0,0 +1,64 @@
+#ifndef CTYPE4C_H
+#define CTYPE4C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "simd4c.h"
+
+/**
+ * Byte classification through a 256 entry table of class flags, so every test is one load and one AND instead of a
+ * chain of comparisons. Unlike <ctype.h> the result never depends on the locale and any char, signed or not, is a valid
+ * argument.
+ *
+ * To classify whole buffers, turn a set of classes into a simd_byte_set_t once with ctype_build_set and scan it with
+ * simd_count_in_set, simd_find_in_set or simd_find_not_in_set.
+ */
+
+typedef enum ctype_class_t {
+    CTYPE_DIGIT             = 1 << 0,   // 0-9
+    CTYPE_HEX_DIGIT         = 1 << 1,   // 0-9, a-f and A-F
+    CTYPE_SPACE             = 1 << 2,   // The bytes isspace accepts in the C locale: space, \t, \n, \v, \f and \r.
+    CTYPE_LOWER             = 1 << 3,   // a-z
+    CTYPE_UPPER             = 1 << 4,   // A-Z
+    CTYPE_VOWEL             = 1 << 5,   // a, e, i, o and u in either case.
+    CTYPE_NUMBER            = 1 << 6,   // Anything that can occur in a JSON number: 0-9, +, -, ., e and E.
+    CTYPE_JSON_STRUCTURAL   = 1 << 7    // {, }, [, ], : and ,
+} ctype_class_t;
+
+#define CTYPE_ALPHA (CTYPE_LOWER | CTYPE_UPPER)
+
+/**
+ * ctype_classes: The classes of every byte, generated at compile time.
+ */
+extern const uint8_t ctype_classes[256];
+
+/**
+ * ctype_hex_values: The value of every hexadecimal digit, and -1 for every other byte.
+ */
+extern const int8_t ctype_hex_values[256];
+
+/**
+ * ctype_is: Check whether a byte belongs to any of the classes in a mask of ctype_class_t flags.
+ */
+static inline bool ctype_is(char c, uint8_t classes) {
+    return (ctype_classes[(unsigned char)c] & classes) != 0;
+}
+
+static inline bool ctype_is_digit(char c) {
+    return ctype_is(c, CTYPE_DIGIT);
+}
+
+static inline bool ctype_is_space(char c) {
+    return ctype_is(c, CTYPE_SPACE);
+}
+
+static inline int ctype_hex_value(char c) {
+    return ctype_hex_values[(unsigned char)c];
+}
+
+/**
+ * ctype_build_set: Fill a byte set with every byte that belongs to any of the classes in a mask.
+ */
+void ctype_build_set(simd_byte_set_t *set, uint8_t classes);
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef DEQUE4C_H
+#define DEQUE4C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Ring buffer containers.
+ *
+ * Both containers keep their capacity at a power of two so that wrapping an index is a single mask. They are
+ * specialised per element type in the same way as the grids:
+ *
+ *     typedef DEQUE_OF_TYPE(Point) DequePoint;
+ *     CREATE_DEQUE_IMPL_FOR(DequePoint, Point)
+ *
+ * DEQUE_OF_TYPE is a growable double-ended queue for single threaded use, e.g. the frontier of a breadth first search.
+ * SPSC_QUEUE_OF_TYPE is a fixed capacity lock-free queue for exactly one producer thread and one consumer thread, e.g.
+ * a reader thread handing batches of parsed lines to a compute thread.
+ */
+
+static inline size_t deque_round_up_to_power_of_two(size_t n) {
+    size_t result = 1;
+    while(result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+#define DEQUE_OF_TYPE(T)    \
+    struct                  \
+    {                       \
+        T *elements;        \
+        size_t mask;        \
+        size_t head;        \
+        size_t size;        \
+    }
+
+#define CREATE_DEQUE_FOR(TDeque, TElement)                                                      \
+    TDeque *deque_create_##TDeque(size_t capacity);                                             \
+    void deque_destroy_##TDeque(TDeque *deque);                                                 \
+    bool deque_reserve_##TDeque(TDeque *deque, size_t capacity);                                \
+    bool deque_push_back_##TDeque(TDeque *deque, TElement element);                             \
+    bool deque_push_front_##TDeque(TDeque *deque, TElement element);                            \
+    bool deque_push_back_n_##TDeque(TDeque *deque, TElement const *elements, size_t count);     \
+    bool deque_pop_back_##TDeque(TDeque *deque, TElement *out_element);                         \
+    bool deque_pop_front_##TDeque(TDeque *deque, TElement *out_element);                        \
+    size_t deque_pop_front_n_##TDeque(TDeque *deque, TElement *out_elements, size_t count);     \
+    TElement *deque_get_##TDeque(TDeque *deque, size_t pos);                                    \
+    void deque_clear_##TDeque(TDeque *deque)
+
+#define CREATE_DEQUE_IMPL_FOR(TDeque, TElement)                                                                     \
+    bool deque_reserve_##TDeque(TDeque *deque, size_t capacity)                                                     \
+    {                                                                                                               \
+        size_t old_capacity = deque->elements == NULL ? 0 : deque->mask + 1;                                        \
+        if (capacity <= old_capacity)                                                                               \
+        {                                                                                                           \
+            return true;                                                                                            \
+        }                                                                                                           \
+        size_t new_capacity = deque_round_up_to_power_of_two(capacity);                                             \
+        TElement *elements = malloc(new_capacity * sizeof(TElement));                                               \
+        if (elements == NULL)                                                                                       \
+        {                                                                                                           \
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for deque elements\n", __FILE__, __func__, __LINE__); \
+            return false;                                                                                           \
+        }                                                                                                           \
+        /* Unwrap the ring so the elements start at index 0 of the new buffer. */                                   \
+        size_t first_part = deque->size < old_capacity - deque->head ? deque->size : old_capacity - deque->head;    \
+        if (deque->size > 0)                                                                                        \
+        {                                                                                                           \
+            memcpy(elements, deque->elements + deque->head, first_part * sizeof(TElement));                        \
+            memcpy(elements + first_part, deque->elements, (deque->size - first_part) * sizeof(TElement));         \
+        }                                                                                                           \
+        free(deque->elements);                                                                                      \
+        deque->elements = elements;                                                                                 \
+        deque->mask = new_capacity - 1;                                                                             \
+        deque->head = 0;                                                                                            \
+        return true;                                                                                                \
+    }                                                                                                               \
+    TDeque *deque_create_##TDeque(size_t capacity)                                                                  \
+    {                                                                                                               \
+        TDeque *deque = malloc(sizeof(TDeque));                                                                     \
+        if (deque == NULL)                                                                                          \
+        {                                                                                                           \
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for deque\n", __FILE__, __func__, __LINE__);       \
+            return NULL;                                                                                            \
+        }                                                                                                           \
+        deque->elements = NULL;                                                                                     \
+        deque->mask = 0;                                                                                            \
+        deque->head = 0;                                                                                            \
+        deque->size = 0;                                                                                            \
+        if (!deque_reserve_##TDeque(deque, capacity > 0 ? capacity : 16))                                           \
+        {                                                                                                           \
+            free(deque);                                                                                            \
+            return NULL;                                                                                            \
+        }                                                                                                           \
+        return deque;                                                                                               \
+    }                                                                                                               \
+    void deque_destroy_##TDeque(TDeque *deque)                                                                      \
+    {                                                                                                               \
+        free(deque->elements);                                                                                      \
+        free(deque);                                                                                                \
+    }                                                                                                               \
+    bool deque_push_back_##TDeque(TDeque *deque, TElement element)                                                  \
+    {                                                                                                               \
+        if (deque->size > deque->mask && !deque_reserve_##TDeque(deque, (deque->mask + 1) * 2))                     \
+        {                                                                                                           \
+            return false;                                                                                           \
+        }                                                                                                           \
+        deque->elements[(deque->head + deque->size++) & deque->mask] = element;                                     \
+        return true;                                                                                                \
+    }                                                                                                               \
+    bool deque_push_front_##TDeque(TDeque *deque, TElement element)                                                 \
+    {                                                                                                               \
+        if (deque->size > deque->mask && !deque_reserve_##TDeque(deque, (deque->mask + 1) * 2))                     \
+        {                                                                                                           \
+            return false;                                                                                           \
+        }                                                                                                           \
+        deque->head = (deque->head - 1) & deque->mask;                                                              \
+        deque->elements[deque->head] = element;                                                                     \
+        deque->size++;                                                                                              \
+        return true;                                                                                                \
+    }                                                                                                               \
+    bool deque_push_back_n_##TDeque(TDeque *deque, TElement const *elements, size_t count)                          \
+    {                                                                                                               \
+        if (!deque_reserve_##TDeque(deque, deque->size + count))                                                    \
+        {                                                                                                           \
+            return false;                                                                                           \
+        }                                                                                                           \
+        /* At most two copies: up to the end of the buffer, then from the start. */                                 \
+        size_t tail = (deque->head + deque->size) & deque->mask;                                                    \
+        size_t first_part = deque->mask + 1 - tail < count ? deque->mask + 1 - tail : count;                        \
+        memcpy(deque->elements + tail, elements, first_part * sizeof(TElement));                                    \
+        memcpy(deque->elements, elements + first_part, (count - first_part) * sizeof(TElement));                  \
+        deque->size += count;                                                                                       \
+        return true;                                                                                                \
+    }                                                                                                               \
+    bool deque_pop_back_##TDeque(TDeque *deque, TElement *out_element)                                              \
+    {                                                                                                               \
+        if (deque->size == 0)                                                                                       \
+        {                                                                                                           \
+            return false;                                                                                           \
+        }                                                                                                           \
+        deque->size--;                                                                                              \
+        if (out_element != NULL)                                                                                    \
+        {                                                                                                           \
+            *out_element = deque->elements[(deque->head + deque->size) & deque->mask];                              \
+        }                                                                                                           \
+        return true;                                                                                                \
+    }                                                                                                               \
+    bool deque_pop_front_##TDeque(TDeque *deque, TElement *out_element)                                             \
+    {                                                                                                               \
+        if (deque->size == 0)                                                                                       \
+        {                                                                                                           \
+            return false;                                                                                           \
+        }                                                                                                           \
+        if (out_element != NULL)                                                                                    \
+        {                                                                                                           \
+            *out_element = deque->elements[deque->head];                                                            \
+        }                                                                                                           \
+        deque->head = (deque->head + 1) & deque->mask;                                                              \
+        deque->size--;                                                                                              \
+        return true;                                                                                                \
+    }                                                                                                               \
+    size_t deque_pop_front_n_##TDeque(TDeque *deque, TElement *out_elements, size_t count)                          \
+    {                                                                                                               \
+        if (count > deque->size)                                                                                    \
+        {                                                                                                           \
+            count = deque->size;                                                                                    \
+        }                                                                                                           \
+        size_t first_part = deque->mask + 1 - deque->head < count ? deque->mask + 1 - deque->head : count;          \
+        memcpy(out_elements, deque->elements + deque->head, first_part * sizeof(TElement));                         \
+        memcpy(out_elements + first_part, deque->elements, (count - first_part) * sizeof(TElement));               \
+        deque->head = (deque->head + count) & deque->mask;                                                          \
+        deque->size -= count;                                                                                       \
+        return count;                                                                                               \
+    }                                                                                                               \
+    TElement *deque_get_##TDeque(TDeque *deque, size_t pos)                                                         \
+    {                                                                                                               \
+        if (pos >= deque->size)                                                                                     \
+        {                                                                                                           \
+            fprintf(stderr, "%s:%s:%d: position %zu is out of bounds\n", __FILE__, __func__, __LINE__, pos);        \
+            return NULL;                                                                                            \
+        }                                                                                                           \
+        return &deque->elements[(deque->head + pos) & deque->mask];                                                 \
+    }                                                                                                               \
+    void deque_clear_##TDeque(TDeque *deque)                                                                        \
+    {                                                                                                               \
+        deque->head = 0;                                                                                            \
+        deque->size = 0;                                                                                            \
+    }
+
+/**
+ * The producer owns tail and the consumer owns head. Each side keeps a cached copy of the other side's index and only
+ * reloads it (with acquire ordering) when the cached copy says the queue is full or empty. The indices are free running
+ * and only masked when indexing, so head == tail means empty and tail - head == capacity means full.
+ */
+#define SPSC_QUEUE_OF_TYPE(T)                               \
+    struct                                                  \
+    {                                                       \
+        T *elements;                                        \
+        size_t mask;                                        \
+        size_t head __attribute__((aligned(64)));           \
+        size_t cached_tail;                                 \
+        size_t tail __attribute__((aligned(64)));           \
+        size_t cached_head;                                 \
+    }
+
+#define CREATE_SPSC_QUEUE_FOR(TQueue, TElement)                                                     \
+    TQueue *spsc_queue_create_##TQueue(size_t capacity);                                            \
+    void spsc_queue_destroy_##TQueue(TQueue *queue);                                                \
+    bool spsc_queue_try_push_##TQueue(TQueue *queue, TElement element);                             \
+    size_t spsc_queue_try_push_n_##TQueue(TQueue *queue, TElement const *elements, size_t count);   \
+    bool spsc_queue_try_pop_##TQueue(TQueue *queue, TElement *out_element);                         \
+    size_t spsc_queue_try_pop_n_##TQueue(TQueue *queue, TElement *out_elements, size_t count)
+
+#define CREATE_SPSC_QUEUE_IMPL_FOR(TQueue, TElement)                                                                \
+    TQueue *spsc_queue_create_##TQueue(size_t capacity)                                                             \
+    {                                                                                                               \
+        TQueue *queue = NULL;                                                                                       \
+        if (posix_memalign((void **)&queue, 64, sizeof(TQueue)) != 0)                                               \
+        {                                                                                                           \
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for queue\n", __FILE__, __func__, __LINE__);       \
+            return NULL;                                                                                            \
+        }                                                                                                           \
+        size_t actual_capacity = deque_round_up_to_power_of_two(capacity > 0 ? capacity : 16);                      \
+        queue->elements = malloc(actual_capacity * sizeof(TElement));                                               \
+        if (queue->elements == NULL)                                                                                \
+        {                                                                                                           \
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for queue elements\n", __FILE__, __func__, __LINE__); \
+            free(queue);                                                                                            \
+            return NULL;                                                                                            \
+        }                                                                                                           \
+        queue->mask = actual_capacity - 1;                                                                          \
+        queue->head = 0;                                                                                            \
+        queue->cached_tail = 0;                                                                                     \
+        queue->tail = 0;                                                                                            \
+        queue->cached_head = 0;                                                                                     \
+        return queue;                                                                                               \
+    }                                                                                                               \
+    void spsc_queue_destroy_##TQueue(TQueue *queue)                                                                 \
+    {                                                                                                               \
+        free(queue->elements);                                                                                      \
+        free(queue);                                                                                                \
+    }                                                                                                               \
+    size_t spsc_queue_try_push_n_##TQueue(TQueue *queue, TElement const *elements, size_t count)                    \
+    {                                                                                                               \
+        size_t tail = queue->tail;                                                                                  \
+        size_t capacity = queue->mask + 1;                                                                          \
+        if (capacity - (tail - queue->cached_head) < count)                                                         \
+        {                                                                                                           \
+            queue->cached_head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);                                   \
+        }                                                                                                           \
+        size_t free_slots = capacity - (tail - queue->cached_head);                                                 \
+        if (count > free_slots)                                                                                     \
+        {                                                                                                           \
+            count = free_slots;                                                                                     \
+        }                                                                                                           \
+        for (size_t i = 0; i < count; i++)                                                                          \
+        {                                                                                                           \
+            queue->elements[(tail + i) & queue->mask] = elements[i];                                                \
+        }                                                                                                           \
+        __atomic_store_n(&queue->tail, tail + count, __ATOMIC_RELEASE);                                             \
+        return count;                                                                                               \
+    }                                                                                                               \
+    bool spsc_queue_try_push_##TQueue(TQueue *queue, TElement element)                                              \
+    {                                                                                                               \
+        return spsc_queue_try_push_n_##TQueue(queue, &element, 1) == 1;                                             \
+    }                                                                                                               \
+    size_t spsc_queue_try_pop_n_##TQueue(TQueue *queue, TElement *out_elements, size_t count)                       \
+    {                                                                                                               \
+        size_t head = queue->head;                                                                                  \
+        if (queue->cached_tail - head < count)                                                                      \
+        {                                                                                                           \
+            queue->cached_tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);                                   \
+        }                                                                                                           \
+        size_t available = queue->cached_tail - head;                                                               \
+        if (count > available)                                                                                      \
+        {                                                                                                           \
+            count = available;                                                                                      \
+        }                                                                                                           \
+        for (size_t i = 0; i < count; i++)                                                                          \
+        {                                                                                                           \
+            out_elements[i] = queue->elements[(head + i) & queue->mask];                                            \
+        }                                                                                                           \
+        __atomic_store_n(&queue->head, head + count, __ATOMIC_RELEASE);                                             \
+        return count;                                                                                               \
+    }                                                                                                               \
+    bool spsc_queue_try_pop_##TQueue(TQueue *queue, TElement *out_element)                                          \
+    {                                                                                                               \
+        return spsc_queue_try_pop_n_##TQueue(queue, out_element, 1) == 1;                                           \
+    }
+
+typedef DEQUE_OF_TYPE(int) DequeInt;
+typedef DEQUE_OF_TYPE(size_t) DequeSize;
+typedef SPSC_QUEUE_OF_TYPE(void*) SpscQueuePointer;
+
+CREATE_DEQUE_FOR(DequeInt, int);
+CREATE_DEQUE_FOR(DequeSize, size_t);
+CREATE_SPSC_QUEUE_FOR(SpscQueuePointer, void*);
+
+#endif
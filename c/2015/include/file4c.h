@@ -8,4 +8,14 @@ char *file_read_all_text(char* filename);
 
 char **file_read_all_lines(size_t *out_number_of_lines, char *filename);
 
+/**
+ * file_map_all_text: Map a file into memory read-only instead of copying it into a buffer. Pages are loaded as they
+ * are touched, so a single pass over the content runs at the speed of the page cache.
+ * @param out_length Receives the size of the file in bytes.
+ * @return The content, which is not null terminated and must be released with file_unmap, or NULL on failure.
+ */
+const char *file_map_all_text(char *filename, size_t *out_length);
+
+void file_unmap(const char *content, size_t length);
+
 #endif
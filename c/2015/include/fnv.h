@@ -1,6 +1,17 @@
+#ifndef FNV_H
+#define FNV_H
+
 #include <stdint.h>
+#include <stdlib.h>
 
 #define FNV_OFFSET_BASIS 14695981039346656037UL
 #define FNV_PRIME 1099511628211UL
 
-uint64_t *fnv1a(const char *bytes);
\ No newline at end of file
+uint64_t *fnv1a(const char *bytes);
+
+/**
+ * fnv1a_bytes: Hash length bytes with FNV-1a. Nothing is allocated and the bytes do not have to be null terminated.
+ */
+uint64_t fnv1a_bytes(const void *bytes, size_t length);
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef HEAP4C_H
+#define HEAP4C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * heap_order_t: Decides which end of the priority range is at the top of a heap.
+ */
+typedef enum heap_order_t {
+    HEAP_ORDER_MIN,
+    HEAP_ORDER_MAX
+} heap_order_t;
+
+typedef struct heap_entry_t {
+    size_t  id;
+    int64_t priority;
+} heap_entry_t;
+
+/**
+ * heap_t: A d-ary heap of (id, priority) entries. The same id may be pushed more than once.
+ */
+typedef struct heap_t heap_t;
+
+/**
+ * indexed_heap_t: A d-ary heap over the ids [0, number_of_ids) where every id is present at most once. The position of
+ * every id is tracked, so the priority of an id can be changed in O(d log n) without searching for it.
+ */
+typedef struct indexed_heap_t indexed_heap_t;
+
+/**
+ * heap_create: Create a heap.
+ * @param arity The number of children per node. Must be at least 2. 4 is a good default for push heavy workloads.
+ * @param capacity The initial capacity. The heap grows when necessary.
+ * @param order Whether the smallest or the largest priority is at the top.
+ * @return The heap, or NULL if the arguments are invalid or memory could not be allocated.
+ */
+heap_t *heap_create(size_t arity, size_t capacity, heap_order_t order);
+
+void heap_destroy(heap_t *heap);
+
+size_t heap_get_size(heap_t *heap);
+
+bool heap_push(heap_t *heap, size_t id, int64_t priority);
+
+/**
+ * heap_peek: Get the entry at the top of the heap without removing it.
+ * @return False if the heap is empty.
+ */
+bool heap_peek(heap_t *heap, heap_entry_t *out_entry);
+
+/**
+ * heap_pop: Remove the entry at the top of the heap.
+ * @param out_entry Receives the removed entry. May be NULL.
+ * @return False if the heap is empty.
+ */
+bool heap_pop(heap_t *heap, heap_entry_t *out_entry);
+
+/**
+ * indexed_heap_create: Create an indexed heap.
+ * @param arity The number of children per node. Must be at least 2.
+ * @param number_of_ids The number of ids the heap can hold. Ids are in the range [0, number_of_ids).
+ * @param order Whether the smallest or the largest priority is at the top.
+ * @return The heap, or NULL if the arguments are invalid or memory could not be allocated.
+ */
+indexed_heap_t *indexed_heap_create(size_t arity, size_t number_of_ids, heap_order_t order);
+
+void indexed_heap_destroy(indexed_heap_t *heap);
+
+size_t indexed_heap_get_size(indexed_heap_t *heap);
+
+bool indexed_heap_contains(indexed_heap_t *heap, size_t id);
+
+/**
+ * indexed_heap_get_priority: Get the priority of an id in the heap.
+ * @return The priority. The result is undefined if the id is not in the heap.
+ */
+int64_t indexed_heap_get_priority(indexed_heap_t *heap, size_t id);
+
+/**
+ * indexed_heap_push: Add an id to the heap.
+ * @return False if the id is out of range or already in the heap.
+ */
+bool indexed_heap_push(indexed_heap_t *heap, size_t id, int64_t priority);
+
+/**
+ * indexed_heap_update: Change the priority of an id in the heap, moving it up or down as necessary.
+ * @return False if the id is not in the heap.
+ */
+bool indexed_heap_update(indexed_heap_t *heap, size_t id, int64_t priority);
+
+/**
+ * indexed_heap_decrease_key: Lower the priority of an id in the heap.
+ * @return False if the id is not in the heap or the new priority is higher than the current priority.
+ */
+bool indexed_heap_decrease_key(indexed_heap_t *heap, size_t id, int64_t priority);
+
+/**
+ * indexed_heap_increase_key: Raise the priority of an id in the heap.
+ * @return False if the id is not in the heap or the new priority is lower than the current priority.
+ */
+bool indexed_heap_increase_key(indexed_heap_t *heap, size_t id, int64_t priority);
+
+bool indexed_heap_peek(indexed_heap_t *heap, heap_entry_t *out_entry);
+
+bool indexed_heap_pop(indexed_heap_t *heap, heap_entry_t *out_entry);
+
+bool indexed_heap_remove(indexed_heap_t *heap, size_t id);
+
+/**
+ * indexed_heap_top_ties: Get every id whose priority is equal to the priority at the top of the heap. Only the part of
+ * the heap holding the tied ids and their direct children is visited, so the cost is O(k * d) for k ties.
+ * @param out_ids Receives the tied ids in no particular order.
+ * @param max_ids The capacity of out_ids.
+ * @return The number of tied ids. If this exceeds max_ids only the first max_ids ids were written.
+ */
+size_t indexed_heap_top_ties(indexed_heap_t *heap, size_t *out_ids, size_t max_ids);
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef JSON_CURSOR_H
+#define JSON_CURSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "json/dom.h"
+#include "json/number.h"
+#include "string4c.h"
+
+/**
+ * json_cursor_t: An on-demand reader that moves through a document without building anything. It walks the structural
+ * index, so skipping a value that is not needed, however large, only touches its brackets and quotes. Values are
+ * decoded when they are asked for, and the cursor is a plain struct, so a copy of it is a bookmark that can be returned
+ * to later.
+ *
+ * A container is read by entering it and calling json_cursor_next until it returns false:
+ *
+ *  json_cursor_enter(&cursor);
+ *  while(json_cursor_next(&cursor, &key)) {
+ *      ... read or skip the value at the cursor ...
+ *  }
+ *
+ * Validation is lazy. Malformed input is only noticed in the parts that are read, and sets error, after which every
+ * call fails.
+ */
+typedef struct json_cursor_t {
+    const char      *data;
+    size_t          length;
+    uint32_t        *index;
+    size_t          index_length;
+    size_t          position;   // The index entry of the next value or punctuation to read.
+    bool            error;
+} json_cursor_t;
+
+/**
+ * json_cursor_init: Build the structural index of a document and point the cursor at its root.
+ * @param data The document. Does not have to be null terminated and must outlive the cursor.
+ * @return False if the document has an unterminated string or memory could not be allocated.
+ */
+bool json_cursor_init(json_cursor_t *cursor, const char *data, size_t length);
+
+void json_cursor_free(json_cursor_t *cursor);
+
+/**
+ * json_cursor_rewind: Move the cursor back to the root and clear any error.
+ */
+void json_cursor_rewind(json_cursor_t *cursor);
+
+/**
+ * json_cursor_peek: Get the type of the value at the cursor without moving.
+ * @return False if there is no value at the cursor.
+ */
+bool json_cursor_peek(const json_cursor_t *cursor, json_value_type_t *out_type);
+
+/**
+ * json_cursor_skip: Move past the value at the cursor, including everything inside it.
+ */
+bool json_cursor_skip(json_cursor_t *cursor);
+
+/**
+ * json_cursor_enter: Move into the array or object at the cursor.
+ */
+bool json_cursor_enter(json_cursor_t *cursor);
+
+/**
+ * json_cursor_next: Move to the next element of the innermost container that was entered. The previous element must have
+ * been read or skipped.
+ * @param out_key Receives the key when the container is an object, with escape sequences left as written, and an empty
+ * view for an element without one. May be NULL.
+ * @return True if the cursor is at an element. False once the container has ended, in which case the cursor has moved
+ * past it, or if the document is malformed.
+ */
+bool json_cursor_next(json_cursor_t *cursor, string_view_t *out_key);
+
+/**
+ * json_cursor_leave: Skip the remaining elements of the innermost container that was entered and move past its end.
+ */
+bool json_cursor_leave(json_cursor_t *cursor);
+
+/**
+ * json_cursor_get_number: Read the number at the cursor, whatever its size and form, and move past it.
+ */
+bool json_cursor_get_number(json_cursor_t *cursor, json_number_t *out_value);
+
+/**
+ * json_cursor_get_int64: Read the number at the cursor and move past it.
+ * @return False if the number is not an integer that fits in an int64_t.
+ */
+bool json_cursor_get_int64(json_cursor_t *cursor, int64_t *out_value);
+
+/**
+ * json_cursor_get_double: Read the number at the cursor as a double and move past it. Integers are converted.
+ */
+bool json_cursor_get_double(json_cursor_t *cursor, double *out_value);
+
+/**
+ * json_cursor_get_string: Read the string at the cursor and move past it.
+ * @param out_value Receives the bytes between the quotes, with escape sequences left as written.
+ */
+bool json_cursor_get_string(json_cursor_t *cursor, string_view_t *out_value);
+
+/**
+ * json_cursor_get_bool: Read the bool at the cursor and move past it.
+ */
+bool json_cursor_get_bool(json_cursor_t *cursor, bool *out_value);
+
+/**
+ * json_cursor_find: Move from the value at the cursor to the value a JSON Pointer (RFC 6901) refers to, such as
+ * "/items/3/name". Objects are searched member by member and arrays skipped element by element, so nothing outside the
+ * path is decoded. "~1" and "~0" in a reference stand for '/' and '~'. The empty pointer refers to the value at the
+ * cursor itself.
+ * @return False if the pointer does not refer to a value, in which case the cursor is left where it was.
+ */
+bool json_cursor_find(json_cursor_t *cursor, const char *pointer);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef JSON_DOM_H
+#define JSON_DOM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "arena4c.h"
+#include "json/number.h"
+
+typedef enum json_value_type_t {
+    JSON_VALUE_TYPE_NULL,
+    JSON_VALUE_TYPE_BOOL,
+    JSON_VALUE_TYPE_NUMBER,
+    JSON_VALUE_TYPE_STRING,
+    JSON_VALUE_TYPE_ARRAY,
+    JSON_VALUE_TYPE_OBJECT
+} json_value_type_t;
+
+typedef struct json_member_t json_member_t;
+
+/**
+ * json_value_t: A value of a document. Scalars are stored in the value itself rather than behind a pointer, with
+ * integers that fit in an int64_t kept apart from doubles. The
+ * elements of an array and the members of an object are stored next to each other, so a container is a pointer and a
+ * length. Strings are null terminated copies with escape sequences left as they are written.
+ */
+typedef struct json_value_t {
+    json_value_type_t   type;
+    union {
+        uint32_t            length;         // The number of bytes in a string, elements in an array or members in an object.
+        json_number_type_t  number_type;    // Whether a number is held in number or in real.
+    };
+    union {
+        bool                    boolean;
+        int64_t                 number;
+        double                  real;
+        const char              *string;
+        struct json_value_t     *elements;
+        json_member_t           *members;
+    } as;
+} json_value_t;
+
+struct json_member_t {
+    const char      *key;
+    uint32_t        key_length;
+    json_value_t    value;
+};
+
+/**
+ * json_document_t: A parsed document. Every value, string and child range lives in one arena owned by the document, so
+ * parsing costs a few bump allocations and destroying the document frees everything at once.
+ */
+typedef struct json_document_t json_document_t;
+
+/**
+ * json_document_parse: Parse a JSON string into a document. The string is not referenced after parsing.
+ * @return The document, which must be destroyed by the caller, or NULL if the string is malformed or memory could not
+ * be allocated.
+ */
+json_document_t *json_document_parse(const char *str);
+
+/**
+ * json_document_parse_parallel: Parse a document that is one large array, such as a list of records, on several
+ * threads. The structural index is built once and scanned for the commas between elements, which split the array into
+ * runs of about equal size. Every run is lexed and built on its own thread into its own arena, and the elements are then
+ * stitched into one array in their original order. The result is the same as from json_document_parse. Documents that
+ * are not an array, or too small to be worth splitting, are parsed on the calling thread.
+ * @param number_of_threads The most threads to use, including the calling thread.
+ */
+json_document_t *json_document_parse_parallel(const char *str, size_t number_of_threads);
+
+void json_document_destroy(json_document_t *document);
+
+const json_value_t *json_document_get_root(const json_document_t *document);
+
+/**
+ * json_document_get_arena: Get the arena the document lives in, for example to find out how much memory it takes.
+ */
+const arena_t *json_document_get_arena(const json_document_t *document);
+
+/**
+ * json_document_get_depth: Get the largest number of arrays and objects in the document that enclose one another.
+ */
+size_t json_document_get_depth(const json_document_t *document);
+
+/**
+ * json_value_get: Get the value of an object member. Objects with JSON_KEY_INDEX_THRESHOLD members or more are given a
+ * hash index over their keys while the document is parsed, so this is O(1) however large the object is.
+ * @return The value, or NULL if the value is not an object or has no member with the key.
+ */
+const json_value_t *json_value_get(const json_value_t *object, const char *key);
+
+typedef enum json_visit_t {
+    JSON_VISIT_CONTINUE,    // Visit the children of the value next, if it has any.
+    JSON_VISIT_SKIP,        // Leave the children of the value out.
+    JSON_VISIT_STOP         // End the walk.
+} json_visit_t;
+
+/**
+ * json_visitor_t: Called for every value a walk comes across.
+ * @param key The key of the value if it is a member of an object, and NULL otherwise.
+ * @param depth The number of arrays and objects enclosing the value.
+ */
+typedef json_visit_t (*json_visitor_t)(const json_value_t *value, const char *key, size_t depth, void *context);
+
+/**
+ * json_value_visit: Walk a value and everything nested in it in document order, parents before their children. The
+ * containers being walked are kept on a heap allocated stack rather than the C stack, so any document that could be
+ * parsed can be walked.
+ * @param out_max_depth Receives the largest number of containers that were open at once. May be NULL.
+ * @return True if the walk finished, false if the visitor stopped it or memory could not be allocated.
+ */
+bool json_value_visit(const json_value_t *root, json_visitor_t visitor, void *context, size_t *out_max_depth);
+
+#endif
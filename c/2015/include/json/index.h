@@ -0,0 +1,37 @@
+#ifndef JSON_INDEX_H
+#define JSON_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * The structural index of a JSON document: the offset of every byte a parser has to look at, in order. That is every
+ * brace, bracket, colon and comma outside of strings, every quote that opens or closes a string, and the first byte of
+ * every number and literal. A string therefore runs between two consecutive entries, and everything a parser would
+ * otherwise skip byte by byte, such as whitespace and the contents of strings, is left out.
+ *
+ * The index is built 64 bytes at a time. Each block is classified into quote, backslash, structural and whitespace
+ * bitmasks with simd_classify_block, escaped quotes are removed with carry propagation across backslash runs, and the
+ * inside of strings is found with a prefix XOR over the quote mask, carried over from one block to the next.
+ */
+
+/**
+ * json_index_build: Build the structural index of a document.
+ * @param data The document. Does not have to be null terminated.
+ * @param length The number of bytes in the document. Must be less than 4 GiB.
+ * @param out_length Receives the number of entries.
+ * @return The entries, which must be freed by the caller, or NULL if a string is unterminated, the document is too long
+ * or memory could not be allocated.
+ */
+uint32_t *json_index_build(const char *data, size_t length, size_t *out_length);
+
+/**
+ * json_is_space: Check for the whitespace JSON allows between tokens, which is space, \t, \n and \r. Unlike
+ * ctype_is_space it leaves out \v and \f, which the index treats as the start of a scalar.
+ */
+static inline bool json_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef JSON_KEY_INDEX_H
+#define JSON_KEY_INDEX_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * A hash index over the keys of an object, kept next to the members rather than replacing them, so iteration still
+ * follows insertion order. The index is an open addressing table of slots, each holding the position of a member plus
+ * one, with 0 marking an empty slot. Lookups start at the slot picked by the hash of the key and probe linearly until
+ * they find the key or an empty slot. The table is at least twice as large as the number of members, so probe sequences
+ * stay short. When a key occurs more than once, the first occurrence is found first.
+ *
+ * Objects smaller than JSON_KEY_INDEX_THRESHOLD are searched linearly, which is faster than hashing at that size.
+ */
+#define JSON_KEY_INDEX_THRESHOLD 16
+
+static inline size_t json_key_index_capacity(size_t number_of_keys) {
+    size_t capacity = 32;
+    while(capacity < 2 * number_of_keys) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+static inline void json_key_index_insert(uint32_t *slots, size_t capacity, uint64_t hash, uint32_t position) {
+    size_t slot = hash & (capacity - 1);
+    while(slots[slot] != 0) {
+        slot = (slot + 1) & (capacity - 1);
+    }
+    slots[slot] = position + 1;
+}
+
+#endif
@@ -2,7 +2,10 @@
 #define JSON_LEXER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include "json/number.h"
+#include "string4c.h"
 
 #define JSON_QUOTE '"'
 
@@ -22,47 +25,99 @@ typedef enum json_token_type_t {
 
 extern const char *json_token_type_strings[];
 
-typedef union json_token_value_t {
-    bool    boolean_value;
-    int     int_value;
-    char    string_value[1024];
-} json_token_value_t; 
-
+/**
+ * A token refers back to the text it was lexed from instead of carrying a copy of its value, which keeps it at 12 bytes.
+ * For strings the range covers the bytes between the quotes, and for every other token it covers the whole token.
+ * Values are decoded from the text on demand with the json_token_get_* functions.
+ */
 typedef struct json_token_t {
     json_token_type_t   type;
-    json_token_value_t  value;
+    uint32_t            offset;
+    uint32_t            length;
 } json_token_t;
 
 /**
- * Get the value between two quotes and advance the pointer past the ending quote. Allocates a new string on the heap containing a copy of the quoted string.
- * @param str Array of strings.
- * @return A copy of the quoted string is returned upon success, otherwise NULL is returned. It's the responsibility of the caller to free the memory allocated for the new string.
+ * Get the value between two quotes and advance the pointer past the ending quote. A quote preceded by a backslash does not end the string. Nothing is copied.
+ * @param output Receives the bytes between the quotes, with escape sequences left as they are written.
+ * @param str Pointer to the current position in the string.
+ * @return True if successful, false if the string does not start with a quote or has no ending quote.
  */
-char *json_lex_string(char **str);
+bool json_lex_string(string_view_t *output, const char **str);
 
 /**
- * Get a number by advancing the pointer past any minus sign and digit until a non-digit character is encountered.
+ * Get a number and advance the pointer past it. Integers that fit in an int64_t are kept as integers, and every other
+ * number, including those with a fraction or an exponent, as a double.
  * @param output Pointer to output.
- * @param str Array of strings.
- * @return True if successful, false if not.
+ * @param str Pointer to the current position in the string.
+ * @return True if successful, false if the string does not start with a JSON number.
  */
-bool json_lex_number(int *output, char **str);
+bool json_lex_number(json_number_t *output, const char **str);
 
 /**
  * Get the boolean value represented by the current string. Advances the pointer past the boolean value.
  * @param output Pointer to output.
- * @param str Array of strings.
+ * @param str Pointer to the current position in the string.
  * @return True if successful, false if not. Must not be confused with the actual boolean value represented by the current string.
  */
-bool json_lex_bool(bool *output, char **str);
+bool json_lex_bool(bool *output, const char **str);
 
 /**
- * Check whether the current string represents a null value. Advances the pointer psat the string representation.
- * @param str Array of strings.
+ * Check whether the current string represents a null value. Advances the pointer past the string representation.
+ * @param str Pointer to the current position in the string.
  * @return True or false depending on whether the current string is "null".
  */
-bool json_lex_null(char **str);
+bool json_lex_null(const char **str);
+
+/**
+ * Split a JSON string into tokens. The string is not copied, so it must outlive the tokens.
+ * @param str The null terminated JSON string.
+ * @param out_length Receives the number of tokens.
+ * @return The tokens, which must be freed by the caller, or NULL if the string holds an unexpected character or memory could not be allocated.
+ * The last token is followed by one whose type is 0.
+ */
+json_token_t *json_lex(const char *str, size_t *out_length);
+
+/**
+ * Split part of a JSON string into tokens, given the entries of its structural index, so that a string can be indexed
+ * once and lexed in pieces.
+ * @param index The entries to lex, which must start and end outside of a string. Offsets are relative to str, and so are
+ * the offsets of the tokens.
+ * @param end_offset Where the text covered by the entries ends, which is the offset of the next entry or the length of
+ * the string.
+ * @param out_length Receives the number of tokens.
+ * @return The tokens, which must be freed by the caller, or NULL if the text holds an unexpected character or memory
+ * could not be allocated. The last token is followed by one whose type is 0.
+ */
+json_token_t *json_lex_index(const char *str, const uint32_t *index, size_t index_length, size_t end_offset, size_t *out_length);
+
+/**
+ * Get the text a token was lexed from.
+ * @param str The string passed to json_lex.
+ */
+string_view_t json_token_get_view(const char *str, const json_token_t *token);
 
-json_token_t *json_lex(char *str, size_t *out_length);
+/**
+ * Decode the value of a number token as an int.
+ * @return True if successful, false if the token is not a number or not an integer that fits in an int.
+ */
+bool json_token_get_int(const char *str, const json_token_t *token, int *output);
+
+/**
+ * Decode the value of a number token, whatever its size and form.
+ * @return True if successful, false if the token is not a number.
+ */
+bool json_token_get_number(const char *str, const json_token_t *token, json_number_t *output);
+
+/**
+ * Decode the value of a bool token.
+ * @return True if successful, false if the token is not a bool.
+ */
+bool json_token_get_bool(const char *str, const json_token_t *token, bool *output);
+
+/**
+ * Copy the value of a string token into a new null terminated string.
+ * @return The copy, which must be freed by the caller, or NULL if the token is not a string or memory could not be allocated.
+ */
+char *json_token_get_string(const char *str, const json_token_t *token);
 
 #endif
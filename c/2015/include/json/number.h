@@ -0,0 +1,32 @@
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef enum json_number_type_t {
+    JSON_NUMBER_TYPE_INTEGER,   // An integer that fits in an int64_t.
+    JSON_NUMBER_TYPE_DOUBLE     // A number with a fraction or an exponent, or an integer too large for an int64_t.
+} json_number_type_t;
+
+typedef struct json_number_t {
+    json_number_type_t  type;
+    union {
+        int64_t integer;
+        double  real;
+    } as;
+} json_number_t;
+
+/**
+ * json_number_parse: Parse a number as JSON writes it, so without a '+' in front or leading zeros. Integers are parsed
+ * with the SWAR integer path and everything else with number_parse_f64, neither of which needs the number to be null
+ * terminated.
+ * @return The number of bytes consumed, or 0 if the view does not start with a JSON number.
+ */
+size_t json_number_parse(const char *data, size_t length, json_number_t *out_number);
+
+static inline double json_number_get_double(json_number_t number) {
+    return number.type == JSON_NUMBER_TYPE_INTEGER ? (double)number.as.integer : number.as.real;
+}
+
+#endif
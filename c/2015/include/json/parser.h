@@ -2,6 +2,7 @@
 #define JSON_PARSER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include "lexer.h"
 
@@ -14,6 +15,10 @@ typedef enum json_node_type_t {
     JSON_NODE_TYPE_STRING,
 } json_node_type_t;
 
+/**
+ * A node of a parsed tree. The value is a json_array_t, a json_object_t, a null terminated string, a json_number_t or a
+ * bool, depending on the type, and NULL for a JSON null.
+ */
 typedef struct json_node_t {
     json_node_type_t type;
     void* value;
@@ -34,41 +39,58 @@ typedef struct json_object_t {
     size_t capacity;
     size_t size;
     json_object_entry_t **entries;
+    uint32_t *index;            // Hash index over the keys, built by json_object_get once the object is large enough.
+    size_t index_capacity;
 } json_object_t;
 
 void json_node_destroy(json_node_t *node);
 
+/**
+ * Get the value of an object entry. Small objects are searched linearly. Larger ones get a hash index over their keys on
+ * the first lookup, which later lookups reuse, so keyed access stays O(1) however many entries there are.
+ * @return The value of the first entry with the key, or NULL if there is none.
+ */
 json_node_t *json_object_get(json_object_t *object, char *key);
 
 /**
- * Parse JSON tokens recursively. Determines whether to parse an object, array or primitive value and delegates to the appropriate parser method.
+ * Parse JSON tokens into a tree. Open arrays and objects are kept on a heap allocated stack rather than the C stack, so
+ * documents can be nested as deeply as memory allows.
+ * @param str The string the tokens were lexed from. Values are decoded from it as nodes are created.
  * @param tokens JSON token array.
- * @param current_token_index Position in array.
- * @return The resulting generic value object.
+ * @param current_token_index Position in array. Left after the last token of the value.
+ * @return The resulting generic value object, or NULL if the tokens are malformed.
  */
-json_node_t *json_parse(json_token_t *tokens, size_t *current_token_index, bool is_root);
+json_node_t *json_parse(const char *str, json_token_t *tokens, size_t *current_token_index, bool is_root);
 
 /**
  * Parser method for JSON arrays. Expects the current token to be the beginning of a JSON array.
+ * @param str The string the tokens were lexed from.
  * @param tokens JSON token array.
  * @param current_token_index Position in array.
  * @return The resulting generic array object.
  */
-json_array_t *json_parse_array(json_token_t *tokens, size_t *current_token_index);
+json_array_t *json_parse_array(const char *str, json_token_t *tokens, size_t *current_token_index);
 
 /**
  * Parser method for JSON objects. Expects the current token to be the beginning of a JSON object.
+ * @param str The string the tokens were lexed from.
  * @param tokens JSON token array.
  * @param current_token_index Position in array.
  * @return The resulting generic object.
  */
-json_object_t *json_parse_object(json_token_t *tokens, size_t *current_token_index);
+json_object_t *json_parse_object(const char *str, json_token_t *tokens, size_t *current_token_index);
 
 /**
  * Parse a JSON string into a generic value object.
  * @param result A pointer to a heap allocated generic value to hold the parsed result.
  * @param str The JSON string to parse.
  */
-json_node_t *json_parse_string(char *str);
+json_node_t *json_parse_string(const char *str);
+
+/**
+ * Parse a JSON string into a generic value object and report how deeply it is nested.
+ * @param out_max_depth Receives the largest number of arrays and objects enclosing one another. May be NULL.
+ */
+json_node_t *json_parse_string_with_depth(const char *str, size_t *out_max_depth);
 
 #endif
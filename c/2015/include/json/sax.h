@@ -0,0 +1,41 @@
+#ifndef JSON_SAX_H
+#define JSON_SAX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "string4c.h"
+
+/**
+ * json_sax_handler_t: Callbacks invoked by json_sax_parse as it walks a document front to back. Any callback may be
+ * NULL, in which case the event is skipped. A callback returns false to stop parsing early.
+ *
+ * Strings and keys are views into the input between the quotes. Escape sequences are not decoded, so a string that
+ * contains one is passed exactly as it is written. Integers that fit in an int64_t are passed to on_number, and every
+ * other number to on_double.
+ */
+typedef struct json_sax_handler_t {
+    bool (*on_object_start)(void *context);
+    bool (*on_object_end)(void *context);
+    bool (*on_array_start)(void *context);
+    bool (*on_array_end)(void *context);
+    bool (*on_key)(string_view_t key, void *context);
+    bool (*on_number)(int64_t value, void *context);
+    bool (*on_double)(double value, void *context);
+    bool (*on_string)(string_view_t value, void *context);
+    bool (*on_bool)(bool value, void *context);
+    bool (*on_null)(void *context);
+} json_sax_handler_t;
+
+/**
+ * json_sax_parse: Parse a document without building tokens or nodes. The input is scanned once and nothing is copied;
+ * the only memory used is one byte per level of nesting, so documents of any size can be streamed from a mapped file.
+ * @param data The document. Does not have to be null terminated.
+ * @param length The number of bytes in the document.
+ * @param context Passed to every callback.
+ * @return True if the whole document was parsed. False if it is malformed, memory could not be allocated, or a callback
+ * returned false.
+ */
+bool json_sax_parse(const char *data, size_t length, const json_sax_handler_t *handler, void *context);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef LOOK_AND_SAY_H
+#define LOOK_AND_SAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * look_and_say_t: A term of the look and say sequence, stored as runs instead of characters. Every run of equal digits
+ * is packed into one byte holding the length of the run in the high nibble and the digit in the low nibble, so
+ * "1113222113" is stored as the five bytes 0x31 0x13 0x32 0x21 0x13. The next term is computed from the runs directly
+ * and never materialised as a string.
+ */
+typedef struct look_and_say_t look_and_say_t;
+
+/**
+ * look_and_say_create: Create a sequence starting at a term.
+ * @param digits The digits of the starting term. Does not have to be null terminated.
+ * @param length The number of digits.
+ * @return The sequence, or NULL if the term is empty, holds anything other than digits, has a run of more than 15
+ * equal digits, or memory could not be allocated.
+ */
+look_and_say_t *look_and_say_create(const char *digits, size_t length);
+
+void look_and_say_destroy(look_and_say_t *sequence);
+
+/**
+ * look_and_say_set_number_of_threads: Split every step across this many threads once the term is long enough to be
+ * worth it. Defaults to 1.
+ */
+void look_and_say_set_number_of_threads(look_and_say_t *sequence, size_t number_of_threads);
+
+/**
+ * look_and_say_step: Replace the current term with the next term.
+ * @return False if memory could not be allocated, in which case the current term is kept.
+ */
+bool look_and_say_step(look_and_say_t *sequence);
+
+/**
+ * look_and_say_step_n: Advance the sequence by n terms.
+ * @return False if a step failed.
+ */
+bool look_and_say_step_n(look_and_say_t *sequence, size_t n);
+
+/**
+ * look_and_say_get_length: Get the number of digits in the current term.
+ */
+size_t look_and_say_get_length(const look_and_say_t *sequence);
+
+/**
+ * look_and_say_get_number_of_runs: Get the number of runs, and therefore bytes, the current term is stored in.
+ */
+size_t look_and_say_get_number_of_runs(const look_and_say_t *sequence);
+
+/**
+ * look_and_say_to_string: Expand the current term into a string.
+ * @return The string, which must be freed by the caller, or NULL if memory could not be allocated.
+ */
+char *look_and_say_to_string(const look_and_say_t *sequence);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef NUMBER4C_H
+#define NUMBER4C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Number parsing from a pointer and a length. Nothing has to be null terminated and every parse function reports how
+ * far it got, so a caller can keep scanning from where the number ended.
+ *
+ * The integer parse functions accept decimal digits only, with an optional leading '-' or '+' for the signed variants. Runs of
+ * eight or more digits are converted eight at a time with SWAR arithmetic on a single 64-bit word.
+ */
+
+/**
+ * number_parse_u64: Parse an unsigned decimal integer at the start of a view.
+ * @param out_value Receives the value. Left untouched on failure.
+ * @return The number of bytes consumed, or 0 if the view does not start with a digit or the value overflows.
+ */
+size_t number_parse_u64(const char *data, size_t length, uint64_t *out_value);
+
+/**
+ * number_parse_i64: Parse a signed decimal integer at the start of a view.
+ * @return The number of bytes consumed including the sign, or 0 if there are no digits or the value overflows.
+ */
+size_t number_parse_i64(const char *data, size_t length, int64_t *out_value);
+
+size_t number_parse_u32(const char *data, size_t length, uint32_t *out_value);
+
+size_t number_parse_i32(const char *data, size_t length, int32_t *out_value);
+
+/**
+ * number_parse_f64: Parse a decimal floating point number at the start of a view, such as "-12.5e-3". The fraction and
+ * the exponent are optional, but each needs at least one digit. The result is correctly rounded. Numbers whose
+ * significand fits in 64 bits are converted without strtod, exactly with one multiplication or division when both the
+ * significand and the power of ten are exact doubles, and otherwise with the Eisel-Lemire algorithm. Longer ones fall
+ * back to strtod.
+ * @return The number of bytes consumed, or 0 if the view does not start with a number.
+ */
+size_t number_parse_f64(const char *data, size_t length, double *out_value);
+
+/**
+ * number_extract_i64: Pull every integer out of a text in one pass, skipping whatever lies between them. A '-' directly
+ * in front of the digits makes a number negative, so "capacity -1, durability 2" yields -1 and 2, and "2x3x4" yields 2,
+ * 3 and 4. Numbers that overflow are skipped.
+ * @param out_values Receives the numbers in the order they appear.
+ * @param max_values The capacity of out_values.
+ * @return The number of values written. Scanning stops once out_values is full.
+ */
+size_t number_extract_i64(const char *data, size_t length, int64_t *out_values, size_t max_values);
+
+#endif
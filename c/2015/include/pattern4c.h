@@ -0,0 +1,64 @@
+#ifndef PATTERN4C_H
+#define PATTERN4C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "string4c.h"
+
+/**
+ * pattern_t: A line format compiled once and matched against many lines, as a replacement for sscanf and for splitting
+ * lines into tokens. A format is literal text with fields in braces:
+ *
+ *  {int}       A signed decimal integer.
+ *  {word}      One or more bytes up to the next whitespace, or up to the first byte of the literal text that follows.
+ *  {a|b|c}     One of the listed alternatives, tried in order. The value is the index of the alternative that matched.
+ *
+ * "{{" and "}}" stand for literal braces. Literal text must match exactly, including spaces, and a line only matches if
+ * the format consumes all of it. For example "{word} would {gain|lose} {int} happiness units by sitting next to {word}."
+ * has four fields. Matching never allocates and never backtracks.
+ */
+typedef struct pattern_t pattern_t;
+
+/**
+ * pattern_value_t: The value of one field. Which member is set depends on the kind of field.
+ */
+typedef union pattern_value_t {
+    int64_t         integer;    // {int}
+    string_view_t   word;       // {word}, pointing into the matched line.
+    size_t          choice;     // {a|b|c}
+} pattern_value_t;
+
+/**
+ * pattern_compile: Compile a format.
+ * @return The pattern, which must be destroyed by the caller, or NULL if the format is invalid or memory could not be
+ * allocated.
+ */
+pattern_t *pattern_compile(const char *format);
+
+void pattern_destroy(pattern_t *pattern);
+
+/**
+ * pattern_get_number_of_fields: Get the number of values every match produces.
+ */
+size_t pattern_get_number_of_fields(const pattern_t *pattern);
+
+/**
+ * pattern_match: Match a whole line.
+ * @param out_values Receives one value per field, in the order the fields appear in the format. Its contents are
+ * unspecified if the line does not match.
+ * @return True if the line matches.
+ */
+bool pattern_match(const pattern_t *pattern, string_view_t line, pattern_value_t *out_values);
+
+/**
+ * pattern_match_lines: Match every line of a text, such as a mapped file. Lines end at '\n', a '\r' before it is
+ * ignored, and empty lines are skipped.
+ * @param out_values Receives the values of line i at out_values[i * pattern_get_number_of_fields(pattern)].
+ * @param max_lines The number of lines out_values has room for.
+ * @return The number of lines matched. Matching stops at the first line that does not match, or once out_values is
+ * full.
+ */
+size_t pattern_match_lines(const pattern_t *pattern, const char *text, size_t length, pattern_value_t *out_values, size_t max_lines);
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef SIMD4C_H
+#define SIMD4C_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Byte scanning kernels. Every kernel takes an explicit length, so the input does not have to be null terminated and
+ * embedded null bytes are scanned like any other byte.
+ *
+ * The instruction set is picked once at runtime: AVX2 when the CPU supports it, otherwise SSE2, which every x86-64 CPU
+ * has. Other architectures use the scalar kernels. The byte set kernels need the byte shuffle from SSSE3, so on the SSE2
+ * path they are vectorised only when the CPU has SSSE3 as well.
+ */
+
+typedef enum simd_isa_t {
+    SIMD_ISA_SCALAR,
+    SIMD_ISA_SSE2,
+    SIMD_ISA_AVX2
+} simd_isa_t;
+
+/**
+ * simd_get_isa: Get the instruction set the kernels currently run on.
+ */
+simd_isa_t simd_get_isa(void);
+
+/**
+ * simd_set_isa: Force the kernels onto a specific instruction set. Meant for tests and benchmarks comparing the paths.
+ * @return False if the CPU does not support the instruction set, in which case nothing changes.
+ */
+bool simd_set_isa(simd_isa_t isa);
+
+/**
+ * simd_count_byte: Count the occurrences of a byte.
+ */
+size_t simd_count_byte(const char *data, size_t length, char c);
+
+/**
+ * simd_count_any: Count the bytes that are equal to any byte in a set.
+ * @param set The set of bytes. Duplicates are allowed and do not count twice.
+ * @param set_length The number of bytes in the set. Sets of up to 16 bytes are compared byte by byte; larger sets are
+ * turned into a simd_byte_set_t on AVX2 and scanned with a lookup table otherwise.
+ */
+size_t simd_count_any(const char *data, size_t length, const char *set, size_t set_length);
+
+/**
+ * simd_find_byte: Find the first occurrence of a byte.
+ * @return The index of the byte, or length if it does not occur.
+ */
+size_t simd_find_byte(const char *data, size_t length, char c);
+
+/**
+ * simd_find_any: Find the first byte that is equal to any byte in a set.
+ * @return The index of the byte, or length if no byte matches.
+ */
+size_t simd_find_any(const char *data, size_t length, const char *set, size_t set_length);
+
+/**
+ * simd_find_not_in_range: Find the first byte outside the inclusive range [low, high].
+ * @return The index of the byte, or length if every byte is in the range.
+ */
+size_t simd_find_not_in_range(const char *data, size_t length, unsigned char low, unsigned char high);
+
+/**
+ * simd_all_in_range: Check whether every byte is in the inclusive range [low, high]. True for empty input.
+ */
+bool simd_all_in_range(const char *data, size_t length, unsigned char low, unsigned char high);
+
+/**
+ * simd_byte_set_t: An arbitrary set of bytes laid out for a nibble lookup. Byte b is in the set when bit (b >> 4) % 8 of
+ * rows[b >> 7][b & 15] is set. Classifying a block then takes two shuffles indexed by the low nibbles, which fetch the
+ * rows, and one shuffle indexed by the high nibbles, which picks the bit, no matter how many bytes the set holds.
+ * Zero initialise it and add bytes with simd_byte_set_add.
+ */
+typedef struct simd_byte_set_t {
+    uint8_t rows[2][16];
+} simd_byte_set_t;
+
+void simd_byte_set_add(simd_byte_set_t *set, unsigned char c);
+
+bool simd_byte_set_contains(const simd_byte_set_t *set, unsigned char c);
+
+/**
+ * simd_count_in_set: Count the bytes that are in a byte set.
+ */
+size_t simd_count_in_set(const char *data, size_t length, const simd_byte_set_t *set);
+
+/**
+ * simd_find_in_set: Find the first byte that is in a byte set.
+ * @return The index of the byte, or length if no byte is in the set.
+ */
+size_t simd_find_in_set(const char *data, size_t length, const simd_byte_set_t *set);
+
+/**
+ * simd_find_not_in_set: Find the first byte that is not in a byte set, which is the length of the longest prefix made
+ * up of bytes from the set.
+ * @return The index of the byte, or length if every byte is in the set.
+ */
+size_t simd_find_not_in_set(const char *data, size_t length, const simd_byte_set_t *set);
+
+/**
+ * simd_classify_block: Classify a block of up to 64 bytes against several byte sets at once, loading the block only
+ * once. This is the building block for scanners that work on bitmasks, such as finding the structure of a document.
+ * @param length The number of bytes in the block. Anything past 64 is ignored.
+ * @param out_masks Receives one mask per set. Bit i of out_masks[s] is set when data[i] is in sets[s], and bits at or
+ * past length are clear.
+ */
+void simd_classify_block(const char *data, size_t length, const simd_byte_set_t *sets, size_t number_of_sets, uint64_t *out_masks);
+
+#endif
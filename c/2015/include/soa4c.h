@@ -0,0 +1,126 @@
+#ifndef SOA4C_H
+#define SOA4C_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Struct-of-arrays containers.
+ *
+ * A record is declared once as an X-macro listing its fields as X(type, name):
+ *
+ *     #define REINDEER_FIELDS(X)  \
+ *         X(int, velocity)        \
+ *         X(int, distance)
+ *
+ *     typedef SOA_RECORD_OF_TYPE(REINDEER_FIELDS) Reindeer;
+ *     typedef SOA_OF_TYPE(REINDEER_FIELDS) ReindeerHerd;
+ *     CREATE_SOA_IMPL_FOR(ReindeerHerd, Reindeer, REINDEER_FIELDS)
+ *
+ * The record type is the usual array-of-structs view of a single element. The container stores every field in its own
+ * contiguous column, so herd->distance is an int* covering all elements and loops touching a single field only pull
+ * that field through the cache.
+ */
+
+#define SOA_DECLARE_FIELD(T, name)  T name;
+#define SOA_DECLARE_COLUMN(T, name) T *name;
+
+#define SOA_RECORD_OF_TYPE(TFields) \
+    struct                          \
+    {                               \
+        TFields(SOA_DECLARE_FIELD)  \
+    }
+
+#define SOA_OF_TYPE(TFields)        \
+    struct                          \
+    {                               \
+        size_t size;                \
+        size_t allocated;           \
+        TFields(SOA_DECLARE_COLUMN) \
+    }
+
+#define SOA_NULL_COLUMN(T, name)        soa->name = NULL;
+#define SOA_FREE_COLUMN(T, name)        free(soa->name);
+#define SOA_STORE_FIELD(T, name)        soa->name[index] = record.name;
+#define SOA_LOAD_FIELD(T, name)         record.name = soa->name[index];
+#define SOA_RESIZE_COLUMN(T, name)                                                                                  \
+    {                                                                                                               \
+        T *column = realloc(soa->name, capacity * sizeof(T));                                                       \
+        if (column == NULL)                                                                                         \
+        {                                                                                                           \
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for column %s\n", __FILE__, __func__, __LINE__, #name); \
+            return false;                                                                                           \
+        }                                                                                                           \
+        soa->name = column;                                                                                         \
+    }
+
+#define CREATE_SOA_FOR(TSoa, TRecord)                               \
+    TSoa *soa_create_##TSoa(size_t capacity);                       \
+    void soa_destroy_##TSoa(TSoa *soa);                             \
+    bool soa_resize_##TSoa(TSoa *soa, size_t capacity);             \
+    bool soa_push_##TSoa(TSoa *soa, TRecord record);                \
+    TRecord soa_get_##TSoa(TSoa *soa, size_t index);                \
+    void soa_set_##TSoa(TSoa *soa, size_t index, TRecord record)
+
+#define CREATE_SOA_IMPL_FOR(TSoa, TRecord, TFields)                                                 \
+    bool soa_resize_##TSoa(TSoa *soa, size_t capacity)                                              \
+    {                                                                                               \
+        if (capacity < soa->size)                                                                   \
+        {                                                                                           \
+            fprintf(stderr, "%s:%s:%d: capacity %zu is smaller than the size %zu\n", __FILE__, __func__, __LINE__, capacity, soa->size); \
+            return false;                                                                           \
+        }                                                                                           \
+        if (capacity == 0)                                                                          \
+        {                                                                                           \
+            capacity = 1;                                                                           \
+        }                                                                                           \
+        TFields(SOA_RESIZE_COLUMN)                                                                  \
+        soa->allocated = capacity;                                                                  \
+        return true;                                                                                \
+    }                                                                                               \
+    void soa_destroy_##TSoa(TSoa *soa)                                                              \
+    {                                                                                               \
+        TFields(SOA_FREE_COLUMN)                                                                    \
+        free(soa);                                                                                  \
+    }                                                                                               \
+    TSoa *soa_create_##TSoa(size_t capacity)                                                        \
+    {                                                                                               \
+        TSoa *soa = malloc(sizeof(TSoa));                                                           \
+        if (soa == NULL)                                                                            \
+        {                                                                                           \
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for container\n", __FILE__, __func__, __LINE__); \
+            return NULL;                                                                            \
+        }                                                                                           \
+        soa->size = 0;                                                                              \
+        soa->allocated = 0;                                                                         \
+        TFields(SOA_NULL_COLUMN)                                                                    \
+        if (!soa_resize_##TSoa(soa, capacity))                                                      \
+        {                                                                                           \
+            soa_destroy_##TSoa(soa);                                                                \
+            return NULL;                                                                            \
+        }                                                                                           \
+        return soa;                                                                                 \
+    }                                                                                               \
+    bool soa_push_##TSoa(TSoa *soa, TRecord record)                                                 \
+    {                                                                                               \
+        if (soa->size >= soa->allocated && !soa_resize_##TSoa(soa, soa->allocated * 2))             \
+        {                                                                                           \
+            return false;                                                                           \
+        }                                                                                           \
+        size_t index = soa->size++;                                                                 \
+        TFields(SOA_STORE_FIELD)                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+    TRecord soa_get_##TSoa(TSoa *soa, size_t index)                                                 \
+    {                                                                                               \
+        TRecord record;                                                                             \
+        TFields(SOA_LOAD_FIELD)                                                                     \
+        return record;                                                                              \
+    }                                                                                               \
+    void soa_set_##TSoa(TSoa *soa, size_t index, TRecord record)                                    \
+    {                                                                                               \
+        TFields(SOA_STORE_FIELD)                                                                    \
+    }
+
+#endif
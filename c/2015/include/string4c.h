@@ -11,6 +11,61 @@ typedef struct string_buffer_t {
     char*   content;
 } string_buffer_t;
 
+/**
+ * string_view_t: A non-owning view of length bytes starting at data. The bytes are not required to be null terminated,
+ * and the view is only valid for as long as the buffer it points into.
+ */
+typedef struct string_view_t {
+    const char  *data;
+    size_t      length;
+} string_view_t;
+
+/**
+ * string_tokenizer_t: Iterates over the tokens of a view without copying them. Like strtok_r, every character in
+ * delimiters separates tokens and empty tokens are skipped, but the input is left untouched.
+ */
+typedef struct string_tokenizer_t {
+    string_view_t   remaining;
+    const char      *delimiters;
+} string_tokenizer_t;
+
+#define STRING_VIEW_NPOS SIZE_MAX
+
+// The longest string a string_owned_t keeps inline, leaving room for the null terminator.
+#define STRING_OWNED_INLINE_CAPACITY 23
+
+/**
+ * string_owned_t: An owned, immutable, null terminated string that keeps up to STRING_OWNED_INLINE_CAPACITY bytes
+ * inside the struct and only allocates for longer strings. Names, keys like "12,-3" and most other strings the
+ * solutions hold fit inline, so storing them costs no allocation. The struct is meant to be embedded by value.
+ */
+typedef struct string_owned_t {
+    size_t  length;
+    union {
+        char    *heap;                                      // When length > STRING_OWNED_INLINE_CAPACITY.
+        char    inline_data[STRING_OWNED_INLINE_CAPACITY + 1];
+    } data;
+} string_owned_t;
+
+/**
+ * string_rope_t: An editable string for long sequences of replacements. The text is stored as a piece table: an
+ * append-only buffer holding the original text and every inserted string, plus a balanced tree of pieces that each
+ * refer to a range of that buffer. Replacing part of the text splits and joins pieces in O(log n) instead of moving the
+ * tail of the string.
+ */
+typedef struct string_rope_t string_rope_t;
+
+/**
+ * string_matcher_t: An Aho-Corasick automaton over a fixed set of patterns. Every state has a full 256 entry row of
+ * transitions, so scanning a text is one table lookup per byte no matter how many patterns there are.
+ */
+typedef struct string_matcher_t string_matcher_t;
+
+typedef struct string_match_t {
+    size_t  pattern_id; // The index of the pattern in the array the matcher was created from.
+    size_t  position;   // Where the match starts in the text.
+} string_match_t;
+
 /**
  * string_compare_asc: Comparator function for use with qsort.
  * param str1 The first string.
@@ -31,14 +86,58 @@ char *string_unescape(const char *str);
 
 char *string_escape(const char *str);
 
+/**
+ * string_unescaped_length: Get the length of the string string_unescape would produce, without producing it. The
+ * stretches between backslashes are skipped with a vectorised search, so only the escape sequences are looked at.
+ * @param str The escaped string. Does not have to be null terminated.
+ * @param length The length of the escaped string.
+ */
+size_t string_unescaped_length(const char *str, size_t length);
+
+/**
+ * string_escaped_length: Get the length of the string string_escape would produce, without producing it. That is the
+ * length plus the surrounding quotes plus one for every backslash and quote, which is a single vectorised count.
+ */
+size_t string_escaped_length(const char *str, size_t length);
+
 string_buffer_t *string_buffer_create(size_t total_size);
 
 void string_buffer_destroy(string_buffer_t *buffer);
 
+/**
+ * string_buffer_release: Destroy a buffer but keep its content.
+ * @return The null terminated content, which must be freed by the caller.
+ */
+char *string_buffer_release(string_buffer_t *buffer);
+
+/**
+ * string_buffer_realloc: Make room for additional_length more characters and the null terminator. The capacity at
+ * least doubles whenever it grows, so a sequence of appends is amortised O(1) per character.
+ */
 bool string_buffer_realloc(string_buffer_t *buffer, size_t additional_length);
 
+/**
+ * string_buffer_reserve_exact: Make room for additional_length more characters and the null terminator without
+ * rounding the capacity up. Use this when the final length is known up front.
+ */
+bool string_buffer_reserve_exact(string_buffer_t *buffer, size_t additional_length);
+
 bool string_buffer_append(string_buffer_t *buffer, const char *str);
 
+bool string_buffer_append_char(string_buffer_t *buffer, char c);
+
+/**
+ * string_buffer_append_bytes: Append length bytes. The bytes do not have to be null terminated.
+ */
+bool string_buffer_append_bytes(string_buffer_t *buffer, const char *bytes, size_t length);
+
+/**
+ * string_buffer_append_u64: Append the decimal representation of a number without going through printf.
+ */
+bool string_buffer_append_u64(string_buffer_t *buffer, uint64_t value);
+
+bool string_buffer_append_i64(string_buffer_t *buffer, int64_t value);
+
 char *string_substring(char *input, size_t inclusive_start, size_t exclusive_end);
 
 bool string_contains_non_overlapping_pair(const char *str);
@@ -57,9 +156,11 @@ bool string_has_any_needle(const char *str, char *needles, size_t number_of_need
 char *string_replace(char *str, const char *old_str, const char *new_str);
 
 /**
- * string_replace_all: Replace all occurrences of a string with another string.
- * @param str The original string.
- * @param old_str The string to replace.
+ * string_replace_all: Replace all non-overlapping occurrences of a string with another string, from left to right. The
+ * occurrences are found in a single pass and the result is written once, in place if it is not longer than the
+ * original. Text produced by a replacement is not searched again.
+ * @param str The original string. Must be heap allocated; it is freed if the result needs a new buffer.
+ * @param old_str The string to replace. Nothing is replaced if it is empty.
  * @param new_str The replacement string.
  * @return Returns the string with replacements.
  */
@@ -93,4 +194,208 @@ char *string_prepend_char(char **str, const char c);
  */
 char *string_slice(const char *str, size_t start, size_t end);
 
+string_view_t string_view_create(const char *data, size_t length);
+
+string_view_t string_view_from_cstr(const char *str);
+
+/**
+ * string_view_to_cstr: Copy the contents of a view into a new null terminated string.
+ * @return The string, which must be freed by the caller, or NULL if memory could not be allocated.
+ */
+char *string_view_to_cstr(string_view_t view);
+
+/**
+ * string_view_slice: Get a view of part of another view.
+ * @param start Where to slice from, inclusive. Clamped to the length of the view.
+ * @param end How far to slice, exclusive. Clamped to the length of the view.
+ * @return The slice. It is empty if start is not before end.
+ */
+string_view_t string_view_slice(string_view_t view, size_t start, size_t end);
+
+/**
+ * string_view_trim: Drop leading and trailing whitespace from a view. Unlike string_trim nothing is copied.
+ */
+string_view_t string_view_trim(string_view_t view);
+
+/**
+ * string_view_trim_char: Drop a single trailing occurrence of c from a view, such as the colon in "Butterscotch:".
+ */
+string_view_t string_view_trim_char(string_view_t view, char c);
+
+/**
+ * string_view_compare: Compare two views lexicographically by their bytes. A view sorts before any longer view it is a
+ * prefix of.
+ * @return A negative number, zero or a positive number, like strcmp.
+ */
+int string_view_compare(string_view_t a, string_view_t b);
+
+bool string_view_equals(string_view_t a, string_view_t b);
+
+bool string_view_equals_cstr(string_view_t view, const char *str);
+
+bool string_view_starts_with(string_view_t view, const char *prefix);
+
+/**
+ * string_view_find_char: Find the first occurrence of a character in a view.
+ * @return The index of the character, or STRING_VIEW_NPOS if it does not occur.
+ */
+size_t string_view_find_char(string_view_t view, char c);
+
+/**
+ * string_view_find: Find the first occurrence of needle in a view.
+ * @return The index where needle starts, or STRING_VIEW_NPOS if it does not occur. An empty needle is found at 0.
+ */
+size_t string_view_find(string_view_t view, string_view_t needle);
+
+/**
+ * string_view_parse_int: Parse a view holding a decimal integer with an optional leading sign.
+ * @param out_value Receives the value. Left untouched on failure.
+ * @return False if the view is empty, holds anything besides the sign and digits, or overflows an int64_t.
+ */
+bool string_view_parse_int(string_view_t view, int64_t *out_value);
+
+/**
+ * string_owned_init: Copy length bytes into a string.
+ * @return False if the string is too long to keep inline and memory could not be allocated, in which case the string is
+ * left empty.
+ */
+bool string_owned_init(string_owned_t *str, const char *data, size_t length);
+
+/**
+ * string_owned_free: Release the memory of a string that spilled to the heap. The string is left empty.
+ */
+void string_owned_free(string_owned_t *str);
+
+/**
+ * string_owned_get: Get the null terminated contents of a string. Valid until the string is freed or moved.
+ */
+const char *string_owned_get(const string_owned_t *str);
+
+string_view_t string_owned_view(const string_owned_t *str);
+
+bool string_owned_equals(const string_owned_t *str, string_view_t view);
+
+int string_owned_compare(const string_owned_t *a, const string_owned_t *b);
+
+/**
+ * string_owned_hash: Get the FNV-1a hash of the bytes of a string, the same as fnv1a_bytes over its contents.
+ */
+uint64_t string_owned_hash(const string_owned_t *str);
+
+/**
+ * string_tokenizer_create: Start tokenizing a view.
+ * @param input The view to tokenize. The underlying buffer must outlive the tokenizer.
+ * @param delimiters A null terminated set of delimiter characters. Must not be empty.
+ */
+string_tokenizer_t string_tokenizer_create(string_view_t input, const char *delimiters);
+
+/**
+ * string_tokenizer_next: Get the next token.
+ * @param out_token Receives a view of the token within the input.
+ * @return False when there are no more tokens.
+ */
+bool string_tokenizer_next(string_tokenizer_t *tokenizer, string_view_t *out_token);
+
+/**
+ * string_tokenizer_skip: Skip over the next n tokens.
+ * @return False if the input ran out of tokens before n were skipped.
+ */
+bool string_tokenizer_skip(string_tokenizer_t *tokenizer, size_t n);
+
+/**
+ * string_view_split: The allocation free counterpart of string_split. Tokenizes a view into a caller provided array.
+ * @param out_tokens Receives views of the tokens within the input.
+ * @param max_tokens The capacity of out_tokens.
+ * @return The number of tokens written. Tokens beyond max_tokens are not visited.
+ */
+size_t string_view_split(string_view_t input, const char *delimiters, string_view_t *out_tokens, size_t max_tokens);
+
+/**
+ * string_rope_create: Create a rope holding a copy of a string.
+ * @return The rope, or NULL if memory could not be allocated.
+ */
+string_rope_t *string_rope_create(const char *str);
+
+void string_rope_destroy(string_rope_t *rope);
+
+size_t string_rope_get_length(const string_rope_t *rope);
+
+/**
+ * string_rope_char_at: Get the character at an index in O(log n).
+ * @return The character, or '\0' if the index is out of range.
+ */
+char string_rope_char_at(const string_rope_t *rope, size_t index);
+
+/**
+ * string_rope_replace_at: Replace length characters starting at position with another string. Insertions and deletions
+ * are the special cases of an empty replaced range and an empty replacement.
+ * @param position Where the replaced range starts. Must not be past the end of the rope.
+ * @param length How many characters to replace. Clamped to the end of the rope.
+ * @param replacement The replacement string. Copied into the rope.
+ * @return False if the position is out of range or memory could not be allocated.
+ */
+bool string_rope_replace_at(string_rope_t *rope, size_t position, size_t length, const char *replacement);
+
+/**
+ * string_rope_substring: Copy part of the rope into a new string.
+ * @param start Where to copy from, inclusive.
+ * @param end How far to copy, exclusive. Clamped to the end of the rope.
+ * @return The string, which must be freed by the caller, or NULL if start is past end or memory could not be allocated.
+ */
+char *string_rope_substring(const string_rope_t *rope, size_t start, size_t end);
+
+/**
+ * string_rope_to_cstr: Copy the whole rope into a new string.
+ */
+char *string_rope_to_cstr(const string_rope_t *rope);
+
+/**
+ * string_rope_find: Find the first occurrence of needle at or after a position. Finding the starting piece is O(log n);
+ * the rest of the search streams over the pieces with Knuth-Morris-Pratt, so no character is looked at twice.
+ * @return The index where needle starts, or STRING_VIEW_NPOS if it does not occur.
+ */
+size_t string_rope_find(const string_rope_t *rope, const char *needle, size_t from);
+
+/**
+ * string_matcher_create: Build a matcher for a set of patterns.
+ * @param patterns The patterns. They are copied, so the array may be freed afterwards. Patterns must not be empty.
+ * @param number_of_patterns The number of patterns.
+ * @return The matcher, or NULL if a pattern is empty or memory could not be allocated.
+ */
+string_matcher_t *string_matcher_create(const char **patterns, size_t number_of_patterns);
+
+void string_matcher_destroy(string_matcher_t *matcher);
+
+/**
+ * string_matcher_find_all: Find every occurrence of every pattern in one pass over a text, including overlapping ones.
+ * Matches are reported in the order they end in the text; matches ending at the same position are reported longest
+ * pattern first.
+ * @param out_matches Receives the matches. May be NULL if max_matches is 0.
+ * @param max_matches The capacity of out_matches.
+ * @return The total number of matches. If this exceeds max_matches only the first max_matches were written.
+ */
+size_t string_matcher_find_all(const string_matcher_t *matcher, const char *text, size_t length, string_match_t *out_matches, size_t max_matches);
+
+/**
+ * string_matcher_find_first: Find the match that ends first in a text, stopping the scan there.
+ * @return False if no pattern occurs in the text.
+ */
+bool string_matcher_find_first(const string_matcher_t *matcher, const char *text, size_t length, string_match_t *out_match);
+
+/**
+ * string_replace_all_matches: Apply every substitution of a matcher at once. The text is scanned a single time; where
+ * matches overlap the leftmost wins, and among matches starting at the same position the longest wins.
+ * @param matcher The matcher holding the strings to replace.
+ * @param replacements The replacement for each pattern, indexed like the patterns the matcher was created from.
+ * @param str The original string. Left untouched.
+ * @return A new string, which must be freed by the caller, or NULL if memory could not be allocated.
+ */
+char *string_replace_all_matches(const string_matcher_t *matcher, const char **replacements, const char *str);
+
+/**
+ * string_replace_all_multiple: Like string_replace_all_matches, but builds the matcher from the strings to replace.
+ * Build the matcher once with string_matcher_create instead when applying the same substitutions to many strings.
+ */
+char *string_replace_all_multiple(const char *str, const char **old_strs, const char **new_strs, size_t number_of_pairs);
+
 #endif
@@ -0,0 +1,138 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena4c.h"
+
+// Enough for every scalar type and for 128-bit vectors, and what malloc guarantees on 64-bit platforms.
+#define ARENA_ALIGNMENT         16
+#define ARENA_MIN_CAPACITY      4096
+#define ARENA_ALIGN_UP(size)    (((size) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+typedef struct arena_block_t {
+    struct arena_block_t    *previous;
+    size_t                  capacity;
+    size_t                  used;
+    unsigned char           data[] __attribute__((aligned(ARENA_ALIGNMENT)));
+} arena_block_t;
+
+struct arena_t {
+    arena_block_t   *current;
+    size_t          used;       // Bytes handed out across every block.
+    size_t          capacity;   // Bytes held across every block.
+};
+
+static arena_block_t *arena_block_create(size_t capacity, arena_block_t *previous) {
+    arena_block_t *block = malloc(sizeof(arena_block_t) + capacity);
+    if(block == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate an arena block of %zu bytes\n", __FILE__, __func__, __LINE__, capacity);
+        return NULL;
+    }
+
+    block->previous = previous;
+    block->capacity = capacity;
+    block->used     = 0;
+    return block;
+}
+
+arena_t *arena_create(size_t capacity) {
+    arena_t *arena = malloc(sizeof(arena_t));
+    if(arena == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for arena\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    capacity        = ARENA_ALIGN_UP(capacity < ARENA_MIN_CAPACITY ? ARENA_MIN_CAPACITY : capacity);
+    arena->current  = arena_block_create(capacity, NULL);
+    if(arena->current == NULL) {
+        free(arena);
+        return NULL;
+    }
+
+    arena->used     = 0;
+    arena->capacity = capacity;
+    return arena;
+}
+
+void arena_destroy(arena_t *arena) {
+    if(arena == NULL) {
+        return;
+    }
+
+    arena_block_t *block = arena->current;
+    while(block != NULL) {
+        arena_block_t *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    free(arena);
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    size = ARENA_ALIGN_UP(size == 0 ? 1 : size);
+
+    arena_block_t *block = arena->current;
+    if(block->capacity - block->used < size) {
+        size_t capacity = block->capacity * 2;
+        if(capacity < size) {
+            capacity = size;
+        }
+
+        block = arena_block_create(capacity, arena->current);
+        if(block == NULL) {
+            return NULL;
+        }
+        arena->current  = block;
+        arena->capacity += capacity;
+    }
+
+    void *memory    = block->data + block->used;
+    block->used     += size;
+    arena->used     += size;
+    return memory;
+}
+
+void arena_reset(arena_t *arena) {
+    // Blocks only ever grow, so the newest block is the largest one.
+    arena_block_t *block = arena->current->previous;
+    while(block != NULL) {
+        arena_block_t *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+
+    arena->current->previous    = NULL;
+    arena->current->used        = 0;
+    arena->used                 = 0;
+    arena->capacity             = arena->current->capacity;
+}
+
+void arena_merge(arena_t *arena, arena_t *other) {
+    // The larger of the two newest blocks is the largest of all, so it is the one to keep allocating from. The other
+    // chain goes behind it.
+    arena_block_t *keep = arena->current;
+    arena_block_t *rest = other->current;
+    if(rest->capacity > keep->capacity) {
+        keep = other->current;
+        rest = arena->current;
+    }
+
+    arena_block_t *oldest = rest;
+    while(oldest->previous != NULL) {
+        oldest = oldest->previous;
+    }
+    oldest->previous    = keep->previous;
+    keep->previous      = rest;
+
+    arena->current  = keep;
+    arena->used     += other->used;
+    arena->capacity += other->capacity;
+    free(other);
+}
+
+size_t arena_get_used(const arena_t *arena) {
+    return arena->used;
+}
+
+size_t arena_get_capacity(const arena_t *arena) {
+    return arena->capacity;
+}
@@ -0,0 +1,47 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "ctype4c.h"
+
+#define CTYPE_IN_RANGE(c, low, high) ((c) >= (low) && (c) <= (high))
+
+#define CTYPE_CLASSES_OF(c) (uint8_t)( \
+    (CTYPE_IN_RANGE(c, '0', '9') ? CTYPE_DIGIT : 0) | \
+    (CTYPE_IN_RANGE(c, '0', '9') || CTYPE_IN_RANGE(c, 'a', 'f') || CTYPE_IN_RANGE(c, 'A', 'F') ? CTYPE_HEX_DIGIT : 0) | \
+    ((c) == ' ' || CTYPE_IN_RANGE(c, '\t', '\r') ? CTYPE_SPACE : 0) | \
+    (CTYPE_IN_RANGE(c, 'a', 'z') ? CTYPE_LOWER : 0) | \
+    (CTYPE_IN_RANGE(c, 'A', 'Z') ? CTYPE_UPPER : 0) | \
+    (((c) | 0x20) == 'a' || ((c) | 0x20) == 'e' || ((c) | 0x20) == 'i' || ((c) | 0x20) == 'o' || ((c) | 0x20) == 'u' ? CTYPE_VOWEL : 0) | \
+    (CTYPE_IN_RANGE(c, '0', '9') || (c) == '+' || (c) == '-' || (c) == '.' || (c) == 'e' || (c) == 'E' ? CTYPE_NUMBER : 0) | \
+    ((c) == '{' || (c) == '}' || (c) == '[' || (c) == ']' || (c) == ':' || (c) == ',' ? CTYPE_JSON_STRUCTURAL : 0))
+
+#define CTYPE_HEX_VALUE_OF(c) (int8_t)( \
+    CTYPE_IN_RANGE(c, '0', '9') ? (c) - '0' : \
+    CTYPE_IN_RANGE(c, 'a', 'f') ? (c) - 'a' + 10 : \
+    CTYPE_IN_RANGE(c, 'A', 'F') ? (c) - 'A' + 10 : -1)
+
+// Expands a macro for the sixteen bytes of a row starting at 16 * row.
+#define CTYPE_ROW(f, row) \
+    f((row) * 16 + 0), f((row) * 16 + 1), f((row) * 16 + 2), f((row) * 16 + 3), \
+    f((row) * 16 + 4), f((row) * 16 + 5), f((row) * 16 + 6), f((row) * 16 + 7), \
+    f((row) * 16 + 8), f((row) * 16 + 9), f((row) * 16 + 10), f((row) * 16 + 11), \
+    f((row) * 16 + 12), f((row) * 16 + 13), f((row) * 16 + 14), f((row) * 16 + 15)
+
+#define CTYPE_TABLE(f) { \
+    CTYPE_ROW(f, 0), CTYPE_ROW(f, 1), CTYPE_ROW(f, 2), CTYPE_ROW(f, 3), \
+    CTYPE_ROW(f, 4), CTYPE_ROW(f, 5), CTYPE_ROW(f, 6), CTYPE_ROW(f, 7), \
+    CTYPE_ROW(f, 8), CTYPE_ROW(f, 9), CTYPE_ROW(f, 10), CTYPE_ROW(f, 11), \
+    CTYPE_ROW(f, 12), CTYPE_ROW(f, 13), CTYPE_ROW(f, 14), CTYPE_ROW(f, 15) }
+
+const uint8_t ctype_classes[256] = CTYPE_TABLE(CTYPE_CLASSES_OF);
+
+const int8_t ctype_hex_values[256] = CTYPE_TABLE(CTYPE_HEX_VALUE_OF);
+
+void ctype_build_set(simd_byte_set_t *set, uint8_t classes) {
+    memset(set, 0, sizeof(simd_byte_set_t));
+    for(int c = 0; c < 256; c++) {
+        if(ctype_classes[c] & classes) {
+            simd_byte_set_add(set, (unsigned char)c);
+        }
+    }
+}
@@ -1,66 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "aoc.h"
 #include "file4c.h"
+#include "simd4c.h"
+#include "testing/assertions.h"
+
+// Part two is scanned in blocks of this many instructions.
+#define BLOCK_SIZE 64
 
-void solve_part_one(char *instructions, solution_t *solution)
+void solve_part_one(char *instructions, size_t length, solution_t *solution)
 {
-	int floor = 0;
-	char instruction = '0';
-	while((instruction = *instructions) != '\0')
-	{
-		switch(instruction)
-		{
-			case '(':
-			floor++;
-			break;
-			case ')':
-			floor--;
-			break;
-		}
-		instructions++;
-	}
+	int floor = (int)simd_count_byte(instructions, length, '(') - (int)simd_count_byte(instructions, length, ')');
 
 	solution_part_finalize_with_int(solution, 0, floor, "280");
 }
 
-void solve_part_two(char *instructions, solution_t *solution)
+/**
+ * find_basement: Get the 1-based position of the instruction that first takes Santa to floor -1, or 0 if none does.
+ */
+size_t find_basement(const char *instructions, size_t length)
 {
 	int floor = 0;
-	int basement_entry_position = 1;
-	char instruction;
-	while((instruction = *instructions) != '\0')
+	size_t position = 0;
+
+	// Santa cannot drop more floors within a block than there are ')' in it, so a block is only walked one instruction
+	// at a time when that many ')' could take him from the current floor into the basement.
+	while(position < length)
 	{
-		switch(instruction)
+		size_t block_length = length - position < BLOCK_SIZE ? length - position : BLOCK_SIZE;
+		int ups = (int)simd_count_byte(instructions + position, block_length, '(');
+		int downs = (int)simd_count_byte(instructions + position, block_length, ')');
+
+		if(floor - downs > -1)
 		{
-			case '(':
-			floor++;
-			break;
-			case ')':
-			floor--;
-			break;
+			floor += ups - downs;
+			position += block_length;
+			continue;
 		}
 
-		if(floor == -1)
+		// The block may dip that far without the floor ever reaching -1, in which case the scan goes on after it.
+		for(size_t i = 0; i < block_length; i++)
 		{
-			break;
+			switch(instructions[position + i])
+			{
+				case '(':
+				floor++;
+				break;
+				case ')':
+				floor--;
+				break;
+			}
+
+			if(floor == -1)
+			{
+				return position + i + 1;
+			}
 		}
+		position += block_length;
+	}
+
+	return 0;
+}
+
+void solve_part_two(char *instructions, size_t length, solution_t *solution)
+{
+	solution_part_finalize_with_int(solution, 1, (int)find_basement(instructions, length), "1797");
+}
 
-		basement_entry_position++;
-		instructions++;
+void test_find_basement(const char *unit, size_t repetitions, const char *tail, size_t expected_result)
+{
+	// assign
+	size_t unit_length = strlen(unit), tail_length = strlen(tail);
+	size_t length = unit_length * repetitions + tail_length;
+	char *instructions = malloc(length + 1);
+	for(size_t i = 0; i < repetitions; i++)
+	{
+		memcpy(instructions + i * unit_length, unit, unit_length);
 	}
+	memcpy(instructions + unit_length * repetitions, tail, tail_length + 1);
 
-	solution_part_finalize_with_int(solution, 1, basement_entry_position, "1797");
+	// act
+	size_t result = find_basement(instructions, length);
+
+	// assert
+	assert_primitive_equality(expected_result, result, "find_basement(\"%s\" * %zu + \"%s\") != %zu (%zu)\n", unit, repetitions, tail, expected_result, result);
+	printf("%s(\"%s\", %zu, \"%s\") passed\n", __func__, unit, repetitions, tail);
+	free(instructions);
 }
 
 int main(int argc, char* argv[]) {
     (void)argc;
 
+	// The blocks before the basement dip below the starting floor of the block without reaching -1.
+	test_find_basement("()", 40, ")", 81);
+	test_find_basement("(())", 100, "))", 401);
+	test_find_basement(")", 1, "", 1);
+	test_find_basement("(", 100, "", 0);
+
 	solution_t *solution = solution_create(2015, 1);
 	char *instructions = file_read_all_text(argv[1]);
-    char *temp = instructions;
+	size_t length = strlen(instructions);
 
-	solve_part_one(instructions, solution);
-	instructions = temp;
-	solve_part_two(instructions, solution);
+	solve_part_one(instructions, length, solution);
+	solve_part_two(instructions, length, solution);
 
     free(instructions);
 	return solution_finalize_and_destroy(solution);	
@@ -2,47 +2,28 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "aoc.h"
 #include "file4c.h"
+#include "look_and_say.h"
 #include "string4c.h"
 #include "testing/assertions.h"
 
-// Find the nth term in the look and say sequence.
-// The nth term is generated by reading the (n-1)th term.
-char *look_and_say(char* input) {
-    size_t length = strlen(input);
-    string_buffer_t *sb = string_buffer_create(length * 2);
-
-    for(size_t i = 0; i < length; i++) {
-        // We're currently looking at the first occurrence of a digit in the input string.
-        size_t occurrences = 1;
-        // Look ahead at the next digit to see if it's the same.
-        while (i < length - 1 && input[i] == input[i + 1]) {
-            // Move to the next digit.
-            i += 1;
-            occurrences += 1;
-        }
-        char temp[1024];
-        sprintf(temp, "%zu%c", occurrences, input[i]);
-        string_buffer_append(sb, temp);
-    }
-   
-    char *result = malloc(sb->length + 1);
-    strcpy(result, sb->content);
-    result[sb->length] = '\0';
-    string_buffer_destroy(sb);
-    return result;
-}
-
 void test_look_and_say(char* input, char* expected_result) {
-    // assign, act
-    char *result = look_and_say(input);
+    // assign
+    look_and_say_t *sequence = look_and_say_create(input, strlen(input));
+    assert_not_null(sequence, "look_and_say_create(\"%s\") returned NULL\n", input);
+
+    // act
+    look_and_say_step(sequence);
+    char *result = look_and_say_to_string(sequence);
 
     // assert
     assert_string_equality(expected_result, result, "look_and_say(\"%s\") != %s (%s)\n", input, expected_result, result);
     printf("%s(\"%s\", \"%s\") passed\n", __func__, input, expected_result);
     free(result);
+    look_and_say_destroy(sequence);
 }
 
 int main(int argc, char* argv[]) {
@@ -55,20 +36,25 @@ int main(int argc, char* argv[]) {
 
     solution_t *solution = solution_create(2015, 10);
     char *file_content = file_read_all_text(argv[1]);
+    string_view_t input = string_view_trim(string_view_from_cstr(file_content));
+
+    // The terms are kept as runs of digits, which take about half the memory of the digits themselves and are read
+    // aloud without ever building the 5 million character string.
+    look_and_say_t *sequence = look_and_say_create(input.data, input.length);
+    if(sequence == NULL) {
+        fprintf(stderr, "%s:%d: Failed to create the look and say sequence from %s\n", __func__, __LINE__, argv[1]);
+        exit(EXIT_FAILURE);
+    }
+    long number_of_processors = sysconf(_SC_NPROCESSORS_ONLN);
+    look_and_say_set_number_of_threads(sequence, number_of_processors > 0 ? (size_t)number_of_processors : 1);
 
-    for(int i = 0; i < 50; i++)
-    {
-        if(i == 40) {
-            solution_part_finalize_with_ui(solution, 0, strlen(file_content), "360154");
-        }
+    look_and_say_step_n(sequence, 40);
+    solution_part_finalize_with_ui(solution, 0, look_and_say_get_length(sequence), "360154");
 
-        char *next_sequence = look_and_say(file_content);
-        // Free the memory held by file_content and point file_content to new memory allocated for next_sequence.
-        free(file_content);
-        file_content = next_sequence;
-    }
-    solution_part_finalize_with_ui(solution, 1, strlen(file_content), "5103798");
+    look_and_say_step_n(sequence, 10);
+    solution_part_finalize_with_ui(solution, 1, look_and_say_get_length(sequence), "5103798");
 
+    look_and_say_destroy(sequence);
     free(file_content);
     return solution_finalize_and_destroy(solution);
 }
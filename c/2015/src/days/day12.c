@@ -1,76 +1,136 @@
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "aoc.h"
 #include "file4c.h"
-#include "json/parser.h"
+#include "json/cursor.h"
+#include "json/sax.h"
 #include "test4c.h"
 
-bool is_red(json_object_entry_t *entry) {
-    if(strcmp(entry->key, "red") == 0 || (entry->value->type == JSON_NODE_TYPE_STRING && strcmp((char*)entry->value->value, "red") == 0)) {
-        return true;
-    }
-    return false;
-}
+// An array or object whose numbers are being summed.
+typedef struct sum_frame_t {
+    int64_t sum;
+    bool    is_object;
+} sum_frame_t;
 
-int traverse(json_node_t *source, int *sum, bool (*skip)(json_object_entry_t *entry)) {
-    json_array_t *array;
-    json_object_t *object;
-    size_t size;
+/**
+ * sum_without_red: Sum every number in the value at the cursor, except those in objects with a "red" key or value. An
+ * object is left as soon as "red" turns up, so the rest of it is skipped without being read. Open containers are kept on
+ * a stack of their own, so nesting is limited by memory rather than the C stack.
+ * @return False if the document is malformed or memory could not be allocated.
+ */
+bool sum_without_red(json_cursor_t *cursor, int64_t *out_total) {
+    sum_frame_t *frames = NULL;
+    size_t depth        = 0;
+    size_t capacity     = 0;
+    int64_t total       = 0;
+    bool at_value       = true;
 
-    switch(source->type) {
-        case JSON_NODE_TYPE_ARRAY:
-            array = (json_array_t*)source->value;
-            size = array->size;
+    while(true) {
+        json_value_type_t type;
+        int64_t number = 0;
 
-            for(size_t i = 0; i < size; i++) {
-                json_node_t *element = array->nodes[i];
-                traverse(element, sum, skip);
+        if(at_value && json_cursor_peek(cursor, &type)) {
+            if(type == JSON_VALUE_TYPE_NUMBER && json_cursor_get_int64(cursor, &number)) {
+                *(depth > 0 ? &frames[depth - 1].sum : &total) += number;
             }
-        break;
-        case JSON_NODE_TYPE_OBJECT:
-            object = (json_object_t*)source->value;
-            size = object->size;
-
-            for(size_t i = 0; i < size; i++) {
-                json_object_entry_t *entry = object->entries[i];
-                if(skip != NULL && skip(entry)) {
-                    return 0;
+            else if(type == JSON_VALUE_TYPE_ARRAY || type == JSON_VALUE_TYPE_OBJECT) {
+                if(depth == capacity) {
+                    size_t new_capacity     = capacity == 0 ? 64 : capacity * 2;
+                    sum_frame_t *new_frames = realloc(frames, new_capacity * sizeof(sum_frame_t));
+                    if(new_frames == NULL) {
+                        fprintf(stderr, "%s:%d: Failed to allocate memory for the open containers\n", __func__, __LINE__);
+                        free(frames);
+                        return false;
+                    }
+                    frames      = new_frames;
+                    capacity    = new_capacity;
                 }
+                json_cursor_enter(cursor);
+                frames[depth++] = (sum_frame_t){ .sum = 0, .is_object = type == JSON_VALUE_TYPE_OBJECT };
             }
+            else {
+                json_cursor_skip(cursor);
+            }
+        }
+
+        if(depth == 0) {
+            break;
+        }
+
+        string_view_t key = string_view_create("", 0);
+        sum_frame_t *frame = &frames[depth - 1];
+        if(!json_cursor_next(cursor, &key)) {
+            depth--;
+            *(depth > 0 ? &frames[depth - 1].sum : &total) += frame->sum;
+            at_value = false;
+            continue;
+        }
 
-            for(size_t i = 0; i < size; i++) {
-                json_object_entry_t *entry = object->entries[i];
-                traverse(entry->value, sum, skip);
+        at_value = true;
+        if(frame->is_object) {
+            string_view_t value;
+            bool is_red = string_view_equals_cstr(key, "red");
+            if(!is_red && json_cursor_peek(cursor, &type) && type == JSON_VALUE_TYPE_STRING) {
+                json_cursor_get_string(cursor, &value);
+                is_red      = string_view_equals_cstr(value, "red");
+                at_value    = false;
             }
-        break;
-        case JSON_NODE_TYPE_NUMBER:
-            *sum += *(int*)source->value;
-        break;
-        default:
-        break;
+            if(is_red) {
+                json_cursor_leave(cursor);
+                depth--;
+                at_value = false;
+            }
+        }
     }
 
-    return *sum;
+    free(frames);
+    *out_total = total;
+    return !cursor->error;
+}
+
+static bool add_number(int64_t value, void *context) {
+    *(int64_t*)context += value;
+    return true;
 }
 
 int main(int argc, char* argv[]) {
     (void)argc;
 
     solution_t *solution = solution_create(2015, 12);
-    char *file_content = file_read_all_text(argv[1]);
-    json_node_t *node = json_parse_string(file_content);
+    size_t length = 0;
+    const char *file_content = file_map_all_text(argv[1], &length);
+    if(file_content == NULL) {
+        fprintf(stderr, "%s:%d: Failed to read %s\n", __func__, __LINE__, argv[1]);
+        return EXIT_FAILURE;
+    }
 
-    int sum = 0;
-    sum = traverse(node, &sum, NULL);
-    solution_part_finalize_with_int(solution, 0, sum, "191164");
+    // Summing every number needs no tree, so stream the events instead.
+    int64_t total = 0;
+    json_sax_handler_t handler = { .on_number = add_number };
+    if(!json_sax_parse(file_content, length, &handler, &total)) {
+        fprintf(stderr, "%s:%d: Failed to parse the document in %s\n", __func__, __LINE__, argv[1]);
+        file_unmap(file_content, length);
+        return EXIT_FAILURE;
+    }
+    solution_part_finalize_with_int(solution, 0, (int)total, "191164");
 
-    sum = 0;
-    sum = traverse(node, &sum, &is_red);
-    solution_part_finalize_with_int(solution, 1, sum, "87842");
+    // Red objects can only be ruled out once their members have been seen, which the cursor does without building them.
+    json_cursor_t cursor;
+    int64_t total_without_red = 0;
+    if(!json_cursor_init(&cursor, file_content, length) || !sum_without_red(&cursor, &total_without_red)) {
+        fprintf(stderr, "%s:%d: Failed to read the document in %s\n", __func__, __LINE__, argv[1]);
+        json_cursor_free(&cursor);
+        file_unmap(file_content, length);
+        return EXIT_FAILURE;
+    }
+    solution_part_finalize_with_int(solution, 1, (int)total_without_red, "87842");
 
-    free(file_content);
-    json_node_destroy(node);
+    json_cursor_free(&cursor);
+    file_unmap(file_content, length);
     return solution_finalize_and_destroy(solution);
 }
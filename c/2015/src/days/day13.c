@@ -7,21 +7,26 @@
 #include "aoc.h"
 #include "file4c.h"
 #include "math4c.h"
-#include "string4c.h"
+#include "pattern4c.h"
 
 void calculate_happiness(int *result, char **lines, size_t number_of_lines, bool include_yourself) {
     int map[26][26]; // There are 26 letters in the alphabet.
     int id_map[26]              = {0}; // Map for converting iteration variables to actual map ids;
     char current_main_id        = ' ';
     size_t number_of_main_ids   = 0;
+    pattern_t *pattern          = pattern_compile("{word} would {gain|lose} {int} happiness units by sitting next to {word}.");
 
     for(size_t i = 0; i < number_of_lines; i++) {
-        size_t number_of_tokens = 0;
-        char **tokens           = string_split(&number_of_tokens, lines[i], " ");
-        
-        char main_id    = tokens[0][0]; // First letter of the person we're currently looking at.
-        char minor_id   = tokens[10][0]; // First letter of the person they could be sitting next to.
-        int happiness   = atoi(tokens[3]) * (strcmp(tokens[2], "lose") == 0 ? -1 : 1); // Change in happiness if seated next to the person identified by minor_id.
+        // Alice would gain 54 happiness units by sitting next to Bob.
+        pattern_value_t values[4];
+        if(!pattern_match(pattern, string_view_from_cstr(lines[i]), values)) {
+            fprintf(stderr, "%s:%d: Unable to parse line %zu: %s\n", __func__, __LINE__, i, lines[i]);
+            continue;
+        }
+
+        char main_id    = values[0].word.data[0]; // First letter of the person we're currently looking at.
+        char minor_id   = values[3].word.data[0]; // First letter of the person they could be sitting next to.
+        int happiness   = (int)values[2].integer * (values[1].choice == 1 ? -1 : 1); // Change in happiness if seated next to the person identified by minor_id.
 
         map[(int)main_id % 65][(int)minor_id % 65] = happiness;
 
@@ -30,12 +35,8 @@ void calculate_happiness(int *result, char **lines, size_t number_of_lines, bool
             number_of_main_ids++;
         }
         current_main_id = main_id;
-
-        for(size_t i = 0; i < number_of_tokens; i++) {
-            free(tokens[i]);
-        }
-        free(tokens);
     }
+    pattern_destroy(pattern);
 
     if(include_yourself) {
         for(size_t i = 0; i < number_of_main_ids; i++) {
@@ -1,50 +1,38 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "aoc.h"
 #include "file4c.h"
+#include "heap4c.h"
+#include "pattern4c.h"
+#include "soa4c.h"
 #include "string4c.h"
 
-typedef struct Reindeer {
-    char *name;
-    int velocity_in_kps;
-    int stamina_in_seconds;
-    int rest_time_in_seconds;
-
-    // Race status
-    int remaining_stamina;
-    int remaining_rest_time;
-    int travelled_distance;
-    int points;
-} Reindeer;
-
-int compare_by_travelled_distance_desc(const void *a, const void *b) {
-    Reindeer reindeer_a = *((Reindeer*)a);
-    Reindeer reindeer_b = *((Reindeer*)b);
-
-    if(reindeer_a.travelled_distance == reindeer_b.travelled_distance) {
-        return 0;
-    }
-
-    if(reindeer_a.travelled_distance < reindeer_b.travelled_distance) {
-        return 1;
-    }
-
-    return -1;
-}
-
-int compare_by_points_desc(const void *a, const void *b) {
-    Reindeer reindeer_a = *((Reindeer*)a);
-    Reindeer reindeer_b = *((Reindeer*)b);
-
-    if(reindeer_a.points == reindeer_b.points) {
-        return 0;
-    }
-
-    if(reindeer_a.points < reindeer_b.points) {
-        return 1;
+#define REINDEER_FIELDS(X)              \
+    X(char*, name)                      \
+    X(int, velocity_in_kps)             \
+    X(int, stamina_in_seconds)          \
+    X(int, rest_time_in_seconds)        \
+    /* Race status */                   \
+    X(int, remaining_stamina)           \
+    X(int, remaining_rest_time)         \
+    X(int, travelled_distance)          \
+    X(int, points)
+
+typedef SOA_RECORD_OF_TYPE(REINDEER_FIELDS) Reindeer;
+typedef SOA_OF_TYPE(REINDEER_FIELDS) ReindeerHerd;
+
+CREATE_SOA_IMPL_FOR(ReindeerHerd, Reindeer, REINDEER_FIELDS)
+
+static int column_max(const int *column, size_t length) {
+    int max = column[0];
+    for(size_t i = 1; i < length; i++) {
+        if(column[i] > max) {
+            max = column[i];
+        }
     }
-
-    return -1;
+    return max;
 }
 
 int main(int argc, char *argv[]) {
@@ -54,63 +42,86 @@ int main(int argc, char *argv[]) {
     size_t number_of_lines = 0;
     char **lines = file_read_all_lines(&number_of_lines, argv[1]);
 
-    Reindeer reindeer[number_of_lines];
+    ReindeerHerd *herd = soa_create_ReindeerHerd(number_of_lines);
+    if(herd == NULL) {
+        fprintf(stderr, "%s:%d: Failed to allocate the reindeer herd\n", __func__, __LINE__);
+        exit(EXIT_FAILURE);
+    }
+    pattern_t *pattern = pattern_compile("{word} can fly {int} km/s for {int} seconds, but then must rest for {int} seconds.");
     for(size_t i = 0; i < number_of_lines; i++) {
-        size_t number_of_tokens = 0;
-        char **tokens = string_split(&number_of_tokens, lines[i], " ");
-
-        reindeer[i] = (Reindeer){
-            .name = tokens[0],
-            .velocity_in_kps = atoi(tokens[3]),
-            .stamina_in_seconds = atoi(tokens[6]),
-            .rest_time_in_seconds = atoi(tokens[13]),
+        // Vixen can fly 19 km/s for 7 seconds, but then must rest for 124 seconds.
+        pattern_value_t values[4];
+        if(!pattern_match(pattern, string_view_from_cstr(lines[i]), values)) {
+            fprintf(stderr, "%s:%d: Unable to parse line %zu: %s\n", __func__, __LINE__, i, lines[i]);
+            continue;
+        }
+        int64_t velocity = values[1].integer, stamina = values[2].integer, rest_time = values[3].integer;
+
+        Reindeer reindeer = {
+            .name = string_view_to_cstr(values[0].word),
+            .velocity_in_kps = (int)velocity,
+            .stamina_in_seconds = (int)stamina,
+            .rest_time_in_seconds = (int)rest_time,
             
             // Race status
-            .remaining_stamina = atoi(tokens[6]),
+            .remaining_stamina = (int)stamina,
             .remaining_rest_time = 0,
             .travelled_distance = 0,
             .points = 0
         };
-
-        FREE_ARRAY(tokens, number_of_tokens);
+        if(!soa_push_ReindeerHerd(herd, reindeer)) {
+            fprintf(stderr, "%s:%d: Failed to add reindeer %s to the herd\n", __func__, __LINE__, reindeer.name);
+            exit(EXIT_FAILURE);
+        }
+    }
+    pattern_destroy(pattern);
+
+    // The leaders are tracked in a max-heap keyed on distance. Distances only ever grow, so every tick is a handful of
+    // increase-key operations followed by a walk over the ids tied for the lead.
+    indexed_heap_t *leaderboard = indexed_heap_create(4, herd->size, HEAP_ORDER_MAX);
+    size_t *leaders             = calloc(herd->size, sizeof(size_t));
+    for(size_t j = 0; j < herd->size; j++) {
+        indexed_heap_push(leaderboard, j, 0);
     }
 
-    // Loop for 1000 "seconds".
+    // Loop for 2503 "seconds".
     for(int i = 0; i < 2503; i++) {
-        for(size_t j = 0; j < number_of_lines; j++) {
-            if(reindeer[j].remaining_stamina > 0) {
-                reindeer[j].travelled_distance += reindeer[j].velocity_in_kps;
-                reindeer[j].remaining_stamina--;
+        for(size_t j = 0; j < herd->size; j++) {
+            if(herd->remaining_stamina[j] > 0) {
+                herd->travelled_distance[j] += herd->velocity_in_kps[j];
+                herd->remaining_stamina[j]--;
+                indexed_heap_increase_key(leaderboard, j, herd->travelled_distance[j]);
                 continue;
             }
 
-            if(reindeer[j].remaining_rest_time == 0) {
-                reindeer[j].remaining_rest_time = reindeer[j].rest_time_in_seconds;
+            if(herd->remaining_rest_time[j] == 0) {
+                herd->remaining_rest_time[j] = herd->rest_time_in_seconds[j];
             }
 
-            reindeer[j].remaining_rest_time--;
-            if(reindeer[j].remaining_rest_time == 0) {
-                reindeer[j].remaining_stamina = reindeer[j].stamina_in_seconds;
+            herd->remaining_rest_time[j]--;
+            if(herd->remaining_rest_time[j] == 0) {
+                herd->remaining_stamina[j] = herd->stamina_in_seconds[j];
             }
         }
-        qsort(reindeer, number_of_lines, sizeof(Reindeer), compare_by_travelled_distance_desc);
-        int top_distance = reindeer[0].travelled_distance;
-        for(size_t j = 0; j < number_of_lines; j++) {
-            if(reindeer[j].travelled_distance == top_distance) {
-                reindeer[j].points++;
-            }
-            else {
-                break;
-            }
+
+        // Every reindeer tied for the lead gets a point.
+        size_t number_of_leaders = indexed_heap_top_ties(leaderboard, leaders, herd->size);
+        for(size_t j = 0; j < number_of_leaders; j++) {
+            herd->points[leaders[j]]++;
         }
     }
 
-    qsort(reindeer, number_of_lines, sizeof(Reindeer), compare_by_travelled_distance_desc);
-    solution_part_finalize_with_int(solution, 0, reindeer[0].travelled_distance, "2640");
-
-    qsort(reindeer, number_of_lines, sizeof(Reindeer), compare_by_points_desc);
-    solution_part_finalize_with_int(solution, 1, reindeer[0].points, "1102");
+    heap_entry_t leader;
+    indexed_heap_peek(leaderboard, &leader);
+    solution_part_finalize_with_int(solution, 0, (int)leader.priority, "2640");
+    solution_part_finalize_with_int(solution, 1, column_max(herd->points, herd->size), "1102");
 
+    free(leaders);
+    indexed_heap_destroy(leaderboard);
+    for(size_t i = 0; i < herd->size; i++) {
+        free(herd->name[i]);
+    }
+    soa_destroy_ReindeerHerd(herd);
     FREE_ARRAY(lines, number_of_lines);
     return solution_finalize_and_destroy(solution);
 }
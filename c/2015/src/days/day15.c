@@ -1,44 +1,46 @@
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "aoc.h"
 #include "file4c.h"
 #include "math4c.h"
+#include "pattern4c.h"
+#include "soa4c.h"
 #include "string4c.h"
 
-typedef struct ingredient_t {
-    char name[256];
-    int capacity;
-    int durability;
-    int flavor;
-    int texture;
-    int calories;
-} ingredient_t;
-
-typedef struct cookie_ingredient_t {
-    int amount;
-    ingredient_t ingredient;
-} cookie_ingredient_t;
-
-ingredient_t *ingredient_parse(char *str) {
-    size_t number_of_tokens = 0;
-    char **tokens           = string_split(&number_of_tokens, str, " ");
-    char *name              = string_substring(tokens[0], 0, (size_t)(strchr(tokens[0], ':') - tokens[0]));
-    size_t name_length      = strlen(name);
-    ingredient_t *result    = malloc(sizeof(ingredient_t));
-
-    strcpy(result->name, name);
-    result->name[name_length]   = '\0';
-    result->capacity            = atoi(tokens[2]);
-    result->durability          = atoi(tokens[4]);
-    result->flavor              = atoi(tokens[6]);
-    result->texture             = atoi(tokens[8]);
-    result->calories            = atoi(tokens[10]);
-
-    free(name);
-    FREE_ARRAY(tokens, number_of_tokens);
-    return result;
+#define INGREDIENT_FIELDS(X)    \
+    X(char*, name)              \
+    X(int, capacity)            \
+    X(int, durability)          \
+    X(int, flavor)              \
+    X(int, texture)             \
+    X(int, calories)
+
+typedef SOA_RECORD_OF_TYPE(INGREDIENT_FIELDS) ingredient_t;
+typedef SOA_OF_TYPE(INGREDIENT_FIELDS) ingredient_soa_t;
+
+CREATE_SOA_IMPL_FOR(ingredient_soa_t, ingredient_t, INGREDIENT_FIELDS)
+
+#define INGREDIENT_FORMAT "{word}: capacity {int}, durability {int}, flavor {int}, texture {int}, calories {int}"
+
+ingredient_t ingredient_parse(const pattern_t *pattern, char *str) {
+    // Butterscotch: capacity -1, durability -2, flavor 6, texture 3, calories 8
+    pattern_value_t values[6] = {0};
+    if(!pattern_match(pattern, string_view_from_cstr(str), values)) {
+        fprintf(stderr, "%s:%d: Unable to parse ingredient: %s\n", __func__, __LINE__, str);
+        return (ingredient_t){0};
+    }
+
+    return (ingredient_t){
+        .name       = string_view_to_cstr(values[0].word),
+        .capacity   = (int)values[1].integer,
+        .durability = (int)values[2].integer,
+        .flavor     = (int)values[3].integer,
+        .texture    = (int)values[4].integer,
+        .calories   = (int)values[5].integer
+    };
 }
 
 typedef struct cookie_score_t {
@@ -50,22 +52,24 @@ typedef struct cookie_score_t {
     uint64_t total_score;
 } cookie_score_t;
 
-cookie_score_t *cookie_compute_score(cookie_ingredient_t cookie_ingredients[], size_t number_of_cookie_ingredients) {
+/**
+ * Compute the score of a cookie. Every property is a dot product of the amounts and one ingredient column.
+ * @param ingredients The ingredients, stored column by column.
+ * @param amounts The amount of each ingredient in the cookie. Must contain one amount per ingredient.
+ */
+cookie_score_t *cookie_compute_score(const ingredient_soa_t *ingredients, const int *amounts) {
     int total_capacity = 0;
     int total_durability = 0;
     int total_flavor = 0;
     int total_texture = 0;
     int total_calories = 0;
 
-    for(size_t i = 0; i < number_of_cookie_ingredients; i++) {
-        int amount = cookie_ingredients[i].amount;
-        ingredient_t ingredient = cookie_ingredients[i].ingredient;
-
-        total_capacity += amount * ingredient.capacity;
-        total_durability += amount * ingredient.durability;
-        total_flavor += amount * ingredient.flavor;
-        total_texture += amount * ingredient.texture;
-        total_calories += amount * ingredient.calories;
+    for(size_t i = 0; i < ingredients->size; i++) {
+        total_capacity += amounts[i] * ingredients->capacity[i];
+        total_durability += amounts[i] * ingredients->durability[i];
+        total_flavor += amounts[i] * ingredients->flavor[i];
+        total_texture += amounts[i] * ingredients->texture[i];
+        total_calories += amounts[i] * ingredients->calories[i];
     }
 
     if(total_capacity < 0) {
@@ -144,7 +148,6 @@ int main(int argc, char *argv[]) {
     uint64_t *combinations  = math_stars_and_bars(100, number_of_lines);
     
     int *set            = calloc(number_of_lines, sizeof(int));
-    int *original_set   = set;
     int **sets          = calloc(*combinations, sizeof(int*));
 
     for(uint64_t i = 0; i < *combinations; i++) {
@@ -154,24 +157,25 @@ int main(int argc, char *argv[]) {
     int number_of_set = 0;
     compute_sets(100, number_of_lines, 0, 0, set, sets, &number_of_set);
 
-    ingredient_t **ingredients = calloc(number_of_lines, sizeof(ingredient_t*));
+    ingredient_soa_t *ingredients = soa_create_ingredient_soa_t(number_of_lines);
+    if(ingredients == NULL) {
+        fprintf(stderr, "%s:%d: Failed to allocate the ingredients\n", __func__, __LINE__);
+        exit(EXIT_FAILURE);
+    }
+    pattern_t *pattern = pattern_compile(INGREDIENT_FORMAT);
     for(size_t i = 0; i < number_of_lines; i++) {
-        ingredients[i] = ingredient_parse(lines[i]);
+        ingredient_t ingredient = ingredient_parse(pattern, lines[i]);
+        if(!soa_push_ingredient_soa_t(ingredients, ingredient)) {
+            fprintf(stderr, "%s:%d: Failed to add ingredient %s\n", __func__, __LINE__, ingredient.name);
+            exit(EXIT_FAILURE);
+        }
     }
+    pattern_destroy(pattern);
    
     uint64_t highest_cookie_score = 0;
     uint64_t highest_cookie_score_in_part_two = 0;
     for(uint64_t i = 0; i < *combinations; i++) {
-        set = sets[i];
-        cookie_ingredient_t cookie_ingredients[number_of_lines];
-        for(size_t j = 0; j < number_of_lines; j++) {
-            cookie_ingredients[j] = (cookie_ingredient_t){
-                .amount = set[j],
-                .ingredient = *ingredients[j]
-            };
-        }
-        
-        cookie_score_t *cookie_score = cookie_compute_score(cookie_ingredients, number_of_lines);
+        cookie_score_t *cookie_score = cookie_compute_score(ingredients, sets[i]);
         
         if(cookie_score->total_score > highest_cookie_score) {
             highest_cookie_score = cookie_score->total_score;
@@ -187,8 +191,11 @@ int main(int argc, char *argv[]) {
     solution_part_finalize_with_ui(solution, 0, highest_cookie_score, "222870");
     solution_part_finalize_with_ui(solution, 1, highest_cookie_score_in_part_two, "117936");
 
-    free(original_set);
-    FREE_ARRAY(ingredients, number_of_lines);
+    free(set);
+    for(size_t i = 0; i < ingredients->size; i++) {
+        free(ingredients->name[i]);
+    }
+    soa_destroy_ingredient_soa_t(ingredients);
     FREE_ARRAY(sets, *combinations);
     FREE_ARRAY(lines, number_of_lines);
     free(combinations);
@@ -4,7 +4,23 @@
 
 #include "aoc.h"
 #include "file4c.h"
-#include "string4c.h"
+#include "pattern4c.h"
+
+#define COMPOUNDS "{children|cats|samoyeds|pomeranians|akitas|vizslas|goldfish|trees|cars|perfumes}"
+
+typedef enum compound_t {
+    CHILDREN,
+    CATS,
+    SAMOYEDS,
+    POMERANIANS,
+    AKITAS,
+    VIZSLAS,
+    GOLDFISH,
+    TREES,
+    CARS,
+    PERFUMES,
+    NUMBER_OF_COMPOUNDS
+} compound_t;
 
 typedef struct AuntSue {
     int id;
@@ -44,80 +60,54 @@ int main(int argc, char *argv[]) {
     size_t number_of_lines = 0;
     char **lines = file_read_all_lines(&number_of_lines, argv[1]);
 
-    int children = 3;
-    int cats = 7;
-    int samoyeds = 2;
-    int pomeranians = 3;
-    int akitas = 0;
-    int vizslas = 0;
-    int goldfish = 5;
-    int trees = 3;
-    int cars = 2;
-    int perfumes = 1;
+    // The readings from the MFCSAM, in the order of the alternatives in COMPOUNDS.
+    const int readings[NUMBER_OF_COMPOUNDS] = { 3, 7, 2, 3, 0, 0, 5, 3, 2, 1 };
 
     int part_one = 0;
     int part_two = 0;
 
+    pattern_t *pattern = pattern_compile("Sue {int}: " COMPOUNDS ": {int}, " COMPOUNDS ": {int}, " COMPOUNDS ": {int}");
     for(size_t i = 0; i < number_of_lines; i++) {
-        size_t number_of_tokens;
-        char **tokens = string_split(&number_of_tokens, lines[i], " ");
-        char *id = string_substring(tokens[1], 0, (size_t)(strchr(tokens[1], ':') - tokens[1]));
+        // Sue 1: goldfish: 9, cars: 0, samoyeds: 9
+        pattern_value_t values[7];
+        if(!pattern_match(pattern, string_view_from_cstr(lines[i]), values)) {
+            fprintf(stderr, "%s:%d: Unable to parse line %zu: %s\n", __func__, __LINE__, i, lines[i]);
+            continue;
+        }
+        int64_t id = values[0].integer;
 
         bool is_match_in_part_one = true;
         bool is_match_in_part_two = true;
 
-        for(size_t j = 2; j < number_of_tokens - 1; j += 2) {
-            char *token = string_substring(tokens[j], 0, (size_t)(strchr(tokens[j], ':') - tokens[j]));
-            char *next_token = tokens[j + 1];
-            int value = atoi(next_token);
-
-            if(
-                (strcmp(token, "children") == 0 && value != children) ||
-                (strcmp(token, "samoyeds") == 0 && value != samoyeds) ||
-                (strcmp(token, "akitas") == 0 && value != akitas) ||
-                (strcmp(token, "vizslas") == 0 && value != vizslas) ||
-                (strcmp(token, "cars") == 0 && value != cars) ||
-                (strcmp(token, "perfumes") == 0 && value != perfumes)
-            ) {
-                is_match_in_part_one = false;
-                is_match_in_part_two = false;
+        for(size_t j = 1; j < 7; j += 2) {
+            size_t compound = values[j].choice;
+            int64_t value   = values[j + 1].integer;
+            int reading     = readings[compound];
 
-                free(token);
-                break;
+            if(compound == CATS || compound == TREES) {
+                is_match_in_part_one = is_match_in_part_one && value == reading;
+                is_match_in_part_two = is_match_in_part_two && reading <= value;
             }
-
-            if(
-                (strcmp(token, "cats") == 0 && value != cats) ||
-                (strcmp(token, "trees") == 0 && value != trees) ||
-                (strcmp(token, "pomeranians") == 0 && value != pomeranians) ||
-                (strcmp(token, "goldfish") == 0 && value != goldfish)
-            ) {
-                is_match_in_part_one = false;
+            else if(compound == POMERANIANS || compound == GOLDFISH) {
+                is_match_in_part_one = is_match_in_part_one && value == reading;
+                is_match_in_part_two = is_match_in_part_two && reading >= value;
             }
-
-            if(
-                (strcmp(token, "cats") == 0 && cats > value) ||
-                (strcmp(token, "trees") == 0 && trees > value) ||
-                (strcmp(token, "pomeranians") == 0 && pomeranians < value) ||
-                (strcmp(token, "goldfish") == 0 && goldfish < value)
-            ) {
+            else if(value != reading) {
+                is_match_in_part_one = false;
                 is_match_in_part_two = false;
+                break;
             }
-
-            free(token);
         }
 
         if(is_match_in_part_one) {
-            part_one = atoi(id);
+            part_one = (int)id;
         }
 
         if(is_match_in_part_two) {
-            part_two = atoi(id);
+            part_two = (int)id;
         }
-
-        free(id);
-        FREE_ARRAY(tokens, number_of_tokens);
     }
+    pattern_destroy(pattern);
 
     solution_part_finalize_with_int(solution, 0, part_one, "213");
     solution_part_finalize_with_int(solution, 1, part_two, "323");
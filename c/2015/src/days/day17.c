@@ -1,7 +1,9 @@
 #include <stdio.h>
+#include <string.h>
 #include "aoc.h"
 #include "file4c.h"
 #include "math4c.h"
+#include "number4c.h"
 
 int main(int argc, char *argv[]) {
     (void)argc;
@@ -9,12 +11,15 @@ int main(int argc, char *argv[]) {
     solution_t *solution    = solution_create(2015, 17);
     size_t number_of_lines  = 0;
     char **lines            = file_read_all_lines(&number_of_lines, argv[1]);
-    int liters              = atoi(lines[0]);
+    int32_t liters          = 0;
     int containers[number_of_lines - 1];
 
+    number_parse_i32(lines[0], strlen(lines[0]), &liters);
     free(lines[0]);
     for(size_t i = 1; i < number_of_lines; i++) {
-        containers[i - 1] = atoi(lines[i]);
+        int32_t container = 0;
+        number_parse_i32(lines[i], strlen(lines[i]), &container);
+        containers[i - 1] = container;
         free(lines[i]);
     }
     free(lines);
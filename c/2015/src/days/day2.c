@@ -5,6 +5,7 @@
 #include "aoc.h"
 #include "file4c.h"
 #include "math4c.h"
+#include "number4c.h"
 
 typedef struct RightRectangularPrism
 {
@@ -22,13 +23,12 @@ typedef struct RightRectangularPrism
 RightRectangularPrism *create_right_rectangular_prism(char *line)
 {
 	RightRectangularPrism *prism = malloc(sizeof(RightRectangularPrism));
-	char *copy = strdup(line);
+	int64_t dimensions[3] = {0};
 
-	prism->height = atoi(strtok(copy, "x"));
-	prism->length = atoi(strtok(NULL, "x"));
-	prism->width = atoi(strtok(NULL, "x"));
-
-	free(copy);
+	number_extract_i64(line, strlen(line), dimensions, 3);
+	prism->height = (uint32_t)dimensions[0];
+	prism->length = (uint32_t)dimensions[1];
+	prism->width = (uint32_t)dimensions[2];
 
 	prism->volume = prism->height * prism->length * prism->width;
 	prism->width_by_height = prism->width * prism->height;
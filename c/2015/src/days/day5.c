@@ -4,23 +4,17 @@
 #include <string.h>
 
 #include "aoc.h"
+#include "ctype4c.h"
 #include "file4c.h"
 #include "hashtable.h"
+#include "simd4c.h"
 #include "string4c.h"
 #include "test4c.h"
 
 #define DEBUG 1
 
-uint32_t get_vowels(const char *input) {
-    uint32_t vowels = 0;
-    for (uint32_t i = 0; i < strlen(input); i++)
-    {
-        if (input[i] == 'a' || input[i] == 'e' || input[i] == 'i' || input[i] == 'o' || input[i] == 'u')
-        {
-            vowels++;
-        }
-    }
-    return vowels;
+uint32_t get_vowels(const char *input, const simd_byte_set_t *vowels) {
+    return (uint32_t)simd_count_in_set(input, strlen(input), vowels);
 }
 
 uint32_t has_repeating_characters(const char *input) {
@@ -32,44 +26,15 @@ uint32_t has_repeating_characters(const char *input) {
     return 0;
 }
 
-char **get_forbidden_strings(const char *input, size_t *out_length) {
-    char **buffer = 0;
-    uint32_t current_buffer_length = 0;
-    uint32_t current_buffer_position = 0;
-    for (uint32_t i = 0; i < strlen(input); i++)
-    {
-        if (i > 0 && ((input[i - 1] == 'a' && input[i] == 'b') ||
-                      (input[i - 1] == 'c' && input[i] == 'd') ||
-                      (input[i - 1] == 'p' && input[i] == 'q') ||
-                      (input[i - 1] == 'x' && input[i] == 'y')))
-        {
-            buffer = realloc(buffer, (++current_buffer_length) * sizeof(*buffer));
-            buffer[current_buffer_position] = calloc(2, sizeof(char));
-            buffer[current_buffer_position][0] = input[i - 1];
-            buffer[current_buffer_position][1] = input[i];
-            current_buffer_position++;
-        }
-    }
-    *out_length = current_buffer_length;
-    return buffer;
-}
-
-uint32_t is_nice_line_in_part_one(const char *line) {
-    if (get_vowels(line) < 3 || has_repeating_characters(line) == 0) {
+uint32_t is_nice_line_in_part_one(const char *line, const simd_byte_set_t *vowels, const string_matcher_t *forbidden_strings) {
+    if (get_vowels(line, vowels) < 3 || has_repeating_characters(line) == 0) {
         return 0;
     }
 
-    size_t number_of_forbidden_strings = 0;
-    char **buffer = get_forbidden_strings(line, &number_of_forbidden_strings);
-    if (number_of_forbidden_strings > 0) {
-        for(size_t i = 0; i < number_of_forbidden_strings; i++) {
-            free(buffer[i]);
-        }
-        free(buffer);
+    if (string_matcher_find_first(forbidden_strings, line, strlen(line), NULL)) {
         return 0;
     }
 
-    free(buffer);
     return 1;
 }
 
@@ -119,11 +84,15 @@ uint32_t is_nice_line_in_part_two(const char *line) {
 
 void solve_part_one(char **lines, size_t length, solution_t *solution)
 {
+    simd_byte_set_t vowels;
+    ctype_build_set(&vowels, CTYPE_VOWEL);
+    string_matcher_t *forbidden_strings = string_matcher_create((const char *[]){ "ab", "cd", "pq", "xy" }, 4);
     int nice_lines = 0;
     for(size_t i = 0; i < length; i++)
     {
-        nice_lines += is_nice_line_in_part_one(lines[i]);
+        nice_lines += is_nice_line_in_part_one(lines[i], &vowels, forbidden_strings);
     }
+    string_matcher_destroy(forbidden_strings);
     solution_part_finalize_with_int(solution, 0, nice_lines, "258");
 }
 
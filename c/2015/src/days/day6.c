@@ -6,6 +6,7 @@
 #include "aoc.h"
 #include "file4c.h"
 #include "grid.h"
+#include "pattern4c.h"
 #include "point.h"
 #include "test4c.h"
 
@@ -26,12 +27,23 @@ typedef GRID_OF_TYPE(Light) LightGrid;
 
 CREATE_GRID_IMPL_FOR(LightGrid, Light)
 
-int action_parse(const char *line, Action *action) {
-    if (strncmp(line, "turn", 4) == 0) {
-        line += 5;
+#define ACTION_FORMAT "{turn on|turn off|toggle} {int},{int} through {int},{int}"
+
+// The operations in the order of the alternatives in ACTION_FORMAT.
+static const char *ACTION_OPERATIONS[] = { "on", "off", "toggle" };
+
+int action_parse(const pattern_t *pattern, const char *line, Action *action) {
+    pattern_value_t values[5];
+    if (!pattern_match(pattern, string_view_from_cstr(line), values)) {
+        return -1;
     }
 
-    return sscanf(line, "%s %ld,%ld through %ld,%ld", action->operation, &action->starting_point.x, &action->starting_point.y, &action->stopping_point.x, &action->stopping_point.y) == 5 ? 0 : -1;
+    strcpy(action->operation, ACTION_OPERATIONS[values[0].choice]);
+    action->starting_point.x = values[1].integer;
+    action->starting_point.y = values[2].integer;
+    action->stopping_point.x = values[3].integer;
+    action->stopping_point.y = values[4].integer;
+    return 0;
 }
 
 int action_compare(Action *a, Action *b)
@@ -86,12 +98,13 @@ void action_to_string(char *result, Action action)
 
 Action **actions_parse(char **lines, size_t length)
 {
+    pattern_t *pattern = pattern_compile(ACTION_FORMAT);
     Action **actions = calloc(length, sizeof(Action *));
     size_t number_of_actions = 0;
     for (size_t i = 0; i < length; i++)
     {
         actions[i] = malloc(sizeof(Action));
-        int action_parse_result = action_parse(lines[i], actions[i]);
+        int action_parse_result = action_parse(pattern, lines[i], actions[i]);
         if (action_parse_result == 0)
         {
             number_of_actions++;
@@ -101,6 +114,7 @@ Action **actions_parse(char **lines, size_t length)
             fprintf(stderr, "Unable to parse action on line %zu: %d\n", i, action_parse_result);
         }
     }
+    pattern_destroy(pattern);
 
     if (number_of_actions != length)
     {
@@ -215,7 +229,10 @@ void test_light_grid_adjust_brightness(TestResults *test_results, Action action,
 void test_action_parse(TestResults *test_results, char *line, Action expectation)
 {
     Action action;
-    if (action_parse(line, &action) != 0)
+    pattern_t *pattern = pattern_compile(ACTION_FORMAT);
+    int action_parse_result = action_parse(pattern, line, &action);
+    pattern_destroy(pattern);
+    if (action_parse_result != 0)
     {
         printf("Unable to parse action from line \"%s\"\n", line);
         return;
@@ -9,32 +9,37 @@ int main(int argc, char *argv[]) {
     (void)argc;
 
     solution_t *solution = solution_create(2015, 8);
-    size_t number_of_lines = 0;
-    char **lines = file_read_all_lines(&number_of_lines, argv[1]);
+    size_t length = 0;
+    const char *content = file_map_all_text(argv[1], &length);
 
+    // Only the lengths matter, so the lines are measured where they lie in the mapped file instead of being copied,
+    // unescaped and escaped.
     size_t total_for_part_one = 0;
     size_t total_for_part_two = 0;
-    for(size_t i = 0; i < number_of_lines; i++)
+    size_t position = 0;
+    while(content != NULL && position < length)
     {
-        size_t escaped_length = strlen(lines[i]);
-        char *unescaped_line = string_unescape(lines[i]);
-        size_t unescaped_length = strlen(unescaped_line) - 2;
-        total_for_part_one += escaped_length - unescaped_length;
-
-        unescaped_length = strlen(lines[i]);
-        char *escaped_line = string_escape(lines[i]);
-        escaped_length = strlen(escaped_line);
-        total_for_part_two += escaped_length - unescaped_length;
-
-        free(lines[i]);
-        free(unescaped_line);
-        free(escaped_line);
+        const char *newline = memchr(content + position, '\n', length - position);
+        size_t line_end = newline == NULL ? length : (size_t)(newline - content);
+        const char *line = content + position;
+        size_t line_length = line_end - position;
+        position = line_end + 1;
+
+        if(line_length > 0 && line[line_length - 1] == '\r') {
+            line_length--;
+        }
+        if(line_length == 0) {
+            continue;
+        }
+
+        total_for_part_one += line_length - (string_unescaped_length(line, line_length) - 2);
+        total_for_part_two += string_escaped_length(line, line_length) - line_length;
     }
 
     solution_part_finalize_with_int(solution, 0, total_for_part_one, "1333");
     solution_part_finalize_with_int(solution, 1, total_for_part_two, "2046");
 
-    free(lines);
-    
+    file_unmap(content, length);
+
     return solution_finalize_and_destroy(solution);
 }
@@ -5,6 +5,8 @@
 
 #include "aoc.h"
 #include "file4c.h"
+#include "pattern4c.h"
+#include "simd4c.h"
 #include "string4c.h"
 #include "hamiltonian.h"
 
@@ -16,16 +18,16 @@ void print_mask(int mask, int number_of_nodes) {
     printf("\n");
 }
 
-size_t get_city_index(char cities[][20], size_t *number_of_cities, char *city) {
+size_t get_city_index(string_owned_t *cities, size_t *number_of_cities, string_view_t city) {
     for(size_t i = 0; i < *number_of_cities; i++)
     {
-        if(strcmp(cities[i], city) == 0)
+        if(string_owned_equals(&cities[i], city))
         {
             return i;
         }
     }
 
-    strcpy(cities[*number_of_cities], city);
+    string_owned_init(&cities[*number_of_cities], city.data, city.length);
     (*number_of_cities)++;
     return *number_of_cities - 1;
 }
@@ -37,12 +39,44 @@ int main(int argc, char *argv[]) {
     (void)argc;
 
     size_t number_of_cities = 0;
-    char cities[100][20];
+    string_owned_t cities[100];
     int matrix[100][20];
 
     solution_t *solution = solution_create(2015, 9);
-    size_t number_of_lines = 0;
-    char **lines = file_read_all_lines(&number_of_lines, argv[1]);
+    size_t length = 0;
+    const char *content = file_map_all_text(argv[1], &length);
+
+    // London to Dublin = 464
+    if(content == NULL) {
+        fprintf(stderr, "%s:%d: Failed to read %s\n", __func__, __LINE__, argv[1]);
+        exit(EXIT_FAILURE);
+    }
+
+    // Every line that is not empty has to match, or the graph would be missing its distances.
+    size_t expected_lines = 0;
+    for(const char *line = content, *end = content + length; line < end;) {
+        const char *newline = memchr(line, '\n', (size_t)(end - line));
+        const char *line_end = newline != NULL ? newline : end;
+        size_t line_length = (size_t)(line_end - line);
+        if(line_length > 0 && line[line_length - 1] == '\r') {
+            line_length--;
+        }
+        expected_lines += line_length > 0 ? 1 : 0;
+        line = line_end + 1;
+    }
+
+    pattern_t *pattern = pattern_compile("{word} to {word} = {int}");
+    size_t max_lines = simd_count_byte(content, length, '\n') + 1;
+    pattern_value_t *values = malloc(max_lines * 3 * sizeof(pattern_value_t));
+    if(values == NULL) {
+        fprintf(stderr, "%s:%d: Failed to allocate memory for %zu lines\n", __func__, __LINE__, max_lines);
+        exit(EXIT_FAILURE);
+    }
+    size_t number_of_lines = pattern_match_lines(pattern, content, length, values, max_lines);
+    if(number_of_lines < expected_lines) {
+        fprintf(stderr, "%s:%d: Unable to parse line %zu of %s\n", __func__, __LINE__, number_of_lines + 1, argv[1]);
+        exit(EXIT_FAILURE);
+    }
 
     // Set up an adjancency matrix where each node has its own id.
     // The node ids determine the order of the rows and columns.
@@ -54,26 +88,25 @@ int main(int argc, char *argv[]) {
     // Belfast     518    141       0
     for(size_t i = 0; i < number_of_lines; i++)
     {
-        size_t number_of_tokens = 0;
-        char **tokens = string_split(&number_of_tokens, lines[i], " ");
-
-        size_t city_index_1 = get_city_index(cities, &number_of_cities, tokens[0]);
-        size_t city_index_2 = get_city_index(cities, &number_of_cities, tokens[2]);
-        int distance = atoi(tokens[4]);
+        const pattern_value_t *line_values = values + i * 3;
+        int64_t distance = line_values[2].integer;
 
-        matrix[city_index_1][city_index_2] = distance;
-        matrix[city_index_2][city_index_1] = distance;
+        size_t city_index_1 = get_city_index(cities, &number_of_cities, line_values[0].word);
+        size_t city_index_2 = get_city_index(cities, &number_of_cities, line_values[1].word);
 
-        free(lines[i]);
-        for(size_t i = 0; i < number_of_tokens; i++) {
-            free(tokens[i]);
-        }
-        free(tokens);
+        matrix[city_index_1][city_index_2] = (int)distance;
+        matrix[city_index_2][city_index_1] = (int)distance;
     }
 
     solution_part_finalize_with_int(solution, 0, hamiltonian_compute(matrix, number_of_cities, HP_NONE), "251");
     solution_part_finalize_with_int(solution, 1, hamiltonian_compute(matrix, number_of_cities, HP_FIND_MAXIMUM_COST), "898");
 
-    free(lines);
+    for(size_t i = 0; i < number_of_cities; i++)
+    {
+        string_owned_free(&cities[i]);
+    }
+    free(values);
+    pattern_destroy(pattern);
+    file_unmap(content, length);
     return solution_finalize_and_destroy(solution);
 }
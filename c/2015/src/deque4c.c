@@ -0,0 +1,11 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deque4c.h"
+
+CREATE_DEQUE_IMPL_FOR(DequeInt, int)
+CREATE_DEQUE_IMPL_FOR(DequeSize, size_t)
+CREATE_SPSC_QUEUE_IMPL_FOR(SpscQueuePointer, void*)
@@ -2,6 +2,9 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "file4c.h"
@@ -52,3 +55,45 @@ char **file_read_all_lines(size_t *out_number_of_lines, char *filename) {
     *out_number_of_lines = number_of_lines;
     return lines;
 }
+
+const char *file_map_all_text(char *filename, size_t *out_length) {
+    if(file_is_invalid(filename)) {
+        return NULL;
+    }
+
+    int descriptor = open(filename, O_RDONLY);
+    if(descriptor < 0) {
+        fprintf(stderr, "%s():%d: failed to open %s\n", __func__, __LINE__, filename);
+        return NULL;
+    }
+
+    struct stat status;
+    if(fstat(descriptor, &status) != 0) {
+        fprintf(stderr, "%s():%d: failed to get the size of %s\n", __func__, __LINE__, filename);
+        close(descriptor);
+        return NULL;
+    }
+
+    // An empty file cannot be mapped, so it is represented by an empty string that file_unmap leaves alone.
+    *out_length = (size_t)status.st_size;
+    if(*out_length == 0) {
+        close(descriptor);
+        return "";
+    }
+
+    void *content = mmap(NULL, *out_length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if(content == MAP_FAILED) {
+        fprintf(stderr, "%s():%d: failed to map %s\n", __func__, __LINE__, filename);
+        return NULL;
+    }
+
+    madvise(content, *out_length, MADV_SEQUENTIAL);
+    return content;
+}
+
+void file_unmap(const char *content, size_t length) {
+    if(content != NULL && length > 0) {
+        munmap((void *)content, length);
+    }
+}
@@ -16,13 +16,18 @@ uint64_t *fnv1a(const char *bytes)
         return NULL;
     }
 
-    *hash = FNV_OFFSET_BASIS;
-    size_t length = strlen(bytes);
+    *hash = fnv1a_bytes(bytes, strlen(bytes));
+    return hash;
+}
+
+uint64_t fnv1a_bytes(const void *bytes, size_t length)
+{
+    const uint8_t *data = bytes;
+    uint64_t hash = FNV_OFFSET_BASIS;
     for (size_t i = 0; i < length; i++)
     {
-        uint8_t byte_of_data = bytes[i];
-        *hash ^= byte_of_data;
-        *hash *= FNV_PRIME;
+        hash ^= data[i];
+        hash *= FNV_PRIME;
     }
     return hash;
 }
\ No newline at end of file
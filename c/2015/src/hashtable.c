@@ -4,6 +4,7 @@
 
 #include "fnv.h"
 #include "hashtable.h"
+#include "string4c.h"
 
 #define FNV_OFFSET_BASIS 14695981039346656037UL
 #define FNV_PRIME 1099511628211UL
@@ -15,7 +16,7 @@ struct HashTable {
 };
 
 struct HashTableEntry {
-    char *key;
+    string_owned_t key;     // Short keys are stored inline in the entry.
     uint64_t key_hash;
     void *value;
     struct HashTableEntry *next;
@@ -82,7 +83,7 @@ void hashtable_destroy(HashTable *hashtable)
         while (entry)
         {
             HashTableEntry *next = entry->next;
-            free(entry->key);
+            string_owned_free(&entry->key);
             free(entry->value);
             free(entry);
             entry = next;
@@ -99,14 +100,14 @@ uint64_t *hashtable_hash(const char *key)
 }
 
 HashTableEntry *hashtable_get(const HashTable *hashtable, const char *key) {
-    uint64_t *hash = hashtable_hash(key);
-    size_t index = *hash % hashtable->capacity;
-    free(hash);
+    string_view_t key_view = string_view_from_cstr(key);
+    uint64_t hash = fnv1a_bytes(key_view.data, key_view.length);
+    size_t index = hash % hashtable->capacity;
 
     HashTableEntry *entry = hashtable->entries[index];
     while (entry != NULL)
     {
-        if (strcmp(entry->key, key) == 0)
+        if (entry->key_hash == hash && string_owned_equals(&entry->key, key_view))
         {
             return entry;
         }
@@ -165,28 +166,23 @@ HashTableEntry *hashtable_put(HashTable *hashtable, char *key, void *value, size
         return NULL;
     }
 
-    uint64_t *hash = hashtable_hash(key);
-    if(hash == NULL) {
-        fprintf(stderr, "%s:%d: Failed to hash the key \"%s\". Aborting insertion of entry with key \"%s\"\n", __func__, __LINE__, key, key);
-        return NULL;
-    }
-
-    size_t index = *hash % hashtable->capacity;
+    size_t key_length = strlen(key);
+    uint64_t hash = fnv1a_bytes(key, key_length);
+    size_t index = hash % hashtable->capacity;
     HashTableEntry *new_entry = malloc(sizeof(HashTableEntry));
     if(new_entry == NULL) {
         fprintf(stderr, "%s(): Unable to allocate memory for new entry.\n", __func__);
         return NULL;
     }
 
-    new_entry->key = strdup(key);
-    if(new_entry->key == NULL)
+    if(!string_owned_init(&new_entry->key, key, key_length))
     {
         fprintf(stderr, "%s(): Unable to duplicate key for new entry.\n", __func__);
         free(new_entry);
         return NULL;
     }
 
-    new_entry->key_hash = *hash;
+    new_entry->key_hash = hash;
     new_entry->value = malloc(length + 1);
     sprintf(new_entry->value, "%s", (char*)value);
     ((char*)new_entry->value)[length] = '\0';
@@ -194,7 +190,6 @@ HashTableEntry *hashtable_put(HashTable *hashtable, char *key, void *value, size
     hashtable->entries[index] = new_entry;
     hashtable->size++;
 
-    free(hash);
     return new_entry;
 }
 
@@ -252,13 +247,15 @@ HashTableEntry *hashtable_iterator_next(HashTableIterator *hashtable_iterator)
 HashTableEntry *hashtable_entry_create(char *key, void *value)
 {
     HashTableEntry *entry = malloc(sizeof(HashTableEntry));
-    entry->key = key;
+    string_owned_init(&entry->key, key, strlen(key));
+    entry->key_hash = fnv1a_bytes(key, entry->key.length);
     entry->value = value;
+    entry->next = NULL;
     return entry;
 }
 
 char *hashtable_entry_get_key(HashTableEntry *entry) {
-    return entry->key;
+    return (char *)string_owned_get(&entry->key);
 }
 
 void *hashtable_entry_get_value(HashTableEntry *entry) {
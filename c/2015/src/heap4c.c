@@ -0,0 +1,388 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "heap4c.h"
+
+#define HEAP_NO_POSITION SIZE_MAX
+
+struct heap_t {
+    size_t          arity;
+    size_t          capacity;
+    size_t          size;
+    heap_order_t    order;
+    heap_entry_t    *entries;
+};
+
+struct indexed_heap_t {
+    size_t          arity;
+    size_t          number_of_ids;
+    size_t          size;
+    heap_order_t    order;
+    size_t          *ids;           // Heap ordered ids.
+    size_t          *positions;     // Position of every id in ids, or HEAP_NO_POSITION.
+    int64_t         *priorities;    // Priority of every id.
+    size_t          *scratch;       // Work list for indexed_heap_top_ties.
+};
+
+// Whether priority a belongs closer to the top of the heap than priority b.
+static inline bool heap_precedes(heap_order_t order, int64_t a, int64_t b) {
+    return order == HEAP_ORDER_MIN ? a < b : a > b;
+}
+
+heap_t *heap_create(size_t arity, size_t capacity, heap_order_t order) {
+    if(arity < 2) {
+        fprintf(stderr, "%s:%s:%d: arity must be at least 2 (%zu)\n", __FILE__, __func__, __LINE__, arity);
+        return NULL;
+    }
+
+    heap_t *heap = malloc(sizeof(heap_t));
+    if(heap == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for heap\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    heap->arity     = arity;
+    heap->capacity  = capacity > 0 ? capacity : 16;
+    heap->size      = 0;
+    heap->order     = order;
+    heap->entries   = malloc(heap->capacity * sizeof(heap_entry_t));
+    if(heap->entries == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for heap entries\n", __FILE__, __func__, __LINE__);
+        free(heap);
+        return NULL;
+    }
+
+    return heap;
+}
+
+void heap_destroy(heap_t *heap) {
+    free(heap->entries);
+    free(heap);
+}
+
+size_t heap_get_size(heap_t *heap) {
+    return heap->size;
+}
+
+static void heap_sift_up(heap_t *heap, size_t pos) {
+    heap_entry_t entry = heap->entries[pos];
+    while(pos > 0) {
+        size_t parent = (pos - 1) / heap->arity;
+        if(!heap_precedes(heap->order, entry.priority, heap->entries[parent].priority)) {
+            break;
+        }
+        heap->entries[pos] = heap->entries[parent];
+        pos = parent;
+    }
+    heap->entries[pos] = entry;
+}
+
+static void heap_sift_down(heap_t *heap, size_t pos) {
+    heap_entry_t entry = heap->entries[pos];
+    while(true) {
+        size_t first_child = pos * heap->arity + 1;
+        if(first_child >= heap->size) {
+            break;
+        }
+
+        size_t last_child = first_child + heap->arity;
+        if(last_child > heap->size) {
+            last_child = heap->size;
+        }
+
+        size_t best = first_child;
+        for(size_t child = first_child + 1; child < last_child; child++) {
+            if(heap_precedes(heap->order, heap->entries[child].priority, heap->entries[best].priority)) {
+                best = child;
+            }
+        }
+
+        if(!heap_precedes(heap->order, heap->entries[best].priority, entry.priority)) {
+            break;
+        }
+        heap->entries[pos] = heap->entries[best];
+        pos = best;
+    }
+    heap->entries[pos] = entry;
+}
+
+bool heap_push(heap_t *heap, size_t id, int64_t priority) {
+    if(heap->size >= heap->capacity) {
+        size_t new_capacity = heap->capacity * 2;
+        heap_entry_t *new_entries = realloc(heap->entries, new_capacity * sizeof(heap_entry_t));
+        if(new_entries == NULL) {
+            fprintf(stderr, "%s:%s:%d: failed to allocate additional memory for heap entries\n", __FILE__, __func__, __LINE__);
+            return false;
+        }
+        heap->entries   = new_entries;
+        heap->capacity  = new_capacity;
+    }
+
+    heap->entries[heap->size] = (heap_entry_t){ .id = id, .priority = priority };
+    heap_sift_up(heap, heap->size++);
+    return true;
+}
+
+bool heap_peek(heap_t *heap, heap_entry_t *out_entry) {
+    if(heap->size == 0) {
+        return false;
+    }
+
+    *out_entry = heap->entries[0];
+    return true;
+}
+
+bool heap_pop(heap_t *heap, heap_entry_t *out_entry) {
+    if(heap->size == 0) {
+        return false;
+    }
+
+    if(out_entry != NULL) {
+        *out_entry = heap->entries[0];
+    }
+
+    heap->size--;
+    if(heap->size > 0) {
+        heap->entries[0] = heap->entries[heap->size];
+        heap_sift_down(heap, 0);
+    }
+    return true;
+}
+
+indexed_heap_t *indexed_heap_create(size_t arity, size_t number_of_ids, heap_order_t order) {
+    if(arity < 2) {
+        fprintf(stderr, "%s:%s:%d: arity must be at least 2 (%zu)\n", __FILE__, __func__, __LINE__, arity);
+        return NULL;
+    }
+
+    indexed_heap_t *heap = malloc(sizeof(indexed_heap_t));
+    if(heap == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for heap\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    size_t allocation_size  = number_of_ids > 0 ? number_of_ids : 1;
+    heap->arity             = arity;
+    heap->number_of_ids     = number_of_ids;
+    heap->size              = 0;
+    heap->order             = order;
+    heap->ids               = malloc(allocation_size * sizeof(size_t));
+    heap->positions         = malloc(allocation_size * sizeof(size_t));
+    heap->priorities        = malloc(allocation_size * sizeof(int64_t));
+    heap->scratch           = malloc(allocation_size * sizeof(size_t));
+
+    if(heap->ids == NULL || heap->positions == NULL || heap->priorities == NULL || heap->scratch == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for heap arrays\n", __FILE__, __func__, __LINE__);
+        indexed_heap_destroy(heap);
+        return NULL;
+    }
+
+    for(size_t id = 0; id < number_of_ids; id++) {
+        heap->positions[id] = HEAP_NO_POSITION;
+    }
+
+    return heap;
+}
+
+void indexed_heap_destroy(indexed_heap_t *heap) {
+    free(heap->ids);
+    free(heap->positions);
+    free(heap->priorities);
+    free(heap->scratch);
+    free(heap);
+}
+
+size_t indexed_heap_get_size(indexed_heap_t *heap) {
+    return heap->size;
+}
+
+bool indexed_heap_contains(indexed_heap_t *heap, size_t id) {
+    return id < heap->number_of_ids && heap->positions[id] != HEAP_NO_POSITION;
+}
+
+int64_t indexed_heap_get_priority(indexed_heap_t *heap, size_t id) {
+    return heap->priorities[id];
+}
+
+static inline void indexed_heap_place(indexed_heap_t *heap, size_t pos, size_t id) {
+    heap->ids[pos]          = id;
+    heap->positions[id]     = pos;
+}
+
+static void indexed_heap_sift_up(indexed_heap_t *heap, size_t pos) {
+    size_t id           = heap->ids[pos];
+    int64_t priority    = heap->priorities[id];
+    while(pos > 0) {
+        size_t parent = (pos - 1) / heap->arity;
+        if(!heap_precedes(heap->order, priority, heap->priorities[heap->ids[parent]])) {
+            break;
+        }
+        indexed_heap_place(heap, pos, heap->ids[parent]);
+        pos = parent;
+    }
+    indexed_heap_place(heap, pos, id);
+}
+
+static void indexed_heap_sift_down(indexed_heap_t *heap, size_t pos) {
+    size_t id           = heap->ids[pos];
+    int64_t priority    = heap->priorities[id];
+    while(true) {
+        size_t first_child = pos * heap->arity + 1;
+        if(first_child >= heap->size) {
+            break;
+        }
+
+        size_t last_child = first_child + heap->arity;
+        if(last_child > heap->size) {
+            last_child = heap->size;
+        }
+
+        size_t best = first_child;
+        for(size_t child = first_child + 1; child < last_child; child++) {
+            if(heap_precedes(heap->order, heap->priorities[heap->ids[child]], heap->priorities[heap->ids[best]])) {
+                best = child;
+            }
+        }
+
+        if(!heap_precedes(heap->order, heap->priorities[heap->ids[best]], priority)) {
+            break;
+        }
+        indexed_heap_place(heap, pos, heap->ids[best]);
+        pos = best;
+    }
+    indexed_heap_place(heap, pos, id);
+}
+
+bool indexed_heap_push(indexed_heap_t *heap, size_t id, int64_t priority) {
+    if(id >= heap->number_of_ids) {
+        fprintf(stderr, "%s:%s:%d: id %zu is out of range\n", __FILE__, __func__, __LINE__, id);
+        return false;
+    }
+
+    if(heap->positions[id] != HEAP_NO_POSITION) {
+        fprintf(stderr, "%s:%s:%d: id %zu is already in the heap\n", __FILE__, __func__, __LINE__, id);
+        return false;
+    }
+
+    heap->priorities[id] = priority;
+    indexed_heap_place(heap, heap->size, id);
+    indexed_heap_sift_up(heap, heap->size++);
+    return true;
+}
+
+bool indexed_heap_update(indexed_heap_t *heap, size_t id, int64_t priority) {
+    if(!indexed_heap_contains(heap, id)) {
+        fprintf(stderr, "%s:%s:%d: id %zu is not in the heap\n", __FILE__, __func__, __LINE__, id);
+        return false;
+    }
+
+    int64_t old_priority    = heap->priorities[id];
+    heap->priorities[id]    = priority;
+    if(heap_precedes(heap->order, priority, old_priority)) {
+        indexed_heap_sift_up(heap, heap->positions[id]);
+    }
+    else {
+        indexed_heap_sift_down(heap, heap->positions[id]);
+    }
+    return true;
+}
+
+bool indexed_heap_decrease_key(indexed_heap_t *heap, size_t id, int64_t priority) {
+    if(indexed_heap_contains(heap, id) && priority > heap->priorities[id]) {
+        fprintf(stderr, "%s:%s:%d: %" PRId64 " is higher than the current priority of id %zu\n", __FILE__, __func__, __LINE__, priority, id);
+        return false;
+    }
+    return indexed_heap_update(heap, id, priority);
+}
+
+bool indexed_heap_increase_key(indexed_heap_t *heap, size_t id, int64_t priority) {
+    if(indexed_heap_contains(heap, id) && priority < heap->priorities[id]) {
+        fprintf(stderr, "%s:%s:%d: %" PRId64 " is lower than the current priority of id %zu\n", __FILE__, __func__, __LINE__, priority, id);
+        return false;
+    }
+    return indexed_heap_update(heap, id, priority);
+}
+
+bool indexed_heap_peek(indexed_heap_t *heap, heap_entry_t *out_entry) {
+    if(heap->size == 0) {
+        return false;
+    }
+
+    *out_entry = (heap_entry_t){ .id = heap->ids[0], .priority = heap->priorities[heap->ids[0]] };
+    return true;
+}
+
+bool indexed_heap_remove(indexed_heap_t *heap, size_t id) {
+    if(!indexed_heap_contains(heap, id)) {
+        return false;
+    }
+
+    size_t pos          = heap->positions[id];
+    heap->positions[id] = HEAP_NO_POSITION;
+    heap->size--;
+
+    if(pos == heap->size) {
+        return true;
+    }
+
+    // Move the last id into the hole and restore the heap property in whichever direction it is violated.
+    size_t last_id = heap->ids[heap->size];
+    indexed_heap_place(heap, pos, last_id);
+    if(pos > 0 && heap_precedes(heap->order, heap->priorities[last_id], heap->priorities[heap->ids[(pos - 1) / heap->arity]])) {
+        indexed_heap_sift_up(heap, pos);
+    }
+    else {
+        indexed_heap_sift_down(heap, pos);
+    }
+    return true;
+}
+
+bool indexed_heap_pop(indexed_heap_t *heap, heap_entry_t *out_entry) {
+    if(heap->size == 0) {
+        return false;
+    }
+
+    size_t id = heap->ids[0];
+    if(out_entry != NULL) {
+        *out_entry = (heap_entry_t){ .id = id, .priority = heap->priorities[id] };
+    }
+    return indexed_heap_remove(heap, id);
+}
+
+size_t indexed_heap_top_ties(indexed_heap_t *heap, size_t *out_ids, size_t max_ids) {
+    if(heap->size == 0) {
+        return 0;
+    }
+
+    int64_t top             = heap->priorities[heap->ids[0]];
+    size_t head             = 0;
+    size_t tail             = 0;
+    size_t number_of_ties   = 0;
+
+    // Breadth first walk from the root. A node that isn't tied with the root can't have tied descendants.
+    heap->scratch[tail++] = 0;
+    while(head < tail) {
+        size_t pos = heap->scratch[head++];
+        if(number_of_ties < max_ids) {
+            out_ids[number_of_ties] = heap->ids[pos];
+        }
+        number_of_ties++;
+
+        size_t first_child  = pos * heap->arity + 1;
+        size_t last_child   = first_child + heap->arity;
+        if(last_child > heap->size) {
+            last_child = heap->size;
+        }
+
+        for(size_t child = first_child; child < last_child; child++) {
+            if(heap->priorities[heap->ids[child]] == top) {
+                heap->scratch[tail++] = child;
+            }
+        }
+    }
+
+    return number_of_ties;
+}
@@ -0,0 +1,315 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ctype4c.h"
+#include "json/cursor.h"
+#include "json/index.h"
+#include "json/number.h"
+#include "number4c.h"
+
+static bool json_cursor_fail(json_cursor_t *cursor, const char *message) {
+    size_t offset = cursor->position < cursor->index_length ? cursor->index[cursor->position] : cursor->length;
+    fprintf(stderr, "%s:%s:%d: %s at offset %zu\n", __FILE__, __func__, __LINE__, message, offset);
+    cursor->error = true;
+    return false;
+}
+
+/**
+ * json_cursor_at: Get the byte an index entry points at, or '\0' past the last entry.
+ */
+static char json_cursor_at(const json_cursor_t *cursor, size_t position) {
+    return position < cursor->index_length ? cursor->data[cursor->index[position]] : '\0';
+}
+
+/**
+ * json_cursor_scalar_ends: Check that a number or literal ending at offset is not followed by anything that would make
+ * it part of a longer scalar, such as the fraction of a number.
+ */
+static bool json_cursor_scalar_ends(const json_cursor_t *cursor, size_t offset) {
+    if(offset == cursor->length) {
+        return true;
+    }
+    char c = cursor->data[offset];
+    return json_is_space(c) || c == ',' || c == ']' || c == '}';
+}
+
+/**
+ * json_cursor_match: Move from the bracket or brace at the cursor past the one that closes it. Strings are pairs of
+ * quote entries and nothing inside them is indexed, so only the brackets have to be counted.
+ */
+static bool json_cursor_match(json_cursor_t *cursor, size_t depth) {
+    const char *data        = cursor->data;
+    const uint32_t *index   = cursor->index;
+
+    for(size_t position = cursor->position; position < cursor->index_length; position++) {
+        char c = data[index[position]];
+        if(c == '{' || c == '[') {
+            depth++;
+        }
+        else if((c == '}' || c == ']') && --depth == 0) {
+            cursor->position = position + 1;
+            return true;
+        }
+    }
+    return json_cursor_fail(cursor, "unterminated container");
+}
+
+bool json_cursor_init(json_cursor_t *cursor, const char *data, size_t length) {
+    *cursor         = (json_cursor_t){ .data = data, .length = length };
+    cursor->index   = json_index_build(data, length, &cursor->index_length);
+    return cursor->index != NULL;
+}
+
+void json_cursor_free(json_cursor_t *cursor) {
+    free(cursor->index);
+    cursor->index           = NULL;
+    cursor->index_length    = 0;
+}
+
+void json_cursor_rewind(json_cursor_t *cursor) {
+    cursor->position    = 0;
+    cursor->error       = false;
+}
+
+bool json_cursor_peek(const json_cursor_t *cursor, json_value_type_t *out_type) {
+    if(cursor->error) {
+        return false;
+    }
+
+    char c = json_cursor_at(cursor, cursor->position);
+    switch(c) {
+        case '{': *out_type = JSON_VALUE_TYPE_OBJECT; return true;
+        case '[': *out_type = JSON_VALUE_TYPE_ARRAY; return true;
+        case '"': *out_type = JSON_VALUE_TYPE_STRING; return true;
+        case 't':
+        case 'f': *out_type = JSON_VALUE_TYPE_BOOL; return true;
+        case 'n': *out_type = JSON_VALUE_TYPE_NULL; return true;
+        default:
+            if(c == '-' || ctype_is_digit(c)) {
+                *out_type = JSON_VALUE_TYPE_NUMBER;
+                return true;
+            }
+            return false;
+    }
+}
+
+bool json_cursor_skip(json_cursor_t *cursor) {
+    json_value_type_t type;
+    if(!json_cursor_peek(cursor, &type)) {
+        return cursor->error ? false : json_cursor_fail(cursor, "expected a value");
+    }
+
+    switch(type) {
+        case JSON_VALUE_TYPE_OBJECT:
+        case JSON_VALUE_TYPE_ARRAY:
+            return json_cursor_match(cursor, 0);
+        case JSON_VALUE_TYPE_STRING:
+            // A string is indexed by its opening and its closing quote.
+            cursor->position += 2;
+            return true;
+        default:
+            cursor->position++;
+            return true;
+    }
+}
+
+bool json_cursor_enter(json_cursor_t *cursor) {
+    json_value_type_t type;
+    if(!json_cursor_peek(cursor, &type) || (type != JSON_VALUE_TYPE_OBJECT && type != JSON_VALUE_TYPE_ARRAY)) {
+        return cursor->error ? false : json_cursor_fail(cursor, "expected an array or an object");
+    }
+    cursor->position++;
+    return true;
+}
+
+bool json_cursor_next(json_cursor_t *cursor, string_view_t *out_key) {
+    if(cursor->error) {
+        return false;
+    }
+
+    // The entry before the cursor is the opening bracket before the first element, and the end of the previous element
+    // after that, which is never an opening bracket since a container is only ever skipped whole.
+    char previous   = cursor->position > 0 ? json_cursor_at(cursor, cursor->position - 1) : '\0';
+    bool is_first   = previous == '{' || previous == '[';
+    char c          = json_cursor_at(cursor, cursor->position);
+
+    if(c == '}' || c == ']') {
+        cursor->position++;
+        return false;
+    }
+    if(!is_first) {
+        if(c != ',') {
+            return json_cursor_fail(cursor, "expected a comma or the end of the container");
+        }
+        cursor->position++;
+    }
+
+    // A string followed by a colon is a key, which is how the cursor can tell objects from arrays without a stack.
+    if(json_cursor_at(cursor, cursor->position) == '"' && json_cursor_at(cursor, cursor->position + 2) == ':') {
+        if(out_key != NULL) {
+            uint32_t start  = cursor->index[cursor->position] + 1;
+            *out_key        = string_view_create(cursor->data + start, cursor->index[cursor->position + 1] - start);
+        }
+        cursor->position += 3;
+    }
+    else if(out_key != NULL) {
+        // Objects are not told apart from arrays, so a member written without a key gets an empty one rather than
+        // whatever the caller's key held before.
+        *out_key = string_view_create("", 0);
+    }
+
+    json_value_type_t type;
+    return json_cursor_peek(cursor, &type) || json_cursor_fail(cursor, "expected a value");
+}
+
+bool json_cursor_leave(json_cursor_t *cursor) {
+    return !cursor->error && json_cursor_match(cursor, 1);
+}
+
+bool json_cursor_get_number(json_cursor_t *cursor, json_number_t *out_value) {
+    json_value_type_t type;
+    if(!json_cursor_peek(cursor, &type) || type != JSON_VALUE_TYPE_NUMBER) {
+        return cursor->error ? false : json_cursor_fail(cursor, "expected a number");
+    }
+
+    size_t offset   = cursor->index[cursor->position];
+    size_t consumed = json_number_parse(cursor->data + offset, cursor->length - offset, out_value);
+    if(consumed == 0 || !json_cursor_scalar_ends(cursor, offset + consumed)) {
+        return json_cursor_fail(cursor, "invalid number");
+    }
+    cursor->position++;
+    return true;
+}
+
+bool json_cursor_get_int64(json_cursor_t *cursor, int64_t *out_value) {
+    json_number_t number;
+    if(!json_cursor_get_number(cursor, &number)) {
+        return false;
+    }
+    if(number.type != JSON_NUMBER_TYPE_INTEGER) {
+        cursor->position--;
+        return json_cursor_fail(cursor, "expected an integer");
+    }
+    *out_value = number.as.integer;
+    return true;
+}
+
+bool json_cursor_get_double(json_cursor_t *cursor, double *out_value) {
+    json_number_t number;
+    if(!json_cursor_get_number(cursor, &number)) {
+        return false;
+    }
+    *out_value = json_number_get_double(number);
+    return true;
+}
+
+bool json_cursor_get_string(json_cursor_t *cursor, string_view_t *out_value) {
+    json_value_type_t type;
+    if(!json_cursor_peek(cursor, &type) || type != JSON_VALUE_TYPE_STRING) {
+        return cursor->error ? false : json_cursor_fail(cursor, "expected a string");
+    }
+
+    uint32_t start  = cursor->index[cursor->position] + 1;
+    *out_value      = string_view_create(cursor->data + start, cursor->index[cursor->position + 1] - start);
+    cursor->position += 2;
+    return true;
+}
+
+bool json_cursor_get_bool(json_cursor_t *cursor, bool *out_value) {
+    json_value_type_t type;
+    if(!json_cursor_peek(cursor, &type) || type != JSON_VALUE_TYPE_BOOL) {
+        return cursor->error ? false : json_cursor_fail(cursor, "expected a bool");
+    }
+
+    size_t offset       = cursor->index[cursor->position];
+    bool value          = cursor->data[offset] == 't';
+    const char *literal = value ? "true" : "false";
+    size_t length       = strlen(literal);
+    if(cursor->length - offset < length || memcmp(cursor->data + offset, literal, length) != 0 || !json_cursor_scalar_ends(cursor, offset + length)) {
+        return json_cursor_fail(cursor, "invalid literal");
+    }
+    *out_value = value;
+    cursor->position++;
+    return true;
+}
+
+/**
+ * json_pointer_token_equals: Compare a reference token of a JSON Pointer, with "~1" and "~0" still escaped, to a key.
+ */
+static bool json_pointer_token_equals(const char *token, size_t token_length, string_view_t key) {
+    size_t k = 0;
+    for(size_t i = 0; i < token_length; i++, k++) {
+        char c = token[i];
+        if(c == '~' && i + 1 < token_length && (token[i + 1] == '0' || token[i + 1] == '1')) {
+            c = token[++i] == '0' ? '~' : '/';
+        }
+        if(k == key.length || key.data[k] != c) {
+            return false;
+        }
+    }
+    return k == key.length;
+}
+
+static bool json_cursor_find_token(json_cursor_t *cursor, const char *token, size_t token_length) {
+    json_value_type_t type;
+    if(!json_cursor_peek(cursor, &type)) {
+        return false;
+    }
+
+    if(type == JSON_VALUE_TYPE_OBJECT) {
+        string_view_t key;
+        json_cursor_enter(cursor);
+        while(json_cursor_next(cursor, &key)) {
+            if(json_pointer_token_equals(token, token_length, key)) {
+                return true;
+            }
+            if(!json_cursor_skip(cursor)) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    if(type == JSON_VALUE_TYPE_ARRAY) {
+        // Array indices are plain decimal numbers without leading zeros.
+        uint64_t target = 0;
+        if(token_length == 0 || (token_length > 1 && token[0] == '0') || number_parse_u64(token, token_length, &target) != token_length) {
+            return false;
+        }
+        json_cursor_enter(cursor);
+        for(uint64_t i = 0; json_cursor_next(cursor, NULL); i++) {
+            if(i == target) {
+                return true;
+            }
+            if(!json_cursor_skip(cursor)) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    return false;
+}
+
+bool json_cursor_find(json_cursor_t *cursor, const char *pointer) {
+    if(cursor->error || (*pointer != '\0' && *pointer != '/')) {
+        return false;
+    }
+
+    size_t start = cursor->position;
+    while(*pointer == '/') {
+        const char *token   = pointer + 1;
+        const char *end     = strchr(token, '/');
+        size_t token_length = end != NULL ? (size_t)(end - token) : strlen(token);
+
+        if(!json_cursor_find_token(cursor, token, token_length)) {
+            cursor->position    = start;
+            cursor->error       = false;
+            return false;
+        }
+        pointer = token + token_length;
+    }
+    return true;
+}
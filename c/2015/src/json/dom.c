@@ -0,0 +1,569 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena4c.h"
+#include "fnv.h"
+#include "json/dom.h"
+#include "json/index.h"
+#include "json/key_index.h"
+#include "json/lexer.h"
+
+struct json_document_t {
+    arena_t         *arena;
+    json_value_t    root;
+    size_t          max_depth;
+};
+
+// An open array or object. Its children are collected on the scratch stack from scratch_start onwards and moved into
+// the arena in one piece once the container is closed, which is when their number is known.
+typedef struct json_dom_frame_t {
+    size_t  scratch_start;
+    bool    is_object;
+} json_dom_frame_t;
+
+// Below this many bytes per thread, starting a thread costs more than it saves.
+#define JSON_DOM_MIN_BYTES_PER_THREAD (64 * 1024)
+
+typedef enum json_dom_state_t {
+    JSON_DOM_STATE_VALUE,       // A value must follow.
+    JSON_DOM_STATE_KEY,         // An object key and a colon must follow.
+    JSON_DOM_STATE_AFTER_VALUE  // A comma, the end of the enclosing container or the end of the document must follow.
+} json_dom_state_t;
+
+typedef struct json_dom_builder_t {
+    const char          *str;
+    const json_token_t  *tokens;
+    arena_t             *arena;
+    json_member_t       *scratch;
+    size_t              scratch_size;
+    size_t              scratch_capacity;
+    json_dom_frame_t    *frames;
+    size_t              depth;
+    size_t              base_depth;     // Frames opened before the first token, when the tokens are a slice of an array.
+    size_t              max_depth;
+    size_t              frames_capacity;
+    json_value_t        root;
+} json_dom_builder_t;
+
+static bool json_dom_grow(void **items, size_t *capacity, size_t item_size) {
+    size_t new_capacity = *capacity == 0 ? 64 : *capacity * 2;
+    void *new_items     = realloc(*items, new_capacity * item_size);
+    if(new_items == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate additional memory for the document builder\n", __FILE__, __func__, __LINE__);
+        return false;
+    }
+    *items      = new_items;
+    *capacity   = new_capacity;
+    return true;
+}
+
+static bool json_dom_push_member(json_dom_builder_t *builder, const char *key, uint32_t key_length) {
+    if(builder->scratch_size == builder->scratch_capacity && !json_dom_grow((void **)&builder->scratch, &builder->scratch_capacity, sizeof(json_member_t))) {
+        return false;
+    }
+    builder->scratch[builder->scratch_size++] = (json_member_t){ .key = key, .key_length = key_length };
+    return true;
+}
+
+/**
+ * json_dom_emit: Hand a finished value to whatever encloses it. An object already pushed a member for it when its key
+ * was read, so only arrays push a new slot.
+ */
+static bool json_dom_emit(json_dom_builder_t *builder, json_value_t value) {
+    if(builder->depth == 0) {
+        builder->root = value;
+        return true;
+    }
+    if(!builder->frames[builder->depth - 1].is_object && !json_dom_push_member(builder, NULL, 0)) {
+        return false;
+    }
+    builder->scratch[builder->scratch_size - 1].value = value;
+    return true;
+}
+
+static char *json_dom_copy_string(arena_t *arena, const char *str, const json_token_t *token) {
+    char *copy = arena_alloc(arena, token->length + 1);
+    if(copy != NULL) {
+        memcpy(copy, str + token->offset, token->length);
+        copy[token->length] = '\0';
+    }
+    return copy;
+}
+
+static bool json_dom_close(json_dom_builder_t *builder) {
+    json_dom_frame_t frame  = builder->frames[--builder->depth];
+    size_t length           = builder->scratch_size - frame.scratch_start;
+    json_member_t *children = builder->scratch + frame.scratch_start;
+    json_value_t value      = { .type = frame.is_object ? JSON_VALUE_TYPE_OBJECT : JSON_VALUE_TYPE_ARRAY, .length = (uint32_t)length };
+
+    if(frame.is_object) {
+        // Large objects carry a hash index over their keys directly after the members.
+        size_t index_capacity = length >= JSON_KEY_INDEX_THRESHOLD ? json_key_index_capacity(length) : 0;
+        value.as.members = arena_alloc(builder->arena, length * sizeof(json_member_t) + index_capacity * sizeof(uint32_t));
+        if(value.as.members == NULL) {
+            return false;
+        }
+        if(length > 0) {
+            memcpy(value.as.members, children, length * sizeof(json_member_t));
+        }
+
+        if(index_capacity > 0) {
+            uint32_t *slots = (uint32_t *)(value.as.members + length);
+            memset(slots, 0, index_capacity * sizeof(uint32_t));
+            for(size_t i = 0; i < length; i++) {
+                json_key_index_insert(slots, index_capacity, fnv1a_bytes(children[i].key, children[i].key_length), (uint32_t)i);
+            }
+        }
+    }
+    else {
+        value.as.elements = arena_alloc(builder->arena, length * sizeof(json_value_t));
+        if(value.as.elements == NULL) {
+            return false;
+        }
+        for(size_t i = 0; i < length; i++) {
+            value.as.elements[i] = children[i].value;
+        }
+    }
+
+    builder->scratch_size = frame.scratch_start;
+    return json_dom_emit(builder, value);
+}
+
+static bool json_dom_open(json_dom_builder_t *builder, bool is_object) {
+    if(builder->depth == builder->frames_capacity && !json_dom_grow((void **)&builder->frames, &builder->frames_capacity, sizeof(json_dom_frame_t))) {
+        return false;
+    }
+    builder->frames[builder->depth++] = (json_dom_frame_t){ .scratch_start = builder->scratch_size, .is_object = is_object };
+    if(builder->depth > builder->max_depth) {
+        builder->max_depth = builder->depth;
+    }
+    return true;
+}
+
+static bool json_dom_build(json_dom_builder_t *builder, size_t number_of_tokens) {
+    const json_token_t *tokens  = builder->tokens;
+    json_dom_state_t state      = JSON_DOM_STATE_VALUE;
+
+    for(size_t i = 0; i < number_of_tokens; i++) {
+        const json_token_t *token = &tokens[i];
+
+        if(state == JSON_DOM_STATE_KEY) {
+            if(token->type != JSON_TOKEN_TYPE_STRING || i + 1 >= number_of_tokens || tokens[i + 1].type != JSON_TOKEN_TYPE_COLON) {
+                fprintf(stderr, "%s:%s:%d: expected a key and a colon at offset %u\n", __FILE__, __func__, __LINE__, token->offset);
+                return false;
+            }
+            char *key = json_dom_copy_string(builder->arena, builder->str, token);
+            if(key == NULL || !json_dom_push_member(builder, key, token->length)) {
+                return false;
+            }
+            state = JSON_DOM_STATE_VALUE;
+            i++; // Move past the colon.
+            continue;
+        }
+
+        if(state == JSON_DOM_STATE_AFTER_VALUE) {
+            bool is_object = builder->depth > 0 && builder->frames[builder->depth - 1].is_object;
+            if(builder->depth > 0 && token->type == JSON_TOKEN_TYPE_COMMA) {
+                state = is_object ? JSON_DOM_STATE_KEY : JSON_DOM_STATE_VALUE;
+            }
+            else if(builder->depth > builder->base_depth && token->type == (is_object ? JSON_TOKEN_TYPE_RIGHT_BRACE : JSON_TOKEN_TYPE_RIGHT_BRACKET)) {
+                if(!json_dom_close(builder)) {
+                    return false;
+                }
+            }
+            else {
+                fprintf(stderr, "%s:%s:%d: unexpected %s at offset %u\n", __FILE__, __func__, __LINE__, json_token_type_strings[token->type - 1], token->offset);
+                return false;
+            }
+            continue;
+        }
+
+        json_value_t value  = { .type = JSON_VALUE_TYPE_NULL };
+        json_number_t number = { .type = JSON_NUMBER_TYPE_INTEGER };
+        state               = JSON_DOM_STATE_AFTER_VALUE;
+
+        switch(token->type) {
+            case JSON_TOKEN_TYPE_LEFT_BRACE:
+            case JSON_TOKEN_TYPE_LEFT_BRACKET:
+                if(!json_dom_open(builder, token->type == JSON_TOKEN_TYPE_LEFT_BRACE)) {
+                    return false;
+                }
+                // The end of an empty container is handled as if it followed a value.
+                if(i + 1 >= number_of_tokens || (tokens[i + 1].type != JSON_TOKEN_TYPE_RIGHT_BRACE && tokens[i + 1].type != JSON_TOKEN_TYPE_RIGHT_BRACKET)) {
+                    state = token->type == JSON_TOKEN_TYPE_LEFT_BRACE ? JSON_DOM_STATE_KEY : JSON_DOM_STATE_VALUE;
+                }
+                continue;
+            case JSON_TOKEN_TYPE_STRING:
+                value.type      = JSON_VALUE_TYPE_STRING;
+                value.length    = token->length;
+                value.as.string = json_dom_copy_string(builder->arena, builder->str, token);
+                if(value.as.string == NULL) {
+                    return false;
+                }
+                break;
+            case JSON_TOKEN_TYPE_NUMBER:
+                value.type = JSON_VALUE_TYPE_NUMBER;
+                json_token_get_number(builder->str, token, &number);
+                value.number_type = number.type;
+                if(number.type == JSON_NUMBER_TYPE_INTEGER) {
+                    value.as.number = number.as.integer;
+                }
+                else {
+                    value.as.real = number.as.real;
+                }
+                break;
+            case JSON_TOKEN_TYPE_BOOL:
+                value.type = JSON_VALUE_TYPE_BOOL;
+                json_token_get_bool(builder->str, token, &value.as.boolean);
+                break;
+            case JSON_TOKEN_TYPE_NULL:
+                break;
+            default:
+                fprintf(stderr, "%s:%s:%d: expected a value at offset %u, but got %s\n", __FILE__, __func__, __LINE__, token->offset, json_token_type_strings[token->type - 1]);
+                return false;
+        }
+
+        if(!json_dom_emit(builder, value)) {
+            return false;
+        }
+    }
+
+    if(state != JSON_DOM_STATE_AFTER_VALUE || builder->depth > builder->base_depth) {
+        fprintf(stderr, "%s:%s:%d: unexpected end of document\n", __FILE__, __func__, __LINE__);
+        return false;
+    }
+    return true;
+}
+
+json_document_t *json_document_parse(const char *str) {
+    size_t number_of_tokens = 0;
+    json_token_t *tokens    = json_lex(str, &number_of_tokens);
+    if(tokens == NULL) {
+        return NULL;
+    }
+
+    // Every value takes at most 32 bytes, and a string at most its length plus padding, so this is nearly always enough
+    // for a single block.
+    json_document_t *document   = malloc(sizeof(json_document_t));
+    arena_t *arena              = arena_create(number_of_tokens * sizeof(json_value_t) + strlen(str));
+    json_dom_builder_t builder  = { .str = str, .tokens = tokens, .arena = arena };
+
+    bool built = document != NULL && arena != NULL && json_dom_build(&builder, number_of_tokens);
+
+    free(builder.scratch);
+    free(builder.frames);
+    free(tokens);
+
+    if(!built) {
+        if(document == NULL) {
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for document\n", __FILE__, __func__, __LINE__);
+        }
+        arena_destroy(arena);
+        free(document);
+        return NULL;
+    }
+
+    document->arena     = arena;
+    document->root      = builder.root;
+    document->max_depth = builder.max_depth;
+    return document;
+}
+
+// A run of consecutive elements of a top-level array, and the values parsed from it.
+typedef struct json_dom_chunk_t {
+    const char          *str;
+    const uint32_t      *index;         // The entries of the elements and the commas between them.
+    size_t              index_length;
+    size_t              end_offset;     // The offset of the comma or bracket that follows the last element.
+    json_dom_builder_t  builder;
+    json_token_t        *tokens;
+    bool                built;
+} json_dom_chunk_t;
+
+/**
+ * json_dom_build_chunk: Lex and build the elements of a chunk into an arena of its own. The elements are built as if the
+ * array they belong to had already been opened, so they end up as the children of that frame on the scratch stack.
+ */
+static void *json_dom_build_chunk(void *argument) {
+    json_dom_chunk_t *chunk = argument;
+    size_t number_of_tokens = 0;
+
+    chunk->tokens = json_lex_index(chunk->str, chunk->index, chunk->index_length, chunk->end_offset, &number_of_tokens);
+    if(chunk->tokens == NULL) {
+        return NULL;
+    }
+
+    size_t bytes            = chunk->end_offset - chunk->index[0];
+    chunk->builder          = (json_dom_builder_t){ .str = chunk->str, .tokens = chunk->tokens, .base_depth = 1 };
+    chunk->builder.arena    = arena_create(number_of_tokens * sizeof(json_value_t) + bytes);
+    chunk->built            = chunk->builder.arena != NULL && json_dom_open(&chunk->builder, false) && json_dom_build(&chunk->builder, number_of_tokens);
+    return NULL;
+}
+
+/**
+ * json_dom_split: Find where the elements of the top-level array start, and pick boundaries that give every chunk
+ * about the same number of bytes. Only the brackets between the index entries have to be looked at, and each one has to
+ * close the bracket that opened last, or a comma could be taken for a boundary it is not.
+ * @param out_starts Receives the entry each chunk starts at, followed by the entry of the closing bracket.
+ * @return The number of chunks, or 0 if the document is not a single array or its brackets do not pair up.
+ */
+static size_t json_dom_split(const char *str, const uint32_t *index, size_t index_length, size_t number_of_chunks, size_t *out_starts) {
+    if(index_length < 2 || str[index[0]] != '[') {
+        return 0;
+    }
+
+    size_t bytes_per_chunk  = (index[index_length - 1] - index[0]) / number_of_chunks + 1;
+    size_t chunks           = 0;
+    char *closers           = NULL;
+    size_t closers_capacity = 0;
+    size_t depth            = 0;
+    out_starts[chunks++]    = 1;
+
+    for(size_t k = 0; k < index_length; k++) {
+        char c = str[index[k]];
+        if(c == '[' || c == '{') {
+            if(depth == closers_capacity && !json_dom_grow((void **)&closers, &closers_capacity, sizeof(char))) {
+                break;
+            }
+            closers[depth++] = c == '[' ? ']' : '}';
+        }
+        else if(c == ']' || c == '}') {
+            if(closers[--depth] != c) {
+                break;
+            }
+            if(depth == 0) {
+                // The array has to be the whole document, and it must not be empty.
+                free(closers);
+                if(k != index_length - 1 || k == 1) {
+                    return 0;
+                }
+                out_starts[chunks] = k;
+                return chunks;
+            }
+        }
+        else if(c == ',' && depth == 1 && chunks < number_of_chunks && index[k] - index[0] >= chunks * bytes_per_chunk) {
+            out_starts[chunks++] = k + 1;
+        }
+    }
+    free(closers);
+    return 0;
+}
+
+json_document_t *json_document_parse_parallel(const char *str, size_t number_of_threads) {
+    size_t length           = strlen(str);
+    size_t number_of_chunks = length / JSON_DOM_MIN_BYTES_PER_THREAD;
+    if(number_of_chunks > number_of_threads) {
+        number_of_chunks = number_of_threads;
+    }
+    if(number_of_chunks < 2) {
+        return json_document_parse(str);
+    }
+
+    size_t index_length = 0;
+    uint32_t *index     = json_index_build(str, length, &index_length);
+    if(index == NULL) {
+        return NULL;
+    }
+
+    // The number of threads is up to the caller, so the bookkeeping for them goes on the heap rather than the stack.
+    size_t *starts              = malloc((number_of_chunks + 1) * sizeof(size_t));
+    json_dom_chunk_t *chunks    = malloc(number_of_chunks * sizeof(json_dom_chunk_t));
+    pthread_t *threads          = malloc(number_of_chunks * sizeof(pthread_t));
+    if(starts == NULL || chunks == NULL || threads == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for %zu chunks\n", __FILE__, __func__, __LINE__, number_of_chunks);
+        free(starts);
+        free(chunks);
+        free(threads);
+        free(index);
+        return NULL;
+    }
+
+    number_of_chunks = json_dom_split(str, index, index_length, number_of_chunks, starts);
+    if(number_of_chunks < 2) {
+        // Not an array, or one too small or malformed to split. Parse it as a whole, which also reports any error.
+        free(starts);
+        free(chunks);
+        free(threads);
+        free(index);
+        return json_document_parse(str);
+    }
+
+    for(size_t c = 0; c < number_of_chunks; c++) {
+        // Every chunk but the last ends with a comma, which belongs to neither side.
+        size_t end      = c == number_of_chunks - 1 ? starts[c + 1] : starts[c + 1] - 1;
+        chunks[c]       = (json_dom_chunk_t){ .str = str, .index = index + starts[c], .index_length = end - starts[c], .end_offset = index[end] };
+    }
+
+    size_t started = 1;
+    for(; started < number_of_chunks; started++) {
+        if(pthread_create(&threads[started], NULL, json_dom_build_chunk, &chunks[started]) != 0) {
+            break;
+        }
+    }
+    json_dom_build_chunk(&chunks[0]);
+    for(size_t c = 1; c < number_of_chunks; c++) {
+        if(c < started) {
+            pthread_join(threads[c], NULL);
+        }
+        else {
+            json_dom_build_chunk(&chunks[c]);
+        }
+    }
+
+    // Stitch the elements together in order. The arenas of the chunks become part of the document, so the values they
+    // point to stay where they are.
+    json_document_t *document   = malloc(sizeof(json_document_t));
+    arena_t *arena              = arena_create(0);
+    size_t number_of_elements   = 0;
+    bool built                  = document != NULL && arena != NULL;
+    for(size_t c = 0; c < number_of_chunks; c++) {
+        built               = built && chunks[c].built;
+        number_of_elements  += chunks[c].built ? chunks[c].builder.scratch_size : 0;
+    }
+
+    json_value_t root = { .type = JSON_VALUE_TYPE_ARRAY, .length = (uint32_t)number_of_elements };
+    if(built) {
+        root.as.elements    = arena_alloc(arena, number_of_elements * sizeof(json_value_t));
+        built               = root.as.elements != NULL;
+    }
+
+    size_t position     = 0;
+    size_t max_depth    = 0;
+    for(size_t c = 0; c < number_of_chunks; c++) {
+        json_dom_builder_t *builder = &chunks[c].builder;
+        if(built) {
+            for(size_t i = 0; i < builder->scratch_size; i++) {
+                root.as.elements[position++] = builder->scratch[i].value;
+            }
+            max_depth = builder->max_depth > max_depth ? builder->max_depth : max_depth;
+            arena_merge(arena, builder->arena);
+        }
+        else {
+            arena_destroy(builder->arena);
+        }
+        free(builder->scratch);
+        free(builder->frames);
+        free(chunks[c].tokens);
+    }
+    free(starts);
+    free(chunks);
+    free(threads);
+    free(index);
+
+    if(!built) {
+        arena_destroy(arena);
+        free(document);
+        return NULL;
+    }
+
+    document->arena     = arena;
+    document->root      = root;
+    document->max_depth = max_depth;
+    return document;
+}
+
+void json_document_destroy(json_document_t *document) {
+    if(document == NULL) {
+        return;
+    }
+    arena_destroy(document->arena);
+    free(document);
+}
+
+const json_value_t *json_document_get_root(const json_document_t *document) {
+    return &document->root;
+}
+
+size_t json_document_get_depth(const json_document_t *document) {
+    return document->max_depth;
+}
+
+const arena_t *json_document_get_arena(const json_document_t *document) {
+    return document->arena;
+}
+
+const json_value_t *json_value_get(const json_value_t *object, const char *key) {
+    if(object->type != JSON_VALUE_TYPE_OBJECT) {
+        return NULL;
+    }
+
+    size_t key_length = strlen(key);
+    if(object->length >= JSON_KEY_INDEX_THRESHOLD) {
+        const uint32_t *slots   = (const uint32_t *)(object->as.members + object->length);
+        size_t mask             = json_key_index_capacity(object->length) - 1;
+        for(size_t slot = fnv1a_bytes(key, key_length) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            const json_member_t *member = &object->as.members[slots[slot] - 1];
+            if(member->key_length == key_length && memcmp(member->key, key, key_length) == 0) {
+                return &member->value;
+            }
+        }
+        return NULL;
+    }
+
+    for(uint32_t i = 0; i < object->length; i++) {
+        if(object->as.members[i].key_length == key_length && memcmp(object->as.members[i].key, key, key_length) == 0) {
+            return &object->as.members[i].value;
+        }
+    }
+    return NULL;
+}
+
+// A container being visited and the position of the next child to visit in it.
+typedef struct json_visit_frame_t {
+    const json_value_t  *container;
+    uint32_t            next;
+} json_visit_frame_t;
+
+bool json_value_visit(const json_value_t *root, json_visitor_t visitor, void *context, size_t *out_max_depth) {
+    json_visit_frame_t *frames  = NULL;
+    size_t depth                = 0;
+    size_t max_depth            = 0;
+    size_t capacity             = 0;
+    bool completed              = true;
+    const json_value_t *value   = root;
+    const char *key             = NULL;
+
+    while(true) {
+        json_visit_t result = visitor(value, key, depth, context);
+        if(result == JSON_VISIT_STOP) {
+            completed = false;
+            break;
+        }
+        if(result == JSON_VISIT_CONTINUE && (value->type == JSON_VALUE_TYPE_ARRAY || value->type == JSON_VALUE_TYPE_OBJECT)) {
+            if(depth == capacity && !json_dom_grow((void **)&frames, &capacity, sizeof(json_visit_frame_t))) {
+                completed = false;
+                break;
+            }
+            frames[depth++] = (json_visit_frame_t){ .container = value, .next = 0 };
+            max_depth       = depth > max_depth ? depth : max_depth;
+        }
+
+        // Move on to the next child of the innermost container that has any left.
+        while(depth > 0 && frames[depth - 1].next == frames[depth - 1].container->length) {
+            depth--;
+        }
+        if(depth == 0) {
+            break;
+        }
+
+        json_visit_frame_t *frame = &frames[depth - 1];
+        if(frame->container->type == JSON_VALUE_TYPE_OBJECT) {
+            key     = frame->container->as.members[frame->next].key;
+            value   = &frame->container->as.members[frame->next].value;
+        }
+        else {
+            key     = NULL;
+            value   = &frame->container->as.elements[frame->next];
+        }
+        frame->next++;
+    }
+
+    free(frames);
+    if(out_max_depth != NULL) {
+        *out_max_depth = max_depth;
+    }
+    return completed;
+}
@@ -0,0 +1,134 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json/index.h"
+#include "simd4c.h"
+
+#define JSON_INDEX_BLOCK_SIZE 64
+
+typedef enum json_index_class_t {
+    JSON_INDEX_CLASS_QUOTE,
+    JSON_INDEX_CLASS_BACKSLASH,
+    JSON_INDEX_CLASS_STRUCTURAL,
+    JSON_INDEX_CLASS_WHITESPACE,
+    JSON_INDEX_NUMBER_OF_CLASSES
+} json_index_class_t;
+
+// The state carried from one block to the next.
+typedef struct json_index_carry_t {
+    uint64_t    escaped;    // 1 if the first byte of the next block is escaped by a backslash at the end of this one.
+    uint64_t    in_string;  // All ones if this block ends inside a string.
+    uint64_t    in_scalar;  // 1 if this block ends inside a number or literal.
+} json_index_carry_t;
+
+static void json_index_build_sets(simd_byte_set_t sets[JSON_INDEX_NUMBER_OF_CLASSES]) {
+    memset(sets, 0, JSON_INDEX_NUMBER_OF_CLASSES * sizeof(simd_byte_set_t));
+    simd_byte_set_add(&sets[JSON_INDEX_CLASS_QUOTE], '"');
+    simd_byte_set_add(&sets[JSON_INDEX_CLASS_BACKSLASH], '\\');
+    for(const char *c = "{}[]:,"; *c != '\0'; c++) {
+        simd_byte_set_add(&sets[JSON_INDEX_CLASS_STRUCTURAL], (unsigned char)*c);
+    }
+    for(const char *c = " \t\n\r"; *c != '\0'; c++) {
+        simd_byte_set_add(&sets[JSON_INDEX_CLASS_WHITESPACE], (unsigned char)*c);
+    }
+}
+
+/**
+ * json_index_find_escaped: Find the bytes escaped by a backslash. A backslash escapes the byte after it unless it is
+ * escaped itself, so in a run of backslashes every second one counts, starting with the first. Runs that start on an
+ * odd bit are shifted onto even bits by adding their start, which carries through the run and leaves a bit set just
+ * past its end; comparing that against the even bits tells which runs have odd length.
+ */
+static inline uint64_t json_index_find_escaped(uint64_t backslash, json_index_carry_t *carry) {
+    const uint64_t even_bits = 0x5555555555555555ull;
+
+    backslash               &= ~carry->escaped;
+    uint64_t follows_escape = backslash << 1 | carry->escaped;
+    uint64_t odd_starts     = backslash & ~even_bits & ~follows_escape;
+    uint64_t even_sequences;
+    carry->escaped          = __builtin_add_overflow(odd_starts, backslash, &even_sequences);
+    uint64_t invert_mask    = even_sequences << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+/**
+ * json_index_prefix_xor: Set every bit that has an odd number of set bits at or below it. Applied to the quote mask this
+ * gives the bytes inside strings, counting the opening quote but not the closing one.
+ */
+static inline uint64_t json_index_prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+static inline uint64_t json_index_classify_block(const char *block, size_t length, const simd_byte_set_t *sets, json_index_carry_t *carry) {
+    uint64_t masks[JSON_INDEX_NUMBER_OF_CLASSES];
+    simd_classify_block(block, length, sets, JSON_INDEX_NUMBER_OF_CLASSES, masks);
+
+    uint64_t quotes     = masks[JSON_INDEX_CLASS_QUOTE] & ~json_index_find_escaped(masks[JSON_INDEX_CLASS_BACKSLASH], carry);
+    uint64_t in_string  = json_index_prefix_xor(quotes) ^ carry->in_string;
+    carry->in_string    = (uint64_t)((int64_t)in_string >> 63);
+
+    uint64_t valid      = length >= JSON_INDEX_BLOCK_SIZE ? UINT64_MAX : (1ull << length) - 1;
+    uint64_t structural = masks[JSON_INDEX_CLASS_STRUCTURAL] & ~in_string;
+    uint64_t scalar     = ~(masks[JSON_INDEX_CLASS_STRUCTURAL] | masks[JSON_INDEX_CLASS_WHITESPACE] | quotes | in_string) & valid;
+    uint64_t starts     = scalar & ~(scalar << 1 | carry->in_scalar);
+    carry->in_scalar    = scalar >> 63;
+
+    return structural | quotes | starts;
+}
+
+uint32_t *json_index_build(const char *data, size_t length, size_t *out_length) {
+    if(length > UINT32_MAX) {
+        fprintf(stderr, "%s:%s:%d: the document is too long for 32-bit offsets\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    simd_byte_set_t sets[JSON_INDEX_NUMBER_OF_CLASSES];
+    json_index_build_sets(sets);
+
+    // Most documents have far fewer entries than bytes, so start small and grow. A block adds at most 64 entries.
+    size_t capacity     = length / 4 + JSON_INDEX_BLOCK_SIZE;
+    size_t size         = 0;
+    uint32_t *positions = malloc(capacity * sizeof(uint32_t));
+    if(positions == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for the structural index\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    json_index_carry_t carry = {0};
+    for(size_t i = 0; i < length; i += JSON_INDEX_BLOCK_SIZE) {
+        if(size + JSON_INDEX_BLOCK_SIZE > capacity) {
+            size_t new_capacity     = capacity * 2;
+            uint32_t *new_positions = realloc(positions, new_capacity * sizeof(uint32_t));
+            if(new_positions == NULL) {
+                fprintf(stderr, "%s:%s:%d: failed to allocate additional memory for the structural index\n", __FILE__, __func__, __LINE__);
+                free(positions);
+                return NULL;
+            }
+            positions   = new_positions;
+            capacity    = new_capacity;
+        }
+
+        uint64_t entries = json_index_classify_block(data + i, length - i, sets, &carry);
+        while(entries != 0) {
+            positions[size++]   = (uint32_t)(i + (size_t)__builtin_ctzll(entries));
+            entries             &= entries - 1;
+        }
+    }
+
+    if(carry.in_string != 0) {
+        fprintf(stderr, "%s:%s:%d: the document ends inside a string\n", __FILE__, __func__, __LINE__);
+        free(positions);
+        return NULL;
+    }
+
+    *out_length = size;
+    return positions;
+}
@@ -1,10 +1,11 @@
-#include <ctype.h>
-#include <errno.h>
-#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "json/index.h"
 #include "json/lexer.h"
+#include "json/number.h"
+#include "number4c.h"
 
 const char *json_token_type_strings[] = {
     "UNDEFINED",
@@ -20,78 +21,39 @@ const char *json_token_type_strings[] = {
     "NULL"
 };
 
-char *json_lex_string(char **str) {
+bool json_lex_string(string_view_t *output, const char **str) {
     if (**str != JSON_QUOTE) {
-        return NULL;
-    }
-
-    (*str)++; // Move past the initial quote.
-
-    char *start     = *str;
-    char *end_quote = strchr(start, JSON_QUOTE);
-    if (end_quote == NULL) {
-        return NULL; // No ending quote found.
-    }
-
-    size_t length   = end_quote - start;
-    char* output    = calloc(length + 1, sizeof(char));
-    if(output == NULL) {
-        fprintf(stderr, "%s:%s:%d: failed to allocate memory for output\n", __FILE__, __func__, __LINE__);
-        return NULL;
-    }
-
-    strncpy(output, start, length);
-    output[length] = '\0';
-
-    *str += length + 1; // Move past the ending quote.
-
-    return output;
-}
-
-bool json_lex_number(int *output, char **str) {
-    char *start = *str;
-    char *end;
-
-    // Check for negative sign.
-    if(**str == '-') {
-        (*str)++;
-    }
-
-    // Ensure there is at least one digit.
-    // There aren't any digits with an ASCII code lower than the ASCII code of the character '0'.
-    // There aren't any digits with an ASCII code higher than the ASCII code of the character '9'.
-    if(**str < '0' || **str > '9') {
-        *str = start;
         return false;
     }
 
-    // Move past the digits.
-    while(**str >= '0' && **str <= '9') {
-        (*str)++;
+    const char *start   = *str + 1; // Move past the initial quote.
+    const char *end     = start;
+    while(*end != JSON_QUOTE) {
+        if(*end == '\0' || (*end == '\\' && end[1] == '\0')) {
+            return false; // No ending quote found.
+        }
+        end += *end == '\\' ? 2 : 1;
     }
 
-    // Null terminate the number string temporarily for strtol.
-    char temp = **str;
-    **str = '\0';
-
-    // Convert string to long.
-    long number = strtol(start, &end, 10);
-
-    // Restore the character after the number.
-    **str = temp;
+    *output = (string_view_t){ .data = start, .length = end - start };
+    *str    = end + 1; // Move past the ending quote.
+    return true;
+}
 
-    // Check for conversion errors.
-    if(end != *str || errno == ERANGE || number < INT_MIN || number > INT_MAX) {
-        *str = start; // Reset pointer.
+bool json_lex_number(json_number_t *output, const char **str) {
+    // A number can only span these characters, so there is no need to measure the rest of the string.
+    size_t length   = strspn(*str, "0123456789+-.eE");
+    size_t consumed = json_number_parse(*str, length, output);
+    if(consumed == 0) {
         return false;
     }
 
-    *output = (int)number;
+    *str += consumed;
     return true;
 }
 
-bool json_lex_bool(bool *output, char** str) {
-    char *s = *str;
+bool json_lex_bool(bool *output, const char **str) {
+    const char *s = *str;
 
     if(strncmp(s, "true", 4) == 0) {
         *output = true;
@@ -108,107 +70,43 @@ bool json_lex_bool(bool *output, char** str) {
     return false;
 }
 
-bool json_lex_null(char** str) {
-    char *s = *str;
-
-    // Check for NULL and string length to prevent a potential out of bounds error from strncmp.
-    if(s == NULL || strlen(s) < 4) {
+bool json_lex_null(const char **str) {
+    // strncmp stops at the null terminator, so this never reads past the end of the string.
+    if(*str == NULL || strncmp(*str, "null", 4) != 0) {
         return false;
     }
 
-    if(strncmp(s, "null", 4) == 0) {
-        (*str) += 4;
-        return true;
-    }
-
-    return false;
+    (*str) += 4;
+    return true;
 }
 
-json_token_t *json_lex(char *str, size_t *out_length) {
-    char* buffer = strdup(str);
-    if(buffer == NULL) {
-        fprintf(stderr, "%s:%s:%d: failed to duplicate string\n", __FILE__, __func__, __LINE__);
-        return NULL;
-    }
-
-    size_t capacity             = 1024;
-    json_token_t *json_tokens   = calloc(capacity, sizeof(json_token_t));
+json_token_t *json_lex_index(const char *str, const uint32_t *index, size_t index_length, size_t end_offset, size_t *out_length) {
+    // Every token takes at least one entry, and strings take two. The extra token stays zeroed, so the tokens always end
+    // with one whose type is 0, which a parser can stop at instead of reading past the end.
+    json_token_t *json_tokens = calloc(index_length + 1, sizeof(json_token_t));
     if(json_tokens == NULL) {
         fprintf(stderr, "%s:%s:%d: failed to create JSON token array\n", __FILE__, __func__, __LINE__);
-        free(buffer);
         return NULL;
     }
 
-    size_t i    = 0;
-    char *ptr   = buffer;
-
-    while (*ptr != '\0') {
-        // Skip whitespace.
-        while(isspace((unsigned char)*ptr)) {
-            ptr++;
-        }
-
-        if(*ptr == '\0') {
-            break;
-        }
-
-        if(i >= capacity) {
-            size_t new_capacity = capacity * 2;
-            json_token_t *new_tokens = realloc(json_tokens, new_capacity * sizeof(json_token_t));
-            if(new_tokens == NULL) {
-                fprintf(stderr, "%s:%s:%d: failed to allocate additional memory for JSON tokens\n", __FILE__, __func__, __LINE__);
-                free(json_tokens);
-                free(buffer);
-                return NULL;
-            }
-
-            json_tokens = new_tokens;
-            capacity = new_capacity;
-        }
-
-        char *json_string = json_lex_string(&ptr);
-        if (json_string != NULL) {
-            size_t json_string_len = strlen(json_string);
-            json_token_t token = {
-                .type = JSON_TOKEN_TYPE_STRING,
-            };
-            snprintf(token.value.string_value, json_string_len + 1, "%s", json_string);
-            json_tokens[i++] = token;
-            free(json_string);
-            continue;
-        }
-
-        int json_number;
-        if(json_lex_number(&json_number, &ptr)) {
-            json_tokens[i++] = (json_token_t){
-                .type   = JSON_TOKEN_TYPE_NUMBER,
-                .value  = {
-                    .int_value = json_number
-                }
-            };
-            continue;
-        }
+    size_t i = 0;
 
+    for(size_t k = 0; k < index_length; k++) {
+        const char *ptr = str + index[k];
+        json_token_type_t token_type;
+        json_number_t json_number;
         bool json_bool;
-        if(json_lex_bool(&json_bool, &ptr)) {
-            json_tokens[i++] = (json_token_t){
-                .type   = JSON_TOKEN_TYPE_BOOL,
-                .value  = {
-                    .boolean_value = json_bool
-                }
-            };
-            continue;
-        }
-
-        if(json_lex_null(&ptr)) {
-            json_tokens[i++] = (json_token_t){
-                .type = JSON_TOKEN_TYPE_NULL
-            };
-            continue;
-        }
 
-        json_token_type_t token_type;
         switch (*ptr) {
+            case JSON_QUOTE:
+                // The closing quote is always the next entry, since the index only ends outside of a string.
+                json_tokens[i++] = (json_token_t){
+                    .type   = JSON_TOKEN_TYPE_STRING,
+                    .offset = index[k] + 1,
+                    .length = index[k + 1] - index[k] - 1
+                };
+                k++;
+                continue;
             case ',':
                 token_type = JSON_TOKEN_TYPE_COMMA;
                 break;
@@ -228,22 +126,103 @@ json_token_t *json_lex(char *str, size_t *out_length) {
                 token_type = JSON_TOKEN_TYPE_RIGHT_BRACE;
                 break;
             default:
-                fprintf(stderr, "%s:%s:%d: unexpected character encountered: %c\n", __FILE__, __func__, __LINE__, *ptr);
-                free(buffer);
-                free(json_tokens);
-                return NULL;
+                if(json_lex_number(&json_number, &ptr)) {
+                    token_type = JSON_TOKEN_TYPE_NUMBER;
+                }
+                else if(json_lex_bool(&json_bool, &ptr)) {
+                    token_type = JSON_TOKEN_TYPE_BOOL;
+                }
+                else if(json_lex_null(&ptr)) {
+                    token_type = JSON_TOKEN_TYPE_NULL;
+                }
+                else {
+                    token_type = JSON_TOKEN_TYPE_UNDEFINED;
+                }
+
+                // Nothing but whitespace may lie between the end of a number or literal and the next entry.
+                const char *end = ptr;
+                while(json_is_space(*end)) {
+                    end++;
+                }
+                if(token_type == JSON_TOKEN_TYPE_UNDEFINED || (size_t)(end - str) != (k + 1 < index_length ? index[k + 1] : end_offset)) {
+                    fprintf(stderr, "%s:%s:%d: unexpected character encountered: %c\n", __FILE__, __func__, __LINE__, token_type == JSON_TOKEN_TYPE_UNDEFINED ? *ptr : *end);
+                    free(json_tokens);
+                    return NULL;
+                }
+
+                json_tokens[i++] = (json_token_t){
+                    .type   = token_type,
+                    .offset = index[k],
+                    .length = (uint32_t)(ptr - str - index[k])
+                };
+                continue;
         }
 
-        json_token_t token = {
-            .type = token_type,
+        json_tokens[i++] = (json_token_t){
+            .type   = token_type,
+            .offset = index[k],
+            .length = 1
         };
-        token.value.string_value[0] = *ptr;
-        token.value.string_value[1] = '\0';
-        json_tokens[i++] = token;
-        ptr++;
     }
 
-    free(buffer);
     *out_length = i;
     return json_tokens;
 }
+
+json_token_t *json_lex(const char *str, size_t *out_length) {
+    // The index holds every position a token starts at, so the lexer jumps from one to the next instead of stepping
+    // over whitespace and the contents of strings.
+    size_t length       = strlen(str);
+    size_t index_length = 0;
+    uint32_t *index     = json_index_build(str, length, &index_length);
+    if(index == NULL) {
+        return NULL;
+    }
+
+    json_token_t *json_tokens = json_lex_index(str, index, index_length, length, out_length);
+    free(index);
+    return json_tokens;
+}
+
+string_view_t json_token_get_view(const char *str, const json_token_t *token) {
+    return (string_view_t){ .data = str + token->offset, .length = token->length };
+}
+
+bool json_token_get_int(const char *str, const json_token_t *token, int *output) {
+    int32_t number;
+    if(token->type != JSON_TOKEN_TYPE_NUMBER || number_parse_i32(str + token->offset, token->length, &number) != token->length) {
+        return false;
+    }
+
+    *output = number;
+    return true;
+}
+
+bool json_token_get_number(const char *str, const json_token_t *token, json_number_t *output) {
+    return token->type == JSON_TOKEN_TYPE_NUMBER && json_number_parse(str + token->offset, token->length, output) == token->length;
+}
+
+bool json_token_get_bool(const char *str, const json_token_t *token, bool *output) {
+    if(token->type != JSON_TOKEN_TYPE_BOOL) {
+        return false;
+    }
+
+    *output = str[token->offset] == 't';
+    return true;
+}
+
+char *json_token_get_string(const char *str, const json_token_t *token) {
+    if(token->type != JSON_TOKEN_TYPE_STRING) {
+        return NULL;
+    }
+
+    char *output = malloc(token->length + 1);
+    if(output == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for output\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    memcpy(output, str + token->offset, token->length);
+    output[token->length] = '\0';
+    return output;
+}
@@ -0,0 +1,34 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "ctype4c.h"
+#include "json/number.h"
+#include "number4c.h"
+
+size_t json_number_parse(const char *data, size_t length, json_number_t *out_number) {
+    size_t sign_length = length > 0 && data[0] == '-' ? 1 : 0;
+    if(sign_length == length || !ctype_is_digit(data[sign_length])) {
+        return 0;
+    }
+    if(data[sign_length] == '0' && sign_length + 1 < length && ctype_is_digit(data[sign_length + 1])) {
+        return 0;
+    }
+
+    int64_t integer;
+    size_t consumed = number_parse_i64(data, length, &integer);
+    if(consumed > 0 && (consumed == length || (data[consumed] != '.' && data[consumed] != 'e' && data[consumed] != 'E'))) {
+        out_number->type        = JSON_NUMBER_TYPE_INTEGER;
+        out_number->as.integer  = integer;
+        return consumed;
+    }
+
+    // A fraction, an exponent, or an integer that overflowed.
+    double real;
+    consumed = number_parse_f64(data, length, &real);
+    if(consumed == 0) {
+        return 0;
+    }
+    out_number->type    = JSON_NUMBER_TYPE_DOUBLE;
+    out_number->as.real = real;
+    return consumed;
+}
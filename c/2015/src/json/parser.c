@@ -1,46 +1,81 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include "fnv.h"
+#include "json/key_index.h"
 #include "json/lexer.h"
 #include "json/parser.h"
 
-static void json_array_destroy(json_array_t *array) {
-    for(size_t i = 0; i < array->size; i++) {
-        json_node_destroy(array->nodes[i]);
+static bool json_parse_grow(void **items, size_t *capacity, size_t item_size) {
+    size_t new_capacity = *capacity == 0 ? 64 : *capacity * 2;
+    void *new_items     = realloc(*items, new_capacity * item_size);
+    if(new_items == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate additional memory for the parser stack\n", __FILE__, __func__, __LINE__);
+        return false;
     }
-    free(array->nodes);
-    free(array);
+    *items      = new_items;
+    *capacity   = new_capacity;
+    return true;
 }
 
-static void json_object_destroy(json_object_t *object) {
-    for(size_t i = 0; i < object->size; i++) {
-        json_object_entry_t *entry = object->entries[i];
-        json_node_destroy(entry->value);
-        free(entry->key);
-        free(entry);
+static void json_node_free_scalar(json_node_t *node) {
+    if(node->type == JSON_NODE_TYPE_STRING || node->type == JSON_NODE_TYPE_NUMBER || node->type == JSON_NODE_TYPE_BOOL) {
+        free(node->value);
     }
-    free(object->entries);
-    free(object);
+    free(node);
 }
 
 void json_node_destroy(json_node_t *node) {
-    switch(node->type) {
-        case JSON_NODE_TYPE_ARRAY:
-            json_array_destroy((json_array_t*)node->value);
-        break;
-        case JSON_NODE_TYPE_OBJECT:
-            json_object_destroy((json_object_t*)node->value);
-        break;
-        case JSON_NODE_TYPE_STRING:
-        case JSON_NODE_TYPE_NUMBER:
-        case JSON_NODE_TYPE_BOOL:
-            free(node->value);
-        break;
-        case JSON_NODE_TYPE_UNDEFINED: // Nothing to do here.
-        break;
+    // Containers still to be freed are kept on a stack of their own rather than the C stack, so a document can be nested
+    // as deeply as it could be parsed.
+    json_node_t **pending   = NULL;
+    size_t size             = 0;
+    size_t capacity         = 0;
+
+    while(node != NULL) {
+        if(node->type == JSON_NODE_TYPE_ARRAY) {
+            json_array_t *array = node->value;
+            for(size_t i = 0; i < array->size; i++) {
+                json_node_t *child = array->nodes[i];
+                if(child->type != JSON_NODE_TYPE_ARRAY && child->type != JSON_NODE_TYPE_OBJECT) {
+                    json_node_free_scalar(child);
+                }
+                else if(size < capacity || json_parse_grow((void **)&pending, &capacity, sizeof(json_node_t *))) {
+                    pending[size++] = child;
+                }
+            }
+            free(array->nodes);
+            free(array);
+        }
+        else if(node->type == JSON_NODE_TYPE_OBJECT) {
+            json_object_t *object = node->value;
+            for(size_t i = 0; i < object->size; i++) {
+                json_object_entry_t *entry  = object->entries[i];
+                json_node_t *child          = entry->value;
+                if(child->type != JSON_NODE_TYPE_ARRAY && child->type != JSON_NODE_TYPE_OBJECT) {
+                    json_node_free_scalar(child);
+                }
+                else if(size < capacity || json_parse_grow((void **)&pending, &capacity, sizeof(json_node_t *))) {
+                    pending[size++] = child;
+                }
+                free(entry->key);
+                free(entry);
+            }
+            free(object->entries);
+            free(object->index);
+            free(object);
+        }
+        else {
+            json_node_free_scalar(node);
+            node = size > 0 ? pending[--size] : NULL;
+            continue;
+        }
+
+        free(node);
+        node = size > 0 ? pending[--size] : NULL;
     }
 
-    free(node);
+    free(pending);
 }
 
 static void json_array_add(json_array_t *array, json_node_t *node) {
@@ -71,188 +106,315 @@ static void json_object_add(json_object_t *object, char *key, json_node_t *node)
     }
 
     json_object_entry_t *entry = malloc(sizeof(json_object_entry_t));
-    entry->key = strdup(key);
+    entry->key = key;
     entry->value = node;
 
     object->entries[object->size++] = entry;
+
+    // Keep an existing index in step, or drop it to be rebuilt at the next lookup once it is half full.
+    if(object->index != NULL) {
+        if(2 * object->size > object->index_capacity) {
+            free(object->index);
+            object->index = NULL;
+        }
+        else {
+            json_key_index_insert(object->index, object->index_capacity, fnv1a_bytes(key, strlen(key)), (uint32_t)(object->size - 1));
+        }
+    }
+}
+
+static bool json_object_build_index(json_object_t *object) {
+    size_t capacity = json_key_index_capacity(object->size);
+    uint32_t *index = calloc(capacity, sizeof(uint32_t));
+    if(index == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for the object index\n", __FILE__, __func__, __LINE__);
+        return false;
+    }
+
+    for(size_t i = 0; i < object->size; i++) {
+        const char *key = object->entries[i]->key;
+        json_key_index_insert(index, capacity, fnv1a_bytes(key, strlen(key)), (uint32_t)i);
+    }
+
+    free(object->index);
+    object->index           = index;
+    object->index_capacity  = capacity;
+    return true;
 }
 
 json_node_t *json_object_get(json_object_t *object, char *key) {
+    if(object->size >= JSON_KEY_INDEX_THRESHOLD && (object->index != NULL || json_object_build_index(object))) {
+        size_t mask = object->index_capacity - 1;
+        for(size_t slot = fnv1a_bytes(key, strlen(key)) & mask; object->index[slot] != 0; slot = (slot + 1) & mask) {
+            json_object_entry_t *entry = object->entries[object->index[slot] - 1];
+            if(strcmp(key, entry->key) == 0) {
+                return entry->value;
+            }
+        }
+        return NULL;
+    }
+
     for(size_t i = 0; i < object->size; i++) {
         if(strcmp(key, object->entries[i]->key) == 0) {
-            #ifndef NDEBUG
-            printf("%s:%s:%d: found object entry by key %s at index %zu\n", __FILE__, __func__, __LINE__, key, i);
-            #endif
             return object->entries[i]->value;
         }
     }
-    #ifndef NDEBUG
-    printf("%s:%s:%d: no object entry with key %s was found\n", __FILE__, __func__, __LINE__, key);
-    #endif
     return NULL;
 }
 
-json_node_t *json_parse(json_token_t *tokens, size_t *current_token_index, bool is_root) {
-    if (is_root && (tokens[*current_token_index].type != JSON_TOKEN_TYPE_LEFT_BRACE && tokens[*current_token_index].type != JSON_TOKEN_TYPE_LEFT_BRACKET)) {
-        fprintf(stderr, "%s:%s:%d: expected array or object, but the first token was neither a left bracket nor a left brace (token_type = %d/%s)\n", __FILE__, __func__, __LINE__, tokens[*current_token_index].type, json_token_type_strings[tokens[*current_token_index].type]);
-        return NULL;
-    }
+typedef enum json_parse_state_t {
+    JSON_PARSE_STATE_VALUE,         // A value must follow.
+    JSON_PARSE_STATE_KEY,           // An object key and a colon must follow.
+    JSON_PARSE_STATE_AFTER_VALUE    // A comma or the end of the enclosing container must follow.
+} json_parse_state_t;
+
+// An open array or object, together with the key of the member whose value is being parsed.
+typedef struct json_parse_frame_t {
+    json_node_t *node;
+    char        *key;
+} json_parse_frame_t;
 
+static json_node_t *json_node_create(json_node_type_t type, void *value) {
     json_node_t *node = malloc(sizeof(json_node_t));
-    node->type = JSON_NODE_TYPE_UNDEFINED;
-    node->value = NULL;
-    void *temp = NULL;
-
-    switch(tokens[*current_token_index].type) {
-        case JSON_TOKEN_TYPE_LEFT_BRACKET:
-            node->type = JSON_NODE_TYPE_ARRAY;
-            node->value = json_parse_array(tokens, current_token_index);
-        break;
-        case JSON_TOKEN_TYPE_LEFT_BRACE:
-            node->type = JSON_NODE_TYPE_OBJECT;
-            node->value = json_parse_object(tokens, current_token_index);
-        break;
-        case JSON_TOKEN_TYPE_STRING:
-            node->type = JSON_NODE_TYPE_STRING;
-            size_t len = strlen(tokens[*current_token_index].value.string_value);
-            temp = malloc(len + 1);
-            strncpy(temp, tokens[*current_token_index].value.string_value, len);
-            ((char*)temp)[len] = '\0';
-            node->value = temp;
-        break;
-        case JSON_TOKEN_TYPE_NUMBER:
-            node->type  = JSON_NODE_TYPE_NUMBER;
-            temp        = malloc(sizeof(int));
-            *(int*)temp = tokens[*current_token_index].value.int_value;
-            node->value = temp;
-        break;
-        case JSON_TOKEN_TYPE_BOOL:
-            node->type      = JSON_NODE_TYPE_BOOL;
-            temp            = malloc(sizeof(bool));
-            *(bool*)temp    = tokens[*current_token_index].value.boolean_value;
-            node->value     = temp;
-        break;
-        default: // No handling necessary for remaining token types.
-        break;
+    if(node == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for a node\n", __FILE__, __func__, __LINE__);
+        free(value);
+        return NULL;
     }
-
-    (*current_token_index)++;
-
+    node->type  = type;
+    node->value = value;
     return node;
 }
 
-json_array_t *json_parse_array(json_token_t *tokens, size_t *current_token_index) {
-    if(tokens[*current_token_index].type != JSON_TOKEN_TYPE_LEFT_BRACKET) {
-        fprintf(stderr, "%s:%s:%d: the first token should be a left bracket when dealing with an array.\n", __FILE__, __func__, __LINE__);
-        return NULL;
+static json_node_t *json_node_create_container(json_node_type_t type) {
+    void *value = NULL;
+    if(type == JSON_NODE_TYPE_ARRAY) {
+        json_array_t *array = malloc(sizeof(json_array_t));
+        if(array != NULL) {
+            array->capacity = 10;
+            array->size     = 0;
+            array->nodes    = calloc(array->capacity, sizeof(json_node_t*));
+        }
+        value = array;
+    }
+    else {
+        json_object_t *object = malloc(sizeof(json_object_t));
+        if(object != NULL) {
+            object->capacity        = 10;
+            object->size            = 0;
+            object->entries         = calloc(object->capacity, sizeof(json_object_entry_t*));
+            object->index           = NULL;
+            object->index_capacity  = 0;
+        }
+        value = object;
     }
+    return value != NULL ? json_node_create(type, value) : NULL;
+}
 
-    (*current_token_index)++; // Move past the left bracket.
+static json_node_t *json_node_create_scalar(const char *str, const json_token_t *token) {
+    void *value = NULL;
 
-    json_array_t *array = malloc(sizeof(json_array_t));
-    array->capacity = 10;
-    array->size = 0;
-    array->nodes = calloc(array->capacity, sizeof(json_node_t*));
+    switch(token->type) {
+        case JSON_TOKEN_TYPE_STRING:
+            value = json_token_get_string(str, token);
+            return value != NULL ? json_node_create(JSON_NODE_TYPE_STRING, value) : NULL;
+        case JSON_TOKEN_TYPE_NUMBER:
+            value = malloc(sizeof(json_number_t));
+            if(value == NULL) {
+                return NULL;
+            }
+            json_token_get_number(str, token, value);
+            return json_node_create(JSON_NODE_TYPE_NUMBER, value);
+        case JSON_TOKEN_TYPE_BOOL:
+            value = malloc(sizeof(bool));
+            if(value == NULL) {
+                return NULL;
+            }
+            json_token_get_bool(str, token, value);
+            return json_node_create(JSON_NODE_TYPE_BOOL, value);
+        default: // Null has no value.
+            return json_node_create(JSON_NODE_TYPE_UNDEFINED, NULL);
+    }
+}
 
-    while(true) {
-        if(tokens[*current_token_index].type == JSON_TOKEN_TYPE_RIGHT_BRACKET) {
-            return array;
+/**
+ * json_parse_tokens: Parse one value and everything nested in it. Open containers are kept on a heap allocated stack, so
+ * the depth of a document is limited by memory rather than by the C stack. Every node is attached to its parent as soon
+ * as it is created, which leaves a well formed tree to destroy if a later token turns out to be malformed.
+ */
+static json_node_t *json_parse_tokens(const char *str, const json_token_t *tokens, size_t *current_token_index, size_t *out_max_depth) {
+    json_parse_frame_t *frames  = NULL;
+    size_t depth                = 0;
+    size_t max_depth            = 0;
+    size_t capacity             = 0;
+    json_node_t *root           = NULL;
+    json_parse_state_t state    = JSON_PARSE_STATE_VALUE;
+    size_t i                    = *current_token_index;
+
+    while(state != JSON_PARSE_STATE_AFTER_VALUE || depth > 0) {
+        const json_token_t *token = &tokens[i];
+        if(token->type == 0) {
+            fprintf(stderr, "%s:%s:%d: unexpected end of tokens\n", __FILE__, __func__, __LINE__);
+            goto error;
         }
 
-        json_node_t *node = json_parse(tokens, current_token_index, false);
-        json_array_add(array, node);
+        if(state == JSON_PARSE_STATE_KEY) {
+            if(token->type != JSON_TOKEN_TYPE_STRING || tokens[i + 1].type != JSON_TOKEN_TYPE_COLON) {
+                fprintf(stderr, "%s:%s:%d: expected a key and a colon at offset %u\n", __FILE__, __func__, __LINE__, token->offset);
+                goto error;
+            }
+            frames[depth - 1].key = json_token_get_string(str, token);
+            if(frames[depth - 1].key == NULL) {
+                goto error;
+            }
+            i += 2; // Move past the key and the colon.
+            state = JSON_PARSE_STATE_VALUE;
+            continue;
+        }
 
-        if (tokens[*current_token_index].type == JSON_TOKEN_TYPE_RIGHT_BRACKET) {
-            return array;
+        if(state == JSON_PARSE_STATE_AFTER_VALUE) {
+            json_node_type_t type = frames[depth - 1].node->type;
+            if(token->type == JSON_TOKEN_TYPE_COMMA) {
+                state = type == JSON_NODE_TYPE_OBJECT ? JSON_PARSE_STATE_KEY : JSON_PARSE_STATE_VALUE;
+            }
+            else if(token->type == (type == JSON_NODE_TYPE_OBJECT ? JSON_TOKEN_TYPE_RIGHT_BRACE : JSON_TOKEN_TYPE_RIGHT_BRACKET)) {
+                depth--;
+            }
+            else {
+                fprintf(stderr, "%s:%s:%d: expected a comma or the end of the container at offset %u, but got %s\n", __FILE__, __func__, __LINE__, token->offset, json_token_type_strings[token->type - 1]);
+                goto error;
+            }
+            i++;
+            continue;
         }
 
-        if (tokens[*current_token_index].type != JSON_TOKEN_TYPE_COMMA) {
-            fprintf(stderr, "%s:%s:%d: expected comma after object in array, but the current token is %s\n", __FILE__, __func__, __LINE__, json_token_type_strings[tokens[*current_token_index].type]);
-            return NULL;
+        json_node_t *node = NULL;
+        switch(token->type) {
+            case JSON_TOKEN_TYPE_LEFT_BRACE:
+            case JSON_TOKEN_TYPE_LEFT_BRACKET:
+                node = json_node_create_container(token->type == JSON_TOKEN_TYPE_LEFT_BRACE ? JSON_NODE_TYPE_OBJECT : JSON_NODE_TYPE_ARRAY);
+                break;
+            case JSON_TOKEN_TYPE_STRING:
+            case JSON_TOKEN_TYPE_NUMBER:
+            case JSON_TOKEN_TYPE_BOOL:
+            case JSON_TOKEN_TYPE_NULL:
+                node = json_node_create_scalar(str, token);
+                break;
+            default:
+                fprintf(stderr, "%s:%s:%d: expected a value at offset %u, but got %s\n", __FILE__, __func__, __LINE__, token->offset, json_token_type_strings[token->type - 1]);
+                goto error;
+        }
+        if(node == NULL) {
+            goto error;
         }
 
-        (*current_token_index)++; // Move past the comma.
+        if(depth == 0) {
+            root = node;
+        }
+        else if(frames[depth - 1].node->type == JSON_NODE_TYPE_ARRAY) {
+            json_array_add(frames[depth - 1].node->value, node);
+        }
+        else {
+            json_object_add(frames[depth - 1].node->value, frames[depth - 1].key, node);
+            frames[depth - 1].key = NULL;
+        }
+        i++;
+        state = JSON_PARSE_STATE_AFTER_VALUE;
+
+        if(node->type == JSON_NODE_TYPE_ARRAY || node->type == JSON_NODE_TYPE_OBJECT) {
+            if(depth == capacity && !json_parse_grow((void **)&frames, &capacity, sizeof(json_parse_frame_t))) {
+                goto error;
+            }
+            frames[depth++] = (json_parse_frame_t){ .node = node, .key = NULL };
+            max_depth       = depth > max_depth ? depth : max_depth;
+
+            // The end of an empty container is handled as if it followed a value.
+            if(tokens[i].type != JSON_TOKEN_TYPE_RIGHT_BRACE && tokens[i].type != JSON_TOKEN_TYPE_RIGHT_BRACKET) {
+                state = node->type == JSON_NODE_TYPE_OBJECT ? JSON_PARSE_STATE_KEY : JSON_PARSE_STATE_VALUE;
+            }
+        }
     }
 
-    fprintf(stderr, "%s:%s:%d: expected end of array, but the current token type is %d\n", __FILE__, __func__, __LINE__, tokens[*current_token_index].type);
-
-    for(size_t i = 0; i < array->size; i++) {
-        free(array[i].nodes[i]->value);
+    free(frames);
+    *current_token_index = i;
+    if(out_max_depth != NULL) {
+        *out_max_depth = max_depth;
     }
-    free(array->nodes);
-    free(array);
+    return root;
 
+error:
+    if(depth > 0) {
+        free(frames[depth - 1].key);
+    }
+    free(frames);
+    if(root != NULL) {
+        json_node_destroy(root);
+    }
     return NULL;
 }
 
-json_object_t *json_parse_object(json_token_t *tokens, size_t *current_token_index) {
-    if(tokens[*current_token_index].type != JSON_TOKEN_TYPE_LEFT_BRACE) {
-        fprintf(stderr, "%s:%s:%d: the first token should be a left brace when dealing with an object\n", __FILE__, __func__, __LINE__);
+json_node_t *json_parse(const char *str, json_token_t *tokens, size_t *current_token_index, bool is_root) {
+    if (is_root && (tokens[*current_token_index].type != JSON_TOKEN_TYPE_LEFT_BRACE && tokens[*current_token_index].type != JSON_TOKEN_TYPE_LEFT_BRACKET)) {
+        fprintf(stderr, "%s:%s:%d: expected array or object, but the first token was neither a left bracket nor a left brace (token_type = %d/%s)\n", __FILE__, __func__, __LINE__, tokens[*current_token_index].type, json_token_type_strings[tokens[*current_token_index].type]);
         return NULL;
     }
 
-    (*current_token_index)++; // Move past the left brace.
-
-    json_object_t *object = malloc(sizeof(json_object_t));
-    object->capacity = 10;
-    object->size = 0;
-    object->entries = calloc(object->capacity, sizeof(json_object_entry_t*));
-
-    while(true) {
-        if(tokens[*current_token_index].type == JSON_TOKEN_TYPE_RIGHT_BRACE) { // Are we done?
-            return object;
-        }
-
-        json_token_type_t json_key_type = tokens[*current_token_index].type;
-        char *json_key_string_value     = tokens[*current_token_index].value.string_value;
-        if(json_key_type != JSON_TOKEN_TYPE_STRING) {
-            printf("Expected string key, but got %d (value: %s)\n", json_key_type, json_key_string_value);
-            return NULL;
-        }
-
-        if(json_key_string_value == NULL) {
-            printf("The string key is NULL.\n");
-            return NULL;
-        }
-
-        (*current_token_index)++; // Move past the key.
-        char *token_string_value = tokens[*current_token_index].value.string_value;
-
-        if(tokens[*current_token_index].type != JSON_TOKEN_TYPE_COLON) { // Is there a colon?
-            fprintf(stderr, "%s:%s:%d: expected colon, but got %d (value: %s)\n", __FILE__, __func__, __LINE__, tokens[*current_token_index].type, token_string_value);
-            return NULL;
-        }
-
-        (*current_token_index)++; // Move past the colon.
-
-        // We should be at the value now. Parse it.
-        json_node_t *node = json_parse(tokens, current_token_index, false);
-        json_object_add(object, json_key_string_value, node);
-
-        // Are we done?
-        if (tokens[*current_token_index].type == JSON_TOKEN_TYPE_RIGHT_BRACE) {
-            return object;
-        }
+    return json_parse_tokens(str, tokens, current_token_index, NULL);
+}
 
-        if (tokens[*current_token_index].type != JSON_TOKEN_TYPE_COMMA) {
-            fprintf(stderr, "%s:%s:%d: expected comma after pair in object, but got %d\n", __FILE__, __func__, __LINE__, tokens[*current_token_index].type);
-            json_object_destroy(object);
-            return NULL;
-        }
+/**
+ * json_parse_container: Parse an array or an object and hand out its value without the node around it.
+ */
+static void *json_parse_container(const char *str, json_token_t *tokens, size_t *current_token_index, json_token_type_t expected_type) {
+    if(tokens[*current_token_index].type != expected_type) {
+        fprintf(stderr, "%s:%s:%d: expected %s, but got %s\n", __FILE__, __func__, __LINE__, json_token_type_strings[expected_type - 1], json_token_type_strings[tokens[*current_token_index].type - 1]);
+        return NULL;
+    }
 
-        (*current_token_index)++; // Move past the comma.
+    json_node_t *node = json_parse_tokens(str, tokens, current_token_index, NULL);
+    if(node == NULL) {
+        return NULL;
     }
+    void *value = node->value;
+    free(node);
+    return value;
+}
 
-    fprintf(stderr, "%s:%s:%d: expected end of object\n", __FILE__, __func__, __LINE__);
-    return NULL;
+json_array_t *json_parse_array(const char *str, json_token_t *tokens, size_t *current_token_index) {
+    return json_parse_container(str, tokens, current_token_index, JSON_TOKEN_TYPE_LEFT_BRACKET);
+}
+
+json_object_t *json_parse_object(const char *str, json_token_t *tokens, size_t *current_token_index) {
+    return json_parse_container(str, tokens, current_token_index, JSON_TOKEN_TYPE_LEFT_BRACE);
 }
 
-json_node_t *json_parse_string(char *str) {
+json_node_t *json_parse_string_with_depth(const char *str, size_t *out_max_depth) {
     size_t length = 0;
     json_token_t *tokens = json_lex(str, &length);
+    if(tokens == NULL) {
+        return NULL;
+    }
+
     size_t current_token_index = 0;
-    json_node_t *node = json_parse(tokens, &current_token_index, true);
-    
+    json_node_t *node = NULL;
+    if(tokens[0].type != JSON_TOKEN_TYPE_LEFT_BRACE && tokens[0].type != JSON_TOKEN_TYPE_LEFT_BRACKET) {
+        fprintf(stderr, "%s:%s:%d: expected array or object at the root\n", __FILE__, __func__, __LINE__);
+    }
+    else {
+        node = json_parse_tokens(str, tokens, &current_token_index, out_max_depth);
+    }
+
+    // The root has to be the whole document. The tokens end with one whose type is 0, so anything else is left over.
+    if(node != NULL && tokens[current_token_index].type != 0) {
+        fprintf(stderr, "%s:%s:%d: unexpected %s after the root at offset %u\n", __FILE__, __func__, __LINE__, json_token_type_strings[tokens[current_token_index].type - 1], tokens[current_token_index].offset);
+        json_node_destroy(node);
+        node = NULL;
+    }
+
     free(tokens);
     return node;
 }
+
+json_node_t *json_parse_string(const char *str) {
+    return json_parse_string_with_depth(str, NULL);
+}
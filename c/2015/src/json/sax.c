@@ -0,0 +1,193 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ctype4c.h"
+#include "json/index.h"
+#include "json/number.h"
+#include "json/sax.h"
+#include "simd4c.h"
+
+// Documents nested deeper than this spill the container stack from the C stack to the heap.
+#define JSON_SAX_INLINE_DEPTH 64
+
+typedef enum json_sax_state_t {
+    JSON_SAX_STATE_VALUE,       // A value must follow.
+    JSON_SAX_STATE_KEY,         // An object key must follow.
+    JSON_SAX_STATE_AFTER_VALUE  // A comma, the end of the enclosing container or the end of the document must follow.
+} json_sax_state_t;
+
+typedef struct json_sax_stack_t {
+    char    inline_containers[JSON_SAX_INLINE_DEPTH];
+    char    *containers;        // The opening bracket or brace of every open container, innermost last.
+    size_t  depth;
+    size_t  capacity;
+} json_sax_stack_t;
+
+static bool json_sax_push(json_sax_stack_t *stack, char container) {
+    if(stack->depth == stack->capacity) {
+        size_t new_capacity = stack->capacity * 2;
+        char *new_containers = stack->containers == stack->inline_containers ? malloc(new_capacity) : realloc(stack->containers, new_capacity);
+        if(new_containers == NULL) {
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for %zu levels of nesting\n", __FILE__, __func__, __LINE__, new_capacity);
+            return false;
+        }
+        if(stack->containers == stack->inline_containers) {
+            memcpy(new_containers, stack->inline_containers, stack->depth);
+        }
+        stack->containers   = new_containers;
+        stack->capacity     = new_capacity;
+    }
+
+    stack->containers[stack->depth++] = container;
+    return true;
+}
+
+static inline size_t json_sax_skip_space(const char *data, size_t length, size_t i) {
+    while(i < length && json_is_space(data[i])) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * json_sax_scan_string: Find the closing quote of the string whose opening quote is at data[i].
+ * @return The index of the closing quote, or length if the string is unterminated.
+ */
+static size_t json_sax_scan_string(const char *data, size_t length, size_t i) {
+    i++;
+    while(i < length) {
+        i += simd_find_any(data + i, length - i, "\"\\", 2);
+        if(i >= length || data[i] == '"') {
+            return i;
+        }
+        i += 2; // Step over the backslash and the byte it escapes.
+    }
+    return length;
+}
+
+static bool json_sax_match_literal(const char *data, size_t length, size_t i, const char *literal, size_t literal_length) {
+    return length - i >= literal_length && memcmp(data + i, literal, literal_length) == 0;
+}
+
+bool json_sax_parse(const char *data, size_t length, const json_sax_handler_t *handler, void *context) {
+    json_sax_stack_t stack  = { .depth = 0, .capacity = JSON_SAX_INLINE_DEPTH };
+    stack.containers        = stack.inline_containers;
+    json_sax_state_t state  = JSON_SAX_STATE_VALUE;
+    bool keep_going         = true;
+    size_t i                = json_sax_skip_space(data, length, 0);
+
+    while(keep_going) {
+        if(i >= length) {
+            if(state != JSON_SAX_STATE_AFTER_VALUE || stack.depth > 0) {
+                fprintf(stderr, "%s:%s:%d: unexpected end of document\n", __FILE__, __func__, __LINE__);
+                keep_going = false;
+            }
+            break;
+        }
+
+        char c = data[i];
+
+        if(state == JSON_SAX_STATE_KEY) {
+            size_t end = c == '"' ? json_sax_scan_string(data, length, i) : length;
+            if(end >= length) {
+                fprintf(stderr, "%s:%s:%d: expected a key at index %zu\n", __FILE__, __func__, __LINE__, i);
+                keep_going = false;
+                break;
+            }
+            string_view_t key = { .data = data + i + 1, .length = end - i - 1 };
+            i = json_sax_skip_space(data, length, end + 1);
+            if(i >= length || data[i] != ':') {
+                fprintf(stderr, "%s:%s:%d: expected a colon after the key \"%.*s\"\n", __FILE__, __func__, __LINE__, (int)key.length, key.data);
+                keep_going = false;
+                break;
+            }
+            keep_going  = handler->on_key == NULL || handler->on_key(key, context);
+            i           = json_sax_skip_space(data, length, i + 1);
+            state       = JSON_SAX_STATE_VALUE;
+            continue;
+        }
+
+        if(state == JSON_SAX_STATE_AFTER_VALUE) {
+            char container = stack.depth > 0 ? stack.containers[stack.depth - 1] : '\0';
+            if(container == '\0') {
+                fprintf(stderr, "%s:%s:%d: unexpected '%c' after the document at index %zu\n", __FILE__, __func__, __LINE__, c, i);
+                keep_going = false;
+            }
+            else if(c == ',') {
+                i       = json_sax_skip_space(data, length, i + 1);
+                state   = container == '{' ? JSON_SAX_STATE_KEY : JSON_SAX_STATE_VALUE;
+            }
+            else if((c == '}' && container == '{') || (c == ']' && container == '[')) {
+                stack.depth--;
+                i           = json_sax_skip_space(data, length, i + 1);
+                keep_going  = c == '}'
+                    ? handler->on_object_end == NULL || handler->on_object_end(context)
+                    : handler->on_array_end == NULL || handler->on_array_end(context);
+            }
+            else {
+                fprintf(stderr, "%s:%s:%d: expected a comma or the end of the %s at index %zu, but got '%c'\n", __FILE__, __func__, __LINE__, container == '{' ? "object" : "array", i, c);
+                keep_going = false;
+            }
+            continue;
+        }
+
+        // A value follows.
+        state = JSON_SAX_STATE_AFTER_VALUE;
+
+        if(c == '{' || c == '[') {
+            keep_going = json_sax_push(&stack, c) && (c == '{'
+                ? handler->on_object_start == NULL || handler->on_object_start(context)
+                : handler->on_array_start == NULL || handler->on_array_start(context));
+
+            // The end of an empty container is handled as if it followed a value.
+            i = json_sax_skip_space(data, length, i + 1);
+            if(i >= length || data[i] != (c == '{' ? '}' : ']')) {
+                state = c == '{' ? JSON_SAX_STATE_KEY : JSON_SAX_STATE_VALUE;
+            }
+        }
+        else if(c == '"') {
+            size_t end = json_sax_scan_string(data, length, i);
+            if(end >= length) {
+                fprintf(stderr, "%s:%s:%d: unterminated string at index %zu\n", __FILE__, __func__, __LINE__, i);
+                keep_going = false;
+                break;
+            }
+            string_view_t value = { .data = data + i + 1, .length = end - i - 1 };
+            keep_going          = handler->on_string == NULL || handler->on_string(value, context);
+            i                   = json_sax_skip_space(data, length, end + 1);
+        }
+        else if(c == '-' || ctype_is_digit(c)) {
+            json_number_t value;
+            size_t consumed = json_number_parse(data + i, length - i, &value);
+            if(consumed == 0) {
+                fprintf(stderr, "%s:%s:%d: expected a number at index %zu\n", __FILE__, __func__, __LINE__, i);
+                keep_going = false;
+                break;
+            }
+            keep_going  = value.type == JSON_NUMBER_TYPE_INTEGER
+                ? handler->on_number == NULL || handler->on_number(value.as.integer, context)
+                : handler->on_double == NULL || handler->on_double(value.as.real, context);
+            i           = json_sax_skip_space(data, length, i + consumed);
+        }
+        else if(json_sax_match_literal(data, length, i, "true", 4) || json_sax_match_literal(data, length, i, "false", 5)) {
+            bool value  = c == 't';
+            keep_going  = handler->on_bool == NULL || handler->on_bool(value, context);
+            i           = json_sax_skip_space(data, length, i + (value ? 4 : 5));
+        }
+        else if(json_sax_match_literal(data, length, i, "null", 4)) {
+            keep_going  = handler->on_null == NULL || handler->on_null(context);
+            i           = json_sax_skip_space(data, length, i + 4);
+        }
+        else {
+            fprintf(stderr, "%s:%s:%d: unexpected character '%c' at index %zu\n", __FILE__, __func__, __LINE__, c, i);
+            keep_going = false;
+        }
+    }
+
+    if(stack.containers != stack.inline_containers) {
+        free(stack.containers);
+    }
+    return keep_going;
+}
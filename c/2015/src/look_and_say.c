@@ -0,0 +1,270 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "look_and_say.h"
+
+// Terms with fewer runs than this are stepped on the calling thread, since starting threads would cost more.
+#define LOOK_AND_SAY_MIN_RUNS_PER_THREAD 65536
+
+#define LOOK_AND_SAY_RUN(count, digit)  ((uint8_t)(((count) << 4) | (digit)))
+#define LOOK_AND_SAY_COUNT(run)         ((run) >> 4)
+#define LOOK_AND_SAY_DIGIT(run)         ((run) & 0x0F)
+
+struct look_and_say_t {
+    uint8_t *runs;
+    size_t  number_of_runs;
+    size_t  runs_capacity;
+    uint8_t *next_runs;         // Scratch space for the next term, swapped with runs after every step.
+    size_t  next_runs_capacity;
+    size_t  length;
+    size_t  number_of_threads;
+};
+
+typedef struct look_and_say_chunk_t {
+    const uint8_t   *input;
+    size_t          input_length;
+    uint8_t         *output;
+    size_t          output_length;
+    size_t          length;     // The number of digits the output runs expand to.
+    bool            overflowed;
+} look_and_say_chunk_t;
+
+/**
+ * look_and_say_emit: Append a digit to a term under construction, extending the last run when it holds the same digit.
+ * @return False if the run would no longer fit in a nibble.
+ */
+static inline bool look_and_say_emit(look_and_say_chunk_t *chunk, uint8_t digit) {
+    chunk->length++;
+
+    if(chunk->output_length > 0 && LOOK_AND_SAY_DIGIT(chunk->output[chunk->output_length - 1]) == digit) {
+        if(LOOK_AND_SAY_COUNT(chunk->output[chunk->output_length - 1]) == 15) {
+            return false;
+        }
+        chunk->output[chunk->output_length - 1] += 0x10;
+        return true;
+    }
+
+    chunk->output[chunk->output_length++] = LOOK_AND_SAY_RUN(1, digit);
+    return true;
+}
+
+/**
+ * look_and_say_step_chunk: Read a range of runs aloud. A run of c digits d is read as the digits of c followed by d.
+ */
+static void *look_and_say_step_chunk(void *argument) {
+    look_and_say_chunk_t *chunk = argument;
+    chunk->output_length        = 0;
+    chunk->length               = 0;
+    chunk->overflowed           = false;
+
+    for(size_t i = 0; i < chunk->input_length; i++) {
+        uint8_t count = LOOK_AND_SAY_COUNT(chunk->input[i]);
+        uint8_t digit = LOOK_AND_SAY_DIGIT(chunk->input[i]);
+        bool fits = true;
+
+        if(count >= 10) {
+            fits = look_and_say_emit(chunk, 1) && look_and_say_emit(chunk, count - 10);
+        }
+        else {
+            fits = look_and_say_emit(chunk, count);
+        }
+
+        if(!fits || !look_and_say_emit(chunk, digit)) {
+            chunk->overflowed = true;
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+// Reading a run aloud produces at most three digits, and only runs of ten or more produce three.
+static size_t look_and_say_max_output(const uint8_t *runs, size_t number_of_runs) {
+    size_t max_output = 2 * number_of_runs;
+    for(size_t i = 0; i < number_of_runs; i++) {
+        max_output += LOOK_AND_SAY_COUNT(runs[i]) >= 10;
+    }
+    return max_output;
+}
+
+look_and_say_t *look_and_say_create(const char *digits, size_t length) {
+    if(length == 0) {
+        fprintf(stderr, "%s:%s:%d: the starting term is empty\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    look_and_say_t *sequence = calloc(1, sizeof(look_and_say_t));
+    if(sequence == NULL || (sequence->runs = malloc(length)) == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for sequence\n", __FILE__, __func__, __LINE__);
+        free(sequence);
+        return NULL;
+    }
+
+    sequence->runs_capacity     = length;
+    sequence->length            = length;
+    sequence->number_of_threads = 1;
+
+    for(size_t i = 0; i < length; i++) {
+        uint8_t digit = (uint8_t)(digits[i] - '0');
+        if(digit > 9) {
+            fprintf(stderr, "%s:%s:%d: '%c' at index %zu is not a digit\n", __FILE__, __func__, __LINE__, digits[i], i);
+            look_and_say_destroy(sequence);
+            return NULL;
+        }
+
+        uint8_t *last = sequence->number_of_runs > 0 ? &sequence->runs[sequence->number_of_runs - 1] : NULL;
+        if(last != NULL && LOOK_AND_SAY_DIGIT(*last) == digit) {
+            if(LOOK_AND_SAY_COUNT(*last) == 15) {
+                fprintf(stderr, "%s:%s:%d: the run ending at index %zu is longer than 15 digits\n", __FILE__, __func__, __LINE__, i);
+                look_and_say_destroy(sequence);
+                return NULL;
+            }
+            *last += 0x10;
+        }
+        else {
+            sequence->runs[sequence->number_of_runs++] = LOOK_AND_SAY_RUN(1, digit);
+        }
+    }
+
+    return sequence;
+}
+
+void look_and_say_destroy(look_and_say_t *sequence) {
+    if(sequence == NULL) {
+        return;
+    }
+    free(sequence->runs);
+    free(sequence->next_runs);
+    free(sequence);
+}
+
+void look_and_say_set_number_of_threads(look_and_say_t *sequence, size_t number_of_threads) {
+    sequence->number_of_threads = number_of_threads == 0 ? 1 : number_of_threads;
+}
+
+bool look_and_say_step(look_and_say_t *sequence) {
+    size_t max_output = look_and_say_max_output(sequence->runs, sequence->number_of_runs);
+    if(max_output > sequence->next_runs_capacity) {
+        // Terms grow by about 30% per step, so leave room for the next one as well.
+        size_t new_capacity = max_output + max_output / 2;
+        uint8_t *next_runs  = realloc(sequence->next_runs, new_capacity);
+        if(next_runs == NULL) {
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for the next term\n", __FILE__, __func__, __LINE__);
+            return false;
+        }
+        sequence->next_runs             = next_runs;
+        sequence->next_runs_capacity    = new_capacity;
+    }
+
+    size_t number_of_chunks = sequence->number_of_runs / LOOK_AND_SAY_MIN_RUNS_PER_THREAD;
+    if(number_of_chunks > sequence->number_of_threads) {
+        number_of_chunks = sequence->number_of_threads;
+    }
+    if(number_of_chunks == 0) {
+        number_of_chunks = 1;
+    }
+
+    // Every chunk writes its runs at an offset that leaves room for the most it can produce. The chunks are then
+    // stitched together front to back, merging the runs on either side of a boundary when they hold the same digit.
+    look_and_say_chunk_t chunks[number_of_chunks];
+    pthread_t threads[number_of_chunks];
+    size_t chunk_size   = sequence->number_of_runs / number_of_chunks;
+    size_t output_start = 0;
+
+    for(size_t c = 0; c < number_of_chunks; c++) {
+        size_t input_start          = c * chunk_size;
+        size_t input_end            = c == number_of_chunks - 1 ? sequence->number_of_runs : input_start + chunk_size;
+        chunks[c].input             = sequence->runs + input_start;
+        chunks[c].input_length      = input_end - input_start;
+        chunks[c].output            = sequence->next_runs + output_start;
+        output_start                += look_and_say_max_output(chunks[c].input, chunks[c].input_length);
+    }
+
+    size_t started = 1;
+    for(; started < number_of_chunks; started++) {
+        if(pthread_create(&threads[started], NULL, look_and_say_step_chunk, &chunks[started]) != 0) {
+            break;
+        }
+    }
+    look_and_say_step_chunk(&chunks[0]);
+    for(size_t c = 1; c < number_of_chunks; c++) {
+        if(c < started) {
+            pthread_join(threads[c], NULL);
+        }
+        else {
+            look_and_say_step_chunk(&chunks[c]);
+        }
+    }
+
+    size_t number_of_runs   = 0;
+    size_t length           = 0;
+    for(size_t c = 0; c < number_of_chunks; c++) {
+        if(chunks[c].overflowed) {
+            fprintf(stderr, "%s:%s:%d: the next term has a run longer than 15 digits\n", __FILE__, __func__, __LINE__);
+            return false;
+        }
+
+        const uint8_t *output   = chunks[c].output;
+        size_t output_length    = chunks[c].output_length;
+        length                  += chunks[c].length;
+
+        if(number_of_runs > 0 && output_length > 0 && LOOK_AND_SAY_DIGIT(sequence->next_runs[number_of_runs - 1]) == LOOK_AND_SAY_DIGIT(output[0])) {
+            size_t count = LOOK_AND_SAY_COUNT(sequence->next_runs[number_of_runs - 1]) + LOOK_AND_SAY_COUNT(output[0]);
+            if(count > 15) {
+                fprintf(stderr, "%s:%s:%d: the next term has a run longer than 15 digits\n", __FILE__, __func__, __LINE__);
+                return false;
+            }
+            sequence->next_runs[number_of_runs - 1] = LOOK_AND_SAY_RUN(count, LOOK_AND_SAY_DIGIT(output[0]));
+            output++;
+            output_length--;
+        }
+
+        memmove(sequence->next_runs + number_of_runs, output, output_length);
+        number_of_runs += output_length;
+    }
+
+    uint8_t *runs                   = sequence->runs;
+    size_t runs_capacity            = sequence->runs_capacity;
+    sequence->runs                  = sequence->next_runs;
+    sequence->runs_capacity         = sequence->next_runs_capacity;
+    sequence->number_of_runs        = number_of_runs;
+    sequence->next_runs             = runs;
+    sequence->next_runs_capacity    = runs_capacity;
+    sequence->length                = length;
+    return true;
+}
+
+bool look_and_say_step_n(look_and_say_t *sequence, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        if(!look_and_say_step(sequence)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t look_and_say_get_length(const look_and_say_t *sequence) {
+    return sequence->length;
+}
+
+size_t look_and_say_get_number_of_runs(const look_and_say_t *sequence) {
+    return sequence->number_of_runs;
+}
+
+char *look_and_say_to_string(const look_and_say_t *sequence) {
+    char *result = malloc(sequence->length + 1);
+    if(result == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for string\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    size_t position = 0;
+    for(size_t i = 0; i < sequence->number_of_runs; i++) {
+        memset(result + position, '0' + LOOK_AND_SAY_DIGIT(sequence->runs[i]), LOOK_AND_SAY_COUNT(sequence->runs[i]));
+        position += LOOK_AND_SAY_COUNT(sequence->runs[i]);
+    }
+    result[position] = '\0';
+    return result;
+}
@@ -0,0 +1,230 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ctype4c.h"
+#include "number4c.h"
+#include "pattern4c.h"
+
+typedef enum pattern_op_type_t {
+    PATTERN_OP_LITERAL,
+    PATTERN_OP_INT,
+    PATTERN_OP_WORD,
+    PATTERN_OP_CHOICE
+} pattern_op_type_t;
+
+typedef struct pattern_op_t {
+    pattern_op_type_t   type;
+    string_view_t       literal;                // PATTERN_OP_LITERAL
+    size_t              first_alternative;      // PATTERN_OP_CHOICE, an index into alternatives.
+    size_t              number_of_alternatives;
+    int                 stop;                   // PATTERN_OP_WORD, the byte that ends the word besides whitespace, or -1.
+} pattern_op_t;
+
+struct pattern_t {
+    pattern_op_t    *ops;
+    size_t          number_of_ops;
+    string_view_t   *alternatives;
+    size_t          number_of_fields;
+    char            *text;                      // Backs every literal and alternative, since escapes are unescaped.
+};
+
+static bool pattern_add_field(pattern_t *pattern, const char *field, size_t field_length, size_t *text_length, size_t *number_of_alternatives) {
+    pattern_op_t *op = &pattern->ops[pattern->number_of_ops];
+
+    if(field_length == 3 && memcmp(field, "int", 3) == 0) {
+        op->type = PATTERN_OP_INT;
+    }
+    else if(field_length == 4 && memcmp(field, "word", 4) == 0) {
+        op->type = PATTERN_OP_WORD;
+        op->stop = -1;
+    }
+    else if(memchr(field, '|', field_length) != NULL) {
+        op->type                = PATTERN_OP_CHOICE;
+        op->first_alternative   = *number_of_alternatives;
+
+        string_tokenizer_t tokenizer = { .remaining = { .data = field, .length = field_length }, .delimiters = "|" };
+        string_view_t alternative;
+        while(string_tokenizer_next(&tokenizer, &alternative)) {
+            memcpy(pattern->text + *text_length, alternative.data, alternative.length);
+            pattern->alternatives[(*number_of_alternatives)++] = (string_view_t){ .data = pattern->text + *text_length, .length = alternative.length };
+            *text_length += alternative.length;
+            op->number_of_alternatives++;
+        }
+
+        // The tokenizer skips empty tokens, so an empty alternative shows up as fewer alternatives than separators.
+        size_t separators = 0;
+        for(size_t i = 0; i < field_length; i++) {
+            separators += field[i] == '|';
+        }
+        if(op->number_of_alternatives != separators + 1) {
+            fprintf(stderr, "%s:%s:%d: {%.*s} has an empty alternative\n", __FILE__, __func__, __LINE__, (int)field_length, field);
+            return false;
+        }
+    }
+    else {
+        fprintf(stderr, "%s:%s:%d: {%.*s} is not a field\n", __FILE__, __func__, __LINE__, (int)field_length, field);
+        return false;
+    }
+
+    pattern->number_of_ops++;
+    pattern->number_of_fields++;
+    return true;
+}
+
+pattern_t *pattern_compile(const char *format) {
+    size_t format_length = strlen(format);
+
+    // Every op, alternative and byte of text comes from at least one byte of the format.
+    pattern_t *pattern = calloc(1, sizeof(pattern_t));
+    if(pattern == NULL
+        || (pattern->ops = calloc(format_length + 1, sizeof(pattern_op_t))) == NULL
+        || (pattern->alternatives = calloc(format_length + 1, sizeof(string_view_t))) == NULL
+        || (pattern->text = malloc(format_length + 1)) == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for pattern\n", __FILE__, __func__, __LINE__);
+        pattern_destroy(pattern);
+        return NULL;
+    }
+
+    size_t text_length              = 0;
+    size_t number_of_alternatives   = 0;
+    size_t i                        = 0;
+    while(i < format_length) {
+        if(format[i] == '{' && format[i + 1] != '{') {
+            const char *end = strchr(format + i, '}');
+            if(end == NULL) {
+                fprintf(stderr, "%s:%s:%d: the field at index %zu is not closed\n", __FILE__, __func__, __LINE__, i);
+                pattern_destroy(pattern);
+                return NULL;
+            }
+            if(!pattern_add_field(pattern, format + i + 1, (size_t)(end - format) - i - 1, &text_length, &number_of_alternatives)) {
+                pattern_destroy(pattern);
+                return NULL;
+            }
+            i = (size_t)(end - format) + 1;
+            continue;
+        }
+
+        if(format[i] == '}' && format[i + 1] != '}') {
+            fprintf(stderr, "%s:%s:%d: unmatched '}' at index %zu\n", __FILE__, __func__, __LINE__, i);
+            pattern_destroy(pattern);
+            return NULL;
+        }
+
+        // Literal text, with "{{" and "}}" unescaped, extends the previous literal if there is one.
+        pattern_op_t *previous = pattern->number_of_ops > 0 ? &pattern->ops[pattern->number_of_ops - 1] : NULL;
+        if(previous == NULL || previous->type != PATTERN_OP_LITERAL) {
+            pattern->ops[pattern->number_of_ops++] = (pattern_op_t){ .type = PATTERN_OP_LITERAL, .literal = { .data = pattern->text + text_length, .length = 0 } };
+            previous = &pattern->ops[pattern->number_of_ops - 1];
+        }
+        pattern->text[text_length++] = format[i];
+        previous->literal.length++;
+        i += format[i] == '{' || format[i] == '}' ? 2 : 1;
+    }
+
+    for(size_t j = 0; j + 1 < pattern->number_of_ops; j++) {
+        if(pattern->ops[j].type == PATTERN_OP_WORD && pattern->ops[j + 1].type == PATTERN_OP_LITERAL) {
+            pattern->ops[j].stop = (unsigned char)pattern->ops[j + 1].literal.data[0];
+        }
+    }
+
+    return pattern;
+}
+
+void pattern_destroy(pattern_t *pattern) {
+    if(pattern == NULL) {
+        return;
+    }
+    free(pattern->ops);
+    free(pattern->alternatives);
+    free(pattern->text);
+    free(pattern);
+}
+
+size_t pattern_get_number_of_fields(const pattern_t *pattern) {
+    return pattern->number_of_fields;
+}
+
+static inline bool pattern_has_prefix(const char *data, size_t length, string_view_t prefix) {
+    return prefix.length <= length && memcmp(data, prefix.data, prefix.length) == 0;
+}
+
+bool pattern_match(const pattern_t *pattern, string_view_t line, pattern_value_t *out_values) {
+    const char *data    = line.data;
+    size_t length       = line.length;
+    size_t position     = 0;
+    size_t field        = 0;
+
+    for(size_t i = 0; i < pattern->number_of_ops; i++) {
+        const pattern_op_t *op = &pattern->ops[i];
+        switch(op->type) {
+            case PATTERN_OP_LITERAL:
+                if(!pattern_has_prefix(data + position, length - position, op->literal)) {
+                    return false;
+                }
+                position += op->literal.length;
+            break;
+            case PATTERN_OP_INT: {
+                size_t consumed = number_parse_i64(data + position, length - position, &out_values[field++].integer);
+                if(consumed == 0) {
+                    return false;
+                }
+                position += consumed;
+            }
+            break;
+            case PATTERN_OP_WORD: {
+                size_t start = position;
+                while(position < length && !ctype_is_space(data[position]) && (unsigned char)data[position] != op->stop) {
+                    position++;
+                }
+                if(position == start) {
+                    return false;
+                }
+                out_values[field++].word = (string_view_t){ .data = data + start, .length = position - start };
+            }
+            break;
+            case PATTERN_OP_CHOICE: {
+                size_t j = 0;
+                while(j < op->number_of_alternatives && !pattern_has_prefix(data + position, length - position, pattern->alternatives[op->first_alternative + j])) {
+                    j++;
+                }
+                if(j == op->number_of_alternatives) {
+                    return false;
+                }
+                position += pattern->alternatives[op->first_alternative + j].length;
+                out_values[field++].choice = j;
+            }
+            break;
+        }
+    }
+
+    return position == length;
+}
+
+size_t pattern_match_lines(const pattern_t *pattern, const char *text, size_t length, pattern_value_t *out_values, size_t max_lines) {
+    size_t number_of_lines  = 0;
+    size_t position         = 0;
+
+    while(position < length && number_of_lines < max_lines) {
+        const char *newline = memchr(text + position, '\n', length - position);
+        size_t line_end     = newline == NULL ? length : (size_t)(newline - text);
+        string_view_t line  = { .data = text + position, .length = line_end - position };
+        position            = line_end + 1;
+
+        if(line.length > 0 && line.data[line.length - 1] == '\r') {
+            line.length--;
+        }
+        if(line.length == 0) {
+            continue;
+        }
+
+        if(!pattern_match(pattern, line, out_values + number_of_lines * pattern->number_of_fields)) {
+            fprintf(stderr, "%s:%s:%d: line %zu does not match: %.*s\n", __FILE__, __func__, __LINE__, number_of_lines + 1, (int)line.length, line.data);
+            break;
+        }
+        number_of_lines++;
+    }
+
+    return number_of_lines;
+}
@@ -0,0 +1,610 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simd4c.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SIMD4C_X86 1
+#include <immintrin.h>
+#endif
+
+// Sets larger than this are matched with a lookup table instead of one comparison per set byte.
+#define SIMD_MAX_VECTOR_SET 16
+
+#define SIMD_BLOCK_SIZE 64
+
+typedef struct simd_kernels_t {
+    size_t (*count_any)(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length);
+    size_t (*find_any)(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length);
+    size_t (*find_not_in_range)(const unsigned char *data, size_t length, unsigned char low, unsigned char high);
+    size_t (*count_in_set)(const unsigned char *data, size_t length, const simd_byte_set_t *set);
+    size_t (*find_in_set)(const unsigned char *data, size_t length, const simd_byte_set_t *set, bool negate);
+    void (*classify_block)(const unsigned char *data, size_t length, const simd_byte_set_t *sets, size_t number_of_sets, uint64_t *out_masks);
+} simd_kernels_t;
+
+void simd_byte_set_add(simd_byte_set_t *set, unsigned char c) {
+    set->rows[c >> 7][c & 0x0F] |= (uint8_t)(1u << ((c >> 4) & 7));
+}
+
+bool simd_byte_set_contains(const simd_byte_set_t *set, unsigned char c) {
+    return (set->rows[c >> 7][c & 0x0F] >> ((c >> 4) & 7)) & 1;
+}
+
+static void simd_build_table(bool table[256], const unsigned char *set, size_t set_length) {
+    memset(table, 0, 256 * sizeof(bool));
+    for(size_t i = 0; i < set_length; i++) {
+        table[set[i]] = true;
+    }
+}
+
+static void simd_build_byte_set(simd_byte_set_t *byte_set, const unsigned char *set, size_t set_length) {
+    memset(byte_set, 0, sizeof(simd_byte_set_t));
+    for(size_t i = 0; i < set_length; i++) {
+        simd_byte_set_add(byte_set, set[i]);
+    }
+}
+
+static size_t simd_count_any_scalar(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length) {
+    bool table[256];
+    simd_build_table(table, set, set_length);
+
+    size_t count = 0;
+    for(size_t i = 0; i < length; i++) {
+        count += table[data[i]];
+    }
+    return count;
+}
+
+static size_t simd_find_any_scalar(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length) {
+    bool table[256];
+    simd_build_table(table, set, set_length);
+
+    for(size_t i = 0; i < length; i++) {
+        if(table[data[i]]) {
+            return i;
+        }
+    }
+    return length;
+}
+
+static size_t simd_find_not_in_range_scalar(const unsigned char *data, size_t length, unsigned char low, unsigned char high) {
+    unsigned char range = (unsigned char)(high - low);
+    for(size_t i = 0; i < length; i++) {
+        if((unsigned char)(data[i] - low) > range) {
+            return i;
+        }
+    }
+    return length;
+}
+
+static size_t simd_count_in_set_scalar(const unsigned char *data, size_t length, const simd_byte_set_t *set) {
+    size_t count = 0;
+    for(size_t i = 0; i < length; i++) {
+        count += simd_byte_set_contains(set, data[i]);
+    }
+    return count;
+}
+
+static size_t simd_find_in_set_scalar(const unsigned char *data, size_t length, const simd_byte_set_t *set, bool negate) {
+    for(size_t i = 0; i < length; i++) {
+        if(simd_byte_set_contains(set, data[i]) != negate) {
+            return i;
+        }
+    }
+    return length;
+}
+
+static void simd_classify_block_scalar(const unsigned char *data, size_t length, const simd_byte_set_t *sets, size_t number_of_sets, uint64_t *out_masks) {
+    for(size_t s = 0; s < number_of_sets; s++) {
+        uint64_t mask = 0;
+        for(size_t i = 0; i < length; i++) {
+            mask |= (uint64_t)simd_byte_set_contains(&sets[s], data[i]) << i;
+        }
+        out_masks[s] = mask;
+    }
+}
+
+// Masks the bits of a 64-byte block that lie before the end of the input. length is at most 64.
+static inline uint64_t simd_block_valid_mask(size_t length) {
+    return length >= SIMD_BLOCK_SIZE ? UINT64_MAX : (1ull << length) - 1;
+}
+
+static const simd_kernels_t simd_kernels_scalar = {
+    .count_any          = simd_count_any_scalar,
+    .find_any           = simd_find_any_scalar,
+    .find_not_in_range  = simd_find_not_in_range_scalar,
+    .count_in_set       = simd_count_in_set_scalar,
+    .find_in_set        = simd_find_in_set_scalar,
+    .classify_block     = simd_classify_block_scalar
+};
+
+#ifdef SIMD4C_X86
+
+// The kernels below handle the final partial block by copying it into a zeroed buffer and masking off the bits past
+// the end of the input, so no load ever reads outside the input.
+
+static inline uint32_t simd_sse2_match_mask(__m128i block, const __m128i *needles, size_t set_length) {
+    __m128i matches = _mm_setzero_si128();
+    for(size_t j = 0; j < set_length; j++) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles[j]));
+    }
+    return (uint32_t)_mm_movemask_epi8(matches);
+}
+
+static inline uint32_t simd_sse2_out_of_range_mask(__m128i block, __m128i low, __m128i range) {
+    // Shift the range down to start at zero; a byte is in range when the unsigned minimum leaves it untouched.
+    __m128i shifted = _mm_sub_epi8(block, low);
+    __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(shifted, range), shifted);
+    return ~(uint32_t)_mm_movemask_epi8(in_range) & 0xFFFFu;
+}
+
+static size_t simd_count_any_sse2(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length) {
+    if(set_length > SIMD_MAX_VECTOR_SET) {
+        return simd_count_any_scalar(data, length, set, set_length);
+    }
+
+    __m128i needles[SIMD_MAX_VECTOR_SET];
+    for(size_t j = 0; j < set_length; j++) {
+        needles[j] = _mm_set1_epi8((char)set[j]);
+    }
+
+    size_t count    = 0;
+    size_t i        = 0;
+    for(; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        count += (size_t)__builtin_popcount(simd_sse2_match_mask(block, needles, set_length));
+    }
+
+    if(i < length) {
+        unsigned char tail[16] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t valid = (1u << (length - i)) - 1;
+        count += (size_t)__builtin_popcount(simd_sse2_match_mask(_mm_loadu_si128((const __m128i *)tail), needles, set_length) & valid);
+    }
+    return count;
+}
+
+static size_t simd_find_any_sse2(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length) {
+    if(set_length > SIMD_MAX_VECTOR_SET) {
+        return simd_find_any_scalar(data, length, set, set_length);
+    }
+
+    __m128i needles[SIMD_MAX_VECTOR_SET];
+    for(size_t j = 0; j < set_length; j++) {
+        needles[j] = _mm_set1_epi8((char)set[j]);
+    }
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+        uint32_t mask = simd_sse2_match_mask(_mm_loadu_si128((const __m128i *)(data + i)), needles, set_length);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    if(i < length) {
+        unsigned char tail[16] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = simd_sse2_match_mask(_mm_loadu_si128((const __m128i *)tail), needles, set_length) & ((1u << (length - i)) - 1);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return length;
+}
+
+static size_t simd_find_not_in_range_sse2(const unsigned char *data, size_t length, unsigned char low, unsigned char high) {
+    __m128i low_vector      = _mm_set1_epi8((char)low);
+    __m128i range_vector    = _mm_set1_epi8((char)(unsigned char)(high - low));
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+        uint32_t mask = simd_sse2_out_of_range_mask(_mm_loadu_si128((const __m128i *)(data + i)), low_vector, range_vector);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    if(i < length) {
+        unsigned char tail[16] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = simd_sse2_out_of_range_mask(_mm_loadu_si128((const __m128i *)tail), low_vector, range_vector) & ((1u << (length - i)) - 1);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return length;
+}
+
+static const simd_kernels_t simd_kernels_sse2 = {
+    .count_any          = simd_count_any_sse2,
+    .find_any           = simd_find_any_sse2,
+    .find_not_in_range  = simd_find_not_in_range_sse2,
+    .count_in_set       = simd_count_in_set_scalar,
+    .find_in_set        = simd_find_in_set_scalar,
+    .classify_block     = simd_classify_block_scalar
+};
+
+#define SIMD_SSSE3 __attribute__((target("ssse3")))
+
+static inline SIMD_SSSE3 uint32_t simd_ssse3_set_mask(__m128i block, __m128i rows_low, __m128i rows_high) {
+    __m128i low_nibbles     = _mm_and_si128(block, _mm_set1_epi8(0x0F));
+    __m128i high_nibbles    = _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x0F));
+    // Bytes of 0x80 and above have the sign bit set and take their row from the second table.
+    __m128i high_half       = _mm_cmplt_epi8(block, _mm_setzero_si128());
+    __m128i rows            = _mm_or_si128(_mm_andnot_si128(high_half, _mm_shuffle_epi8(rows_low, low_nibbles)), _mm_and_si128(high_half, _mm_shuffle_epi8(rows_high, low_nibbles)));
+    __m128i bits            = _mm_shuffle_epi8(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128), high_nibbles);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(rows, bits), bits));
+}
+
+static SIMD_SSSE3 size_t simd_count_in_set_ssse3(const unsigned char *data, size_t length, const simd_byte_set_t *set) {
+    __m128i rows_low    = _mm_loadu_si128((const __m128i *)set->rows[0]);
+    __m128i rows_high   = _mm_loadu_si128((const __m128i *)set->rows[1]);
+
+    size_t count    = 0;
+    size_t i        = 0;
+    for(; i + 16 <= length; i += 16) {
+        count += (size_t)__builtin_popcount(simd_ssse3_set_mask(_mm_loadu_si128((const __m128i *)(data + i)), rows_low, rows_high));
+    }
+
+    if(i < length) {
+        unsigned char tail[16] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t valid = (1u << (length - i)) - 1;
+        count += (size_t)__builtin_popcount(simd_ssse3_set_mask(_mm_loadu_si128((const __m128i *)tail), rows_low, rows_high) & valid);
+    }
+    return count;
+}
+
+static SIMD_SSSE3 size_t simd_find_in_set_ssse3(const unsigned char *data, size_t length, const simd_byte_set_t *set, bool negate) {
+    __m128i rows_low    = _mm_loadu_si128((const __m128i *)set->rows[0]);
+    __m128i rows_high   = _mm_loadu_si128((const __m128i *)set->rows[1]);
+    uint32_t flip       = negate ? 0xFFFFu : 0;
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16) {
+        uint32_t mask = simd_ssse3_set_mask(_mm_loadu_si128((const __m128i *)(data + i)), rows_low, rows_high) ^ flip;
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    if(i < length) {
+        unsigned char tail[16] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = (simd_ssse3_set_mask(_mm_loadu_si128((const __m128i *)tail), rows_low, rows_high) ^ flip) & ((1u << (length - i)) - 1);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return length;
+}
+
+static SIMD_SSSE3 void simd_classify_block_ssse3(const unsigned char *data, size_t length, const simd_byte_set_t *sets, size_t number_of_sets, uint64_t *out_masks) {
+    unsigned char tail[SIMD_BLOCK_SIZE] = {0};
+    if(length < SIMD_BLOCK_SIZE) {
+        memcpy(tail, data, length);
+        data = tail;
+    }
+
+    __m128i chunks[4];
+    for(size_t k = 0; k < 4; k++) {
+        chunks[k] = _mm_loadu_si128((const __m128i *)(data + 16 * k));
+    }
+
+    for(size_t s = 0; s < number_of_sets; s++) {
+        __m128i rows_low    = _mm_loadu_si128((const __m128i *)sets[s].rows[0]);
+        __m128i rows_high   = _mm_loadu_si128((const __m128i *)sets[s].rows[1]);
+        uint64_t mask       = 0;
+        for(size_t k = 0; k < 4; k++) {
+            mask |= (uint64_t)simd_ssse3_set_mask(chunks[k], rows_low, rows_high) << (16 * k);
+        }
+        out_masks[s] = mask & simd_block_valid_mask(length);
+    }
+}
+
+static const simd_kernels_t simd_kernels_ssse3 = {
+    .count_any          = simd_count_any_sse2,
+    .find_any           = simd_find_any_sse2,
+    .find_not_in_range  = simd_find_not_in_range_sse2,
+    .count_in_set       = simd_count_in_set_ssse3,
+    .find_in_set        = simd_find_in_set_ssse3,
+    .classify_block     = simd_classify_block_ssse3
+};
+
+#define SIMD_AVX2 __attribute__((target("avx2")))
+
+static inline SIMD_AVX2 uint32_t simd_avx2_match_mask(__m256i block, const __m256i *needles, size_t set_length) {
+    __m256i matches = _mm256_setzero_si256();
+    for(size_t j = 0; j < set_length; j++) {
+        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, needles[j]));
+    }
+    return (uint32_t)_mm256_movemask_epi8(matches);
+}
+
+static inline SIMD_AVX2 uint32_t simd_avx2_out_of_range_mask(__m256i block, __m256i low, __m256i range) {
+    __m256i shifted = _mm256_sub_epi8(block, low);
+    __m256i in_range = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, range), shifted);
+    return ~(uint32_t)_mm256_movemask_epi8(in_range);
+}
+
+// Masks the bits of a 32-byte block that lie before the end of the input. remaining is less than 32.
+static inline uint32_t simd_avx2_valid_mask(size_t remaining) {
+    return (uint32_t)((1ull << remaining) - 1);
+}
+
+static inline SIMD_AVX2 uint32_t simd_avx2_set_mask(__m256i block, __m256i rows_low, __m256i rows_high) {
+    __m256i low_nibbles     = _mm256_and_si256(block, _mm256_set1_epi8(0x0F));
+    __m256i high_nibbles    = _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x0F));
+    __m256i high_half       = _mm256_cmpgt_epi8(_mm256_setzero_si256(), block);
+    __m256i rows            = _mm256_blendv_epi8(_mm256_shuffle_epi8(rows_low, low_nibbles), _mm256_shuffle_epi8(rows_high, low_nibbles), high_half);
+    __m256i bits            = _mm256_shuffle_epi8(_mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128), high_nibbles);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(rows, bits), bits));
+}
+
+static SIMD_AVX2 size_t simd_count_in_set_avx2(const unsigned char *data, size_t length, const simd_byte_set_t *set) {
+    // The shuffles work within each 128-bit lane, so both lanes get a copy of the rows.
+    __m256i rows_low    = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->rows[0]));
+    __m256i rows_high   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->rows[1]));
+
+    size_t count    = 0;
+    size_t i        = 0;
+    for(; i + 32 <= length; i += 32) {
+        count += (size_t)__builtin_popcount(simd_avx2_set_mask(_mm256_loadu_si256((const __m256i *)(data + i)), rows_low, rows_high));
+    }
+
+    if(i < length) {
+        unsigned char tail[32] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = simd_avx2_set_mask(_mm256_loadu_si256((const __m256i *)tail), rows_low, rows_high);
+        count += (size_t)__builtin_popcount(mask & simd_avx2_valid_mask(length - i));
+    }
+    return count;
+}
+
+static SIMD_AVX2 size_t simd_find_in_set_avx2(const unsigned char *data, size_t length, const simd_byte_set_t *set, bool negate) {
+    __m256i rows_low    = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->rows[0]));
+    __m256i rows_high   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->rows[1]));
+    uint32_t flip       = negate ? UINT32_MAX : 0;
+
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+        uint32_t mask = simd_avx2_set_mask(_mm256_loadu_si256((const __m256i *)(data + i)), rows_low, rows_high) ^ flip;
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    if(i < length) {
+        unsigned char tail[32] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = (simd_avx2_set_mask(_mm256_loadu_si256((const __m256i *)tail), rows_low, rows_high) ^ flip) & simd_avx2_valid_mask(length - i);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return length;
+}
+
+static SIMD_AVX2 size_t simd_count_any_avx2(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length) {
+    if(set_length > SIMD_MAX_VECTOR_SET) {
+        simd_byte_set_t byte_set;
+        simd_build_byte_set(&byte_set, set, set_length);
+        return simd_count_in_set_avx2(data, length, &byte_set);
+    }
+
+    __m256i needles[SIMD_MAX_VECTOR_SET];
+    for(size_t j = 0; j < set_length; j++) {
+        needles[j] = _mm256_set1_epi8((char)set[j]);
+    }
+
+    size_t count    = 0;
+    size_t i        = 0;
+    for(; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+        count += (size_t)__builtin_popcount(simd_avx2_match_mask(block, needles, set_length));
+    }
+
+    if(i < length) {
+        unsigned char tail[32] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = simd_avx2_match_mask(_mm256_loadu_si256((const __m256i *)tail), needles, set_length);
+        count += (size_t)__builtin_popcount(mask & simd_avx2_valid_mask(length - i));
+    }
+    return count;
+}
+
+static SIMD_AVX2 size_t simd_find_any_avx2(const unsigned char *data, size_t length, const unsigned char *set, size_t set_length) {
+    if(set_length > SIMD_MAX_VECTOR_SET) {
+        simd_byte_set_t byte_set;
+        simd_build_byte_set(&byte_set, set, set_length);
+        return simd_find_in_set_avx2(data, length, &byte_set, false);
+    }
+
+    __m256i needles[SIMD_MAX_VECTOR_SET];
+    for(size_t j = 0; j < set_length; j++) {
+        needles[j] = _mm256_set1_epi8((char)set[j]);
+    }
+
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+        uint32_t mask = simd_avx2_match_mask(_mm256_loadu_si256((const __m256i *)(data + i)), needles, set_length);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    if(i < length) {
+        unsigned char tail[32] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = simd_avx2_match_mask(_mm256_loadu_si256((const __m256i *)tail), needles, set_length) & simd_avx2_valid_mask(length - i);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return length;
+}
+
+static SIMD_AVX2 size_t simd_find_not_in_range_avx2(const unsigned char *data, size_t length, unsigned char low, unsigned char high) {
+    __m256i low_vector      = _mm256_set1_epi8((char)low);
+    __m256i range_vector    = _mm256_set1_epi8((char)(unsigned char)(high - low));
+
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32) {
+        uint32_t mask = simd_avx2_out_of_range_mask(_mm256_loadu_si256((const __m256i *)(data + i)), low_vector, range_vector);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    if(i < length) {
+        unsigned char tail[32] = {0};
+        memcpy(tail, data + i, length - i);
+        uint32_t mask = simd_avx2_out_of_range_mask(_mm256_loadu_si256((const __m256i *)tail), low_vector, range_vector) & simd_avx2_valid_mask(length - i);
+        if(mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return length;
+}
+
+static SIMD_AVX2 void simd_classify_block_avx2(const unsigned char *data, size_t length, const simd_byte_set_t *sets, size_t number_of_sets, uint64_t *out_masks) {
+    unsigned char tail[SIMD_BLOCK_SIZE] = {0};
+    if(length < SIMD_BLOCK_SIZE) {
+        memcpy(tail, data, length);
+        data = tail;
+    }
+
+    __m256i low_half    = _mm256_loadu_si256((const __m256i *)data);
+    __m256i high_half   = _mm256_loadu_si256((const __m256i *)(data + 32));
+
+    for(size_t s = 0; s < number_of_sets; s++) {
+        __m256i rows_low    = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)sets[s].rows[0]));
+        __m256i rows_high   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)sets[s].rows[1]));
+        uint64_t mask       = (uint64_t)simd_avx2_set_mask(low_half, rows_low, rows_high) | (uint64_t)simd_avx2_set_mask(high_half, rows_low, rows_high) << 32;
+        out_masks[s]        = mask & simd_block_valid_mask(length);
+    }
+}
+
+static const simd_kernels_t simd_kernels_avx2 = {
+    .count_any          = simd_count_any_avx2,
+    .find_any           = simd_find_any_avx2,
+    .find_not_in_range  = simd_find_not_in_range_avx2,
+    .count_in_set       = simd_count_in_set_avx2,
+    .find_in_set        = simd_find_in_set_avx2,
+    .classify_block     = simd_classify_block_avx2
+};
+
+#endif
+
+static bool simd_is_supported(simd_isa_t isa) {
+    switch(isa) {
+        case SIMD_ISA_SCALAR:
+            return true;
+#ifdef SIMD4C_X86
+        case SIMD_ISA_SSE2:
+            return true;
+        case SIMD_ISA_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+static const simd_kernels_t *simd_kernels_for(simd_isa_t isa) {
+    switch(isa) {
+#ifdef SIMD4C_X86
+        case SIMD_ISA_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("ssse3") ? &simd_kernels_ssse3 : &simd_kernels_sse2;
+        case SIMD_ISA_AVX2:
+            return &simd_kernels_avx2;
+#endif
+        default:
+            return &simd_kernels_scalar;
+    }
+}
+
+// Picked by the first kernel call or by simd_set_isa. The kernel table is resolved at the same time, so a kernel call is
+// one load rather than a CPU feature query.
+static int simd_current_isa = -1;
+static const simd_kernels_t *simd_current_kernels = NULL;
+
+static void simd_use_isa(simd_isa_t isa) {
+    __atomic_store_n(&simd_current_isa, (int)isa, __ATOMIC_RELAXED);
+    __atomic_store_n(&simd_current_kernels, simd_kernels_for(isa), __ATOMIC_RELAXED);
+}
+
+static inline const simd_kernels_t *simd_get_kernels(void) {
+    const simd_kernels_t *kernels = __atomic_load_n(&simd_current_kernels, __ATOMIC_RELAXED);
+    if(kernels == NULL) {
+        simd_use_isa(simd_is_supported(SIMD_ISA_AVX2) ? SIMD_ISA_AVX2 : simd_is_supported(SIMD_ISA_SSE2) ? SIMD_ISA_SSE2 : SIMD_ISA_SCALAR);
+        kernels = __atomic_load_n(&simd_current_kernels, __ATOMIC_RELAXED);
+    }
+    return kernels;
+}
+
+simd_isa_t simd_get_isa(void) {
+    simd_get_kernels();
+    return (simd_isa_t)__atomic_load_n(&simd_current_isa, __ATOMIC_RELAXED);
+}
+
+bool simd_set_isa(simd_isa_t isa) {
+    if(!simd_is_supported(isa)) {
+        return false;
+    }
+    simd_use_isa(isa);
+    return true;
+}
+
+size_t simd_count_byte(const char *data, size_t length, char c) {
+    return simd_get_kernels()->count_any((const unsigned char *)data, length, (const unsigned char *)&c, 1);
+}
+
+size_t simd_count_any(const char *data, size_t length, const char *set, size_t set_length) {
+    if(set_length == 0) {
+        return 0;
+    }
+    return simd_get_kernels()->count_any((const unsigned char *)data, length, (const unsigned char *)set, set_length);
+}
+
+size_t simd_find_byte(const char *data, size_t length, char c) {
+    return simd_get_kernels()->find_any((const unsigned char *)data, length, (const unsigned char *)&c, 1);
+}
+
+size_t simd_find_any(const char *data, size_t length, const char *set, size_t set_length) {
+    if(set_length == 0) {
+        return length;
+    }
+    return simd_get_kernels()->find_any((const unsigned char *)data, length, (const unsigned char *)set, set_length);
+}
+
+size_t simd_find_not_in_range(const char *data, size_t length, unsigned char low, unsigned char high) {
+    if(low > high) {
+        return 0;
+    }
+    return simd_get_kernels()->find_not_in_range((const unsigned char *)data, length, low, high);
+}
+
+bool simd_all_in_range(const char *data, size_t length, unsigned char low, unsigned char high) {
+    return simd_find_not_in_range(data, length, low, high) == length;
+}
+
+size_t simd_count_in_set(const char *data, size_t length, const simd_byte_set_t *set) {
+    return simd_get_kernels()->count_in_set((const unsigned char *)data, length, set);
+}
+
+size_t simd_find_in_set(const char *data, size_t length, const simd_byte_set_t *set) {
+    return simd_get_kernels()->find_in_set((const unsigned char *)data, length, set, false);
+}
+
+size_t simd_find_not_in_set(const char *data, size_t length, const simd_byte_set_t *set) {
+    return simd_get_kernels()->find_in_set((const unsigned char *)data, length, set, true);
+}
+
+void simd_classify_block(const char *data, size_t length, const simd_byte_set_t *sets, size_t number_of_sets, uint64_t *out_masks) {
+    simd_get_kernels()->classify_block((const unsigned char *)data, length < SIMD_BLOCK_SIZE ? length : SIMD_BLOCK_SIZE, sets, number_of_sets, out_masks);
+}
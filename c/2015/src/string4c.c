@@ -1,4 +1,3 @@
-#include <ctype.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -6,7 +5,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include "ctype4c.h"
+#include "fnv.h"
 #include "math4c.h"
+#include "number4c.h"
+#include "simd4c.h"
 #include "string4c.h"
 
 int string_compare_asc(const void *str1, const void *str2) {
@@ -28,14 +31,7 @@ bool string_is_numeric(char *str)
         return false;
     }
 
-    for (size_t i = 0; i < strlen(str); i++)
-    {
-        if (str[i] < '0' || str[i] > '9')
-        {
-            return false;
-        }
-    }
-    return true;
+    return simd_all_in_range(str, strlen(str), '0', '9');
 }
 
 char **string_split(size_t *out_result_length, char *input, char *delimiter) {
@@ -130,7 +126,7 @@ char *string_trim(char *str)
     char *end = str_copy + size - 1;
 
     // Move the end pointer backwards until we encounter a non-whitespace character.
-    while (end >= str_copy && isspace(*end))
+    while (end >= str_copy && ctype_is_space(*end))
     {
         end--;
     }
@@ -140,7 +136,7 @@ char *string_trim(char *str)
     *(end + 1) = '\0';
 
     // Move the str pointer forward until we encounter a non-whitespace character.
-    while (*str_copy && isspace(*str_copy))
+    while (*str_copy && ctype_is_space(*str_copy))
     {
         str_copy++;
     }
@@ -156,30 +152,13 @@ char *string_trim(char *str)
 
 int convert_hex_char_to_int(char c)
 {
-    int result;
-    if ('0' <= c && c <= '9')
-    {
-        result = c - '0';
-    }
-    else if ('a' <= c && c <= 'f')
-    {
-        result = c - 'a' + 10;
-    }
-    else if ('A' <= c && c <= 'F')
-    {
-        result = c - 'A' + 10;
-    }
-    else
-    {
-        result = -1;
-    }
-    return result;
+    return ctype_hex_value(c);
 }
 
 char *string_unescape(const char *str)
 {
     size_t len          = strlen(str);
-    string_buffer_t *sb = string_buffer_create(len);
+    string_buffer_t *sb = string_buffer_create(len + 1); // Unescaping never makes the string longer.
     int high            = 0;
     int low             = 0;
 
@@ -188,94 +167,124 @@ char *string_unescape(const char *str)
             i++;
             switch(str[i]) {
                 case '\\':
-                    string_buffer_append(sb, "\\");
+                    string_buffer_append_char(sb, '\\');
                 break;
                 case '"':
-                    string_buffer_append(sb, "\"");
+                    string_buffer_append_char(sb, '"');
                 break;
                 case 'x':
                     high = convert_hex_char_to_int(str[i + 1]);
                     low = convert_hex_char_to_int(str[i + 2]);
                     if (high != -1 && low != -1) {
                         // Move the high character to the left and then append the low character to the right.
-                        char c[2];
-                        sprintf(c, "%c", (high << 4) | low);
-                        c[1] = '\0';
-                        string_buffer_append(sb, c);
+                        // A decoded \x00 is dropped, since it would terminate the resulting string early.
+                        if((high | low) != 0) {
+                            string_buffer_append_char(sb, (char)((high << 4) | low));
+                        }
                         // Move past the two character we've just handled.
                         i += 2;
                     }
                     else {
                         // We encountered something that's not a valid hexadecimal string, so we just add it to the result so that it's preserved.
-                        string_buffer_append(sb, "\\x");
+                        string_buffer_append_bytes(sb, "\\x", 2);
                     }
                 break;
             }
         }
         else {
-            char c[2];
-            sprintf(c, "%c", str[i]);
-            c[1] = '\0';
-            string_buffer_append(sb, c);
+            string_buffer_append_char(sb, str[i]);
         }
     }
 
-    char *result = malloc(sb->length + 1);
-    strcpy(result, sb->content);
-    result[sb->length] = '\0';
-    string_buffer_destroy(sb);
-    return result;
+    return string_buffer_release(sb);
 }
 
 char *string_escape(const char *str) {
     size_t len          = strlen(str);
-    string_buffer_t *sb = string_buffer_create(len);
+    string_buffer_t *sb = string_buffer_create(len + 3);
     int high            = 0;
     int low             = 0;
 
-    string_buffer_append(sb, "\"");
+    string_buffer_append_char(sb, '"');
 
     for(size_t i = 0; i < len; i++) {
         switch(str[i]) {
             case '\\':
-                string_buffer_append(sb, "\\\\");
+                string_buffer_append_bytes(sb, "\\\\", 2);
             break;
             case '"':
-                string_buffer_append(sb, "\\\"");
+                string_buffer_append_bytes(sb, "\\\"", 2);
             break;
             case 'x':
                 high = convert_hex_char_to_int(str[i + 1]);
                 low = convert_hex_char_to_int(str[i + 2]);
                 if(high != -1 && low != -1) {
-                    char c[4];
-                    sprintf(c, "%c%c%c", str[i], str[i + 1], str[i + 2]);
-                    c[3] = '\0';
-                    string_buffer_append(sb, c);
+                    string_buffer_append_bytes(sb, str + i, 3);
                     i += 2;
                 }
                 else {
                     // We encountered something that's not a valid hexadecimal string, so we just add it to the result so that it's preserved.
-                    char c[2];
-                    sprintf(c, "%c", str[i]);
-                    c[1] = '\0';
-                    string_buffer_append(sb, c);
+                    string_buffer_append_char(sb, str[i]);
                 }
             break;
             default:
-                string_buffer_append(sb, (char[2]){ str[i], '\0' });
+                string_buffer_append_char(sb, str[i]);
             break;
         }
     }
 
-    string_buffer_append(sb, "\"");
+    string_buffer_append_char(sb, '"');
+
+    return string_buffer_release(sb);
+}
+
+size_t string_unescaped_length(const char *str, size_t length) {
+    size_t result   = 0;
+    size_t i        = 0;
+
+    while(i < length) {
+        size_t backslash = i + simd_find_byte(str + i, length - i, '\\');
+        result  += backslash - i;
+        i       = backslash;
+        if(i == length) {
+            break;
+        }
+
+        // Mirror string_unescape: the character after the backslash is always consumed, and only \\, \" and valid
+        // \x escapes produce anything.
+        i++;
+        if(i == length) {
+            break;
+        }
+
+        switch(str[i]) {
+            case '\\':
+            case '"':
+                result++;
+            break;
+            case 'x': {
+                int high    = i + 1 < length ? convert_hex_char_to_int(str[i + 1]) : -1;
+                int low     = i + 2 < length ? convert_hex_char_to_int(str[i + 2]) : -1;
+                if(high != -1 && low != -1) {
+                    result  += (high | low) != 0; // A decoded \x00 is dropped.
+                    i       += 2;
+                }
+                else {
+                    result  += 2;
+                }
+            }
+            break;
+        }
+        i++;
+    }
 
-    char *result = malloc(sb->length + 1);
-    strcpy(result, sb->content);
-    result[sb->length] = '\0';
-    string_buffer_destroy(sb);
     return result;
 }
 
+size_t string_escaped_length(const char *str, size_t length) {
+    return length + 2 + simd_count_any(str, length, "\\\"", 2);
+}
+
 string_buffer_t *string_buffer_create(size_t capacity) {
     string_buffer_t *buffer = malloc(sizeof(string_buffer_t));
     if(buffer == NULL) {
@@ -283,7 +292,8 @@ string_buffer_t *string_buffer_create(size_t capacity) {
         return NULL;
     }
     
-    buffer->capacity    = capacity;
+    // Always leave room for the null terminator, so the content is a valid string even while the buffer is empty.
+    buffer->capacity    = capacity == 0 ? 1 : capacity;
     buffer->length      = 0;
     buffer->content     = malloc(buffer->capacity);
     if(buffer->content == NULL) {
@@ -291,6 +301,7 @@ string_buffer_t *string_buffer_create(size_t capacity) {
         free(buffer);
         return NULL;
     }
+    buffer->content[0]  = '\0';
 
     return buffer;
 }
@@ -300,42 +311,124 @@ void string_buffer_destroy(string_buffer_t *buffer) {
     free(buffer);
 }
 
+char *string_buffer_release(string_buffer_t *buffer) {
+    char *content = buffer->content;
+    free(buffer);
+    return content;
+}
+
+static bool string_buffer_resize(string_buffer_t *buffer, size_t new_capacity) {
+    char *new_content = realloc(buffer->content, new_capacity);
+    if(new_content == NULL) {
+        fprintf(stderr, "%s:%d: failed to allocate additional memory for buffer content.\n", __func__, __LINE__);
+        return false;
+    }
+
+    buffer->capacity    = new_capacity;
+    buffer->content     = new_content;
+    return true;
+}
+
 bool string_buffer_realloc(string_buffer_t *buffer, size_t additional_length) {
-    size_t new_length = buffer->length + additional_length + 1;
+    size_t required_capacity = buffer->length + additional_length + 1;
+    if(required_capacity <= buffer->capacity) {
+        return true;
+    }
 
-    if(new_length > buffer->capacity) {
-        size_t new_capacity = buffer->capacity * 2;
-        while(new_capacity <= buffer->capacity + new_length) {
-            new_capacity *= 2;
-        }
+    size_t new_capacity = buffer->capacity * 2;
+    if(new_capacity < required_capacity) {
+        new_capacity = required_capacity;
+    }
+    return string_buffer_resize(buffer, new_capacity);
+}
 
-        char *new_content   = realloc(buffer->content, new_capacity);
-        if(new_content == NULL) {
-            fprintf(stderr, "%s:%d: failed to allocate additional memory for buffer content.\n", __func__, __LINE__);
-            return false;
-        }
+bool string_buffer_reserve_exact(string_buffer_t *buffer, size_t additional_length) {
+    size_t required_capacity = buffer->length + additional_length + 1;
+    if(required_capacity <= buffer->capacity) {
+        return true;
+    }
+    return string_buffer_resize(buffer, required_capacity);
+}
 
-        buffer->capacity    = new_capacity;
-        buffer->content     = new_content;
+bool string_buffer_append(string_buffer_t *buffer, const char *str) {
+    return string_buffer_append_bytes(buffer, str, strlen(str));
+}
+
+bool string_buffer_append_char(string_buffer_t *buffer, char c) {
+    if(buffer->length + 2 > buffer->capacity && !string_buffer_realloc(buffer, 1)) {
+        fprintf(stderr, "%s:%d: Failed to reallocate additional memory for string buffer.\n", __func__, __LINE__);
+        return false;
     }
 
+    buffer->content[buffer->length++]   = c;
+    buffer->content[buffer->length]     = '\0';
     return true;
 }
 
-bool string_buffer_append(string_buffer_t *buffer, const char *str) {
-    size_t length = strlen(str);
+bool string_buffer_append_bytes(string_buffer_t *buffer, const char *bytes, size_t length) {
     if(!string_buffer_realloc(buffer, length)) {
         fprintf(stderr, "%s:%d: Failed to reallocate additional memory for string buffer.\n", __func__, __LINE__);
         return false;
     }
 
-    strcpy(buffer->content + buffer->length, str);
+    memcpy(buffer->content + buffer->length, bytes, length);
     buffer->length += length;
     buffer->content[buffer->length] = '\0';
     
     return true;
 }
 
+// Every pair of decimal digits from 00 to 99, so numbers can be formatted two digits per division.
+static const char string_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Writes the digits of value to the end of out, which must hold 20 characters, and returns where the digits start.
+static char *string_format_u64(char out[20], uint64_t value) {
+    char *position = out + 20;
+    while(value >= 100) {
+        size_t pair = (size_t)(value % 100) * 2;
+        value /= 100;
+        position -= 2;
+        memcpy(position, string_digit_pairs + pair, 2);
+    }
+
+    if(value >= 10) {
+        position -= 2;
+        memcpy(position, string_digit_pairs + value * 2, 2);
+    }
+    else {
+        *--position = (char)('0' + value);
+    }
+    return position;
+}
+
+bool string_buffer_append_u64(string_buffer_t *buffer, uint64_t value) {
+    char digits[20];
+    char *start = string_format_u64(digits, value);
+    return string_buffer_append_bytes(buffer, start, (size_t)(digits + 20 - start));
+}
+
+bool string_buffer_append_i64(string_buffer_t *buffer, int64_t value) {
+    if(value >= 0) {
+        return string_buffer_append_u64(buffer, (uint64_t)value);
+    }
+
+    // Negate in unsigned arithmetic so INT64_MIN does not overflow.
+    char digits[21];
+    char *start = string_format_u64(digits + 1, -(uint64_t)value);
+    *--start = '-';
+    return string_buffer_append_bytes(buffer, start, (size_t)(digits + 21 - start));
+}
+
 char *string_substring(char *input, size_t inclusive_start, size_t exclusive_end)
 {
     if (inclusive_start > strlen(input))
@@ -389,13 +482,8 @@ bool string_has_straight(const char *str) {
 }
 
 bool string_has_any_needle(const char *str, char *needles, size_t number_of_needles) {
-    for(size_t i = 0; i < number_of_needles; i++) {
-        char needle = needles[i];
-        if(strchr(str, needle)) {
-            return true;
-        }
-    }
-    return false;
+    size_t length = strlen(str);
+    return simd_find_any(str, length, needles, number_of_needles) != length;
 }
 
 char *string_replace(char *str, const char *old_str, const char *new_str) {
@@ -451,15 +539,75 @@ char *string_replace(char *str, const char *old_str, const char *new_str) {
 }
 
 char *string_replace_all(char *str, const char *old_str, const char *new_str) {
-    if(!str || !old_str || !new_str) {
+    if(!str || !old_str || !new_str || *old_str == '\0') {
+        return str;
+    }
+
+    size_t old_length = strlen(old_str);
+    size_t new_length = strlen(new_str);
+
+    // Record where every occurrence starts in one pass. Most strings have few occurrences, so start on the stack.
+    size_t stack_positions[64];
+    size_t *positions           = stack_positions;
+    size_t positions_capacity   = sizeof(stack_positions) / sizeof(stack_positions[0]);
+    size_t number_of_positions  = 0;
+
+    for(char *match = strstr(str, old_str); match != NULL; match = strstr(match + old_length, old_str)) {
+        if(number_of_positions == positions_capacity) {
+            size_t *new_positions = positions == stack_positions ? malloc(positions_capacity * 2 * sizeof(size_t)) : realloc(positions, positions_capacity * 2 * sizeof(size_t));
+            if(new_positions == NULL) {
+                fprintf(stderr, "%s:%s:%d: failed to allocate memory for match positions\n", __FILE__, __func__, __LINE__);
+                if(positions != stack_positions) {
+                    free(positions);
+                }
+                return str;
+            }
+            if(positions == stack_positions) {
+                memcpy(new_positions, stack_positions, sizeof(stack_positions));
+            }
+            positions           = new_positions;
+            positions_capacity  *= 2;
+        }
+        positions[number_of_positions++] = (size_t)(match - str);
+    }
+
+    if(number_of_positions == 0) {
         return str;
     }
 
-    while(strstr(str, old_str) != NULL) {
-        str = string_replace(str, old_str, new_str);
+    size_t str_length       = strlen(str);
+    size_t result_length    = str_length - number_of_positions * old_length + number_of_positions * new_length;
+
+    // When the result is not longer the write position never overtakes the read position, so the string is rewritten
+    // in place. Otherwise the result is written once into a buffer of the exact size.
+    char *result = new_length <= old_length ? str : malloc(result_length + 1);
+    if(result == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for result\n", __FILE__, __func__, __LINE__);
+        if(positions != stack_positions) {
+            free(positions);
+        }
+        return str;
     }
 
-    return str;
+    size_t read     = 0;
+    size_t write    = 0;
+    for(size_t i = 0; i < number_of_positions; i++) {
+        size_t unchanged_length = positions[i] - read;
+        memmove(result + write, str + read, unchanged_length);
+        write   += unchanged_length;
+        memcpy(result + write, new_str, new_length);
+        write   += new_length;
+        read    = positions[i] + old_length;
+    }
+    memmove(result + write, str + read, str_length - read + 1);
+
+    if(positions != stack_positions) {
+        free(positions);
+    }
+    if(result != str) {
+        free(str);
+    }
+    return result;
 }
 
 char *string_replace_at(const char *str, const char *new_str, size_t pos, size_t length) {
@@ -524,3 +672,817 @@ char *string_slice(const char *str, size_t start, size_t end) {
     slice[slice_len] = '\0';
     return slice;
 }
+
+string_view_t string_view_create(const char *data, size_t length) {
+    return (string_view_t){ .data = data, .length = length };
+}
+
+string_view_t string_view_from_cstr(const char *str) {
+    return (string_view_t){ .data = str, .length = str == NULL ? 0 : strlen(str) };
+}
+
+char *string_view_to_cstr(string_view_t view) {
+    char *result = malloc(view.length + 1);
+    if(result == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for string\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    if(view.length > 0) {
+        memcpy(result, view.data, view.length);
+    }
+    result[view.length] = '\0';
+    return result;
+}
+
+string_view_t string_view_slice(string_view_t view, size_t start, size_t end) {
+    if(end > view.length) {
+        end = view.length;
+    }
+    if(start >= end) {
+        return (string_view_t){ .data = view.data + (start < view.length ? start : view.length), .length = 0 };
+    }
+    return (string_view_t){ .data = view.data + start, .length = end - start };
+}
+
+string_view_t string_view_trim(string_view_t view) {
+    while(view.length > 0 && ctype_is_space(view.data[0])) {
+        view.data++;
+        view.length--;
+    }
+    while(view.length > 0 && ctype_is_space(view.data[view.length - 1])) {
+        view.length--;
+    }
+    return view;
+}
+
+string_view_t string_view_trim_char(string_view_t view, char c) {
+    if(view.length > 0 && view.data[view.length - 1] == c) {
+        view.length--;
+    }
+    return view;
+}
+
+int string_view_compare(string_view_t a, string_view_t b) {
+    size_t length   = a.length < b.length ? a.length : b.length;
+    int result      = length == 0 ? 0 : memcmp(a.data, b.data, length);
+    if(result != 0) {
+        return result;
+    }
+    return a.length < b.length ? -1 : a.length > b.length ? 1 : 0;
+}
+
+bool string_view_equals(string_view_t a, string_view_t b) {
+    return a.length == b.length && (a.length == 0 || memcmp(a.data, b.data, a.length) == 0);
+}
+
+bool string_view_equals_cstr(string_view_t view, const char *str) {
+    return string_view_equals(view, string_view_from_cstr(str));
+}
+
+bool string_view_starts_with(string_view_t view, const char *prefix) {
+    size_t prefix_length = strlen(prefix);
+    return prefix_length <= view.length && memcmp(view.data, prefix, prefix_length) == 0;
+}
+
+size_t string_view_find_char(string_view_t view, char c) {
+    if(view.length == 0) {
+        return STRING_VIEW_NPOS;
+    }
+
+    const char *match = memchr(view.data, c, view.length);
+    return match == NULL ? STRING_VIEW_NPOS : (size_t)(match - view.data);
+}
+
+size_t string_view_find(string_view_t view, string_view_t needle) {
+    if(needle.length == 0) {
+        return 0;
+    }
+
+    // Jump between occurrences of the first byte with memchr and only compare the rest of the needle there.
+    size_t offset = 0;
+    while(offset + needle.length <= view.length) {
+        const char *candidate = memchr(view.data + offset, needle.data[0], view.length - needle.length - offset + 1);
+        if(candidate == NULL) {
+            return STRING_VIEW_NPOS;
+        }
+
+        offset = (size_t)(candidate - view.data);
+        if(memcmp(candidate + 1, needle.data + 1, needle.length - 1) == 0) {
+            return offset;
+        }
+        offset++;
+    }
+    return STRING_VIEW_NPOS;
+}
+
+bool string_view_parse_int(string_view_t view, int64_t *out_value) {
+    int64_t value;
+    if(view.length == 0 || number_parse_i64(view.data, view.length, &value) != view.length) {
+        return false;
+    }
+
+    *out_value = value;
+    return true;
+}
+
+bool string_owned_init(string_owned_t *str, const char *data, size_t length) {
+    char *destination = str->data.inline_data;
+    if(length > STRING_OWNED_INLINE_CAPACITY) {
+        destination = malloc(length + 1);
+        if(destination == NULL) {
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for string\n", __FILE__, __func__, __LINE__);
+            str->length                 = 0;
+            str->data.inline_data[0]    = '\0';
+            return false;
+        }
+        str->data.heap = destination;
+    }
+
+    memcpy(destination, data, length);
+    destination[length] = '\0';
+    str->length         = length;
+    return true;
+}
+
+void string_owned_free(string_owned_t *str) {
+    if(str->length > STRING_OWNED_INLINE_CAPACITY) {
+        free(str->data.heap);
+    }
+    str->length                 = 0;
+    str->data.inline_data[0]    = '\0';
+}
+
+const char *string_owned_get(const string_owned_t *str) {
+    return str->length > STRING_OWNED_INLINE_CAPACITY ? str->data.heap : str->data.inline_data;
+}
+
+string_view_t string_owned_view(const string_owned_t *str) {
+    return (string_view_t){ .data = string_owned_get(str), .length = str->length };
+}
+
+bool string_owned_equals(const string_owned_t *str, string_view_t view) {
+    return string_view_equals(string_owned_view(str), view);
+}
+
+int string_owned_compare(const string_owned_t *a, const string_owned_t *b) {
+    return string_view_compare(string_owned_view(a), string_owned_view(b));
+}
+
+uint64_t string_owned_hash(const string_owned_t *str) {
+    return fnv1a_bytes(string_owned_get(str), str->length);
+}
+
+string_tokenizer_t string_tokenizer_create(string_view_t input, const char *delimiters) {
+    return (string_tokenizer_t){ .remaining = input, .delimiters = delimiters };
+}
+
+static bool string_tokenizer_is_delimiter(const string_tokenizer_t *tokenizer, char c) {
+    return c != '\0' && strchr(tokenizer->delimiters, c) != NULL;
+}
+
+bool string_tokenizer_next(string_tokenizer_t *tokenizer, string_view_t *out_token) {
+    string_view_t *remaining = &tokenizer->remaining;
+
+    while(remaining->length > 0 && string_tokenizer_is_delimiter(tokenizer, remaining->data[0])) {
+        remaining->data++;
+        remaining->length--;
+    }
+
+    if(remaining->length == 0) {
+        return false;
+    }
+
+    size_t token_length = 1;
+    while(token_length < remaining->length && !string_tokenizer_is_delimiter(tokenizer, remaining->data[token_length])) {
+        token_length++;
+    }
+
+    *out_token          = (string_view_t){ .data = remaining->data, .length = token_length };
+    remaining->data     += token_length;
+    remaining->length   -= token_length;
+    return true;
+}
+
+bool string_tokenizer_skip(string_tokenizer_t *tokenizer, size_t n) {
+    string_view_t token;
+    for(size_t i = 0; i < n; i++) {
+        if(!string_tokenizer_next(tokenizer, &token)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t string_view_split(string_view_t input, const char *delimiters, string_view_t *out_tokens, size_t max_tokens) {
+    string_tokenizer_t tokenizer    = string_tokenizer_create(input, delimiters);
+    size_t number_of_tokens         = 0;
+
+    while(number_of_tokens < max_tokens && string_tokenizer_next(&tokenizer, &out_tokens[number_of_tokens])) {
+        number_of_tokens++;
+    }
+    return number_of_tokens;
+}
+
+typedef struct string_rope_node_t {
+    size_t                      offset; // Where the piece starts in the rope's buffer.
+    size_t                      length; // The length of the piece.
+    size_t                      subtree_length;
+    uint32_t                    priority;
+    struct string_rope_node_t   *left;
+    struct string_rope_node_t   *right;
+} string_rope_node_t;
+
+struct string_rope_t {
+    string_buffer_t     *buffer;
+    string_rope_node_t  *root;
+    uint32_t            seed;
+};
+
+static size_t string_rope_node_get_length(const string_rope_node_t *node) {
+    return node == NULL ? 0 : node->subtree_length;
+}
+
+static void string_rope_node_update(string_rope_node_t *node) {
+    node->subtree_length = string_rope_node_get_length(node->left) + node->length + string_rope_node_get_length(node->right);
+}
+
+static string_rope_node_t *string_rope_node_create(string_rope_t *rope, size_t offset, size_t length) {
+    string_rope_node_t *node = malloc(sizeof(string_rope_node_t));
+    if(node == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for rope node\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    // xorshift32 keeps the treap balanced in expectation without pulling in rand().
+    rope->seed ^= rope->seed << 13;
+    rope->seed ^= rope->seed >> 17;
+    rope->seed ^= rope->seed << 5;
+
+    node->offset            = offset;
+    node->length            = length;
+    node->subtree_length    = length;
+    node->priority          = rope->seed;
+    node->left              = NULL;
+    node->right             = NULL;
+    return node;
+}
+
+static void string_rope_node_destroy(string_rope_node_t *node) {
+    if(node == NULL) {
+        return;
+    }
+    string_rope_node_destroy(node->left);
+    string_rope_node_destroy(node->right);
+    free(node);
+}
+
+static string_rope_node_t *string_rope_merge(string_rope_node_t *left, string_rope_node_t *right) {
+    if(left == NULL) {
+        return right;
+    }
+    if(right == NULL) {
+        return left;
+    }
+
+    if(left->priority > right->priority) {
+        left->right = string_rope_merge(left->right, right);
+        string_rope_node_update(left);
+        return left;
+    }
+
+    right->left = string_rope_merge(left, right->left);
+    string_rope_node_update(right);
+    return right;
+}
+
+/**
+ * string_rope_split: Split a tree into the first position characters and the rest. A piece straddling the split point
+ * is cut in two, which is the only time a split allocates.
+ * @return False if memory could not be allocated, in which case the tree is left as it was.
+ */
+static bool string_rope_split(string_rope_t *rope, string_rope_node_t *node, size_t position, string_rope_node_t **out_left, string_rope_node_t **out_right) {
+    if(node == NULL) {
+        *out_left   = NULL;
+        *out_right  = NULL;
+        return true;
+    }
+
+    size_t left_length = string_rope_node_get_length(node->left);
+
+    if(position <= left_length) {
+        string_rope_node_t *right_of_split;
+        if(!string_rope_split(rope, node->left, position, out_left, &right_of_split)) {
+            return false;
+        }
+        node->left = right_of_split;
+        string_rope_node_update(node);
+        *out_right = node;
+        return true;
+    }
+
+    if(position >= left_length + node->length) {
+        string_rope_node_t *left_of_split;
+        if(!string_rope_split(rope, node->right, position - left_length - node->length, &left_of_split, out_right)) {
+            return false;
+        }
+        node->right = left_of_split;
+        string_rope_node_update(node);
+        *out_left = node;
+        return true;
+    }
+
+    // The split point is inside this node's piece. The tail of the piece becomes a new node holding the right subtree,
+    // and takes the priority of the node so that it still outranks everything in that subtree.
+    size_t head_length          = position - left_length;
+    string_rope_node_t *tail    = string_rope_node_create(rope, node->offset + head_length, node->length - head_length);
+    if(tail == NULL) {
+        return false;
+    }
+
+    tail->priority  = node->priority;
+    tail->right     = node->right;
+    node->right     = NULL;
+    node->length    = head_length;
+    string_rope_node_update(tail);
+    string_rope_node_update(node);
+
+    *out_left   = node;
+    *out_right  = tail;
+    return true;
+}
+
+string_rope_t *string_rope_create(const char *str) {
+    string_rope_t *rope = malloc(sizeof(string_rope_t));
+    if(rope == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for rope\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    size_t length   = strlen(str);
+    rope->buffer    = string_buffer_create(length + 1);
+    rope->root      = NULL;
+    rope->seed      = 0x9E3779B9u;
+
+    if(rope->buffer == NULL || !string_buffer_append_bytes(rope->buffer, str, length)) {
+        string_rope_destroy(rope);
+        return NULL;
+    }
+
+    if(length > 0 && (rope->root = string_rope_node_create(rope, 0, length)) == NULL) {
+        string_rope_destroy(rope);
+        return NULL;
+    }
+    return rope;
+}
+
+void string_rope_destroy(string_rope_t *rope) {
+    if(rope == NULL) {
+        return;
+    }
+    string_rope_node_destroy(rope->root);
+    if(rope->buffer != NULL) {
+        string_buffer_destroy(rope->buffer);
+    }
+    free(rope);
+}
+
+size_t string_rope_get_length(const string_rope_t *rope) {
+    return string_rope_node_get_length(rope->root);
+}
+
+char string_rope_char_at(const string_rope_t *rope, size_t index) {
+    const string_rope_node_t *node = rope->root;
+
+    while(node != NULL) {
+        size_t left_length = string_rope_node_get_length(node->left);
+        if(index < left_length) {
+            node = node->left;
+        }
+        else if(index < left_length + node->length) {
+            return rope->buffer->content[node->offset + index - left_length];
+        }
+        else {
+            index   -= left_length + node->length;
+            node    = node->right;
+        }
+    }
+    return '\0';
+}
+
+bool string_rope_replace_at(string_rope_t *rope, size_t position, size_t length, const char *replacement) {
+    size_t rope_length = string_rope_get_length(rope);
+    if(position > rope_length) {
+        fprintf(stderr, "%s:%s:%d: position %zu is past the end of the rope (%zu)\n", __FILE__, __func__, __LINE__, position, rope_length);
+        return false;
+    }
+    if(length > rope_length - position) {
+        length = rope_length - position;
+    }
+
+    size_t replacement_length       = strlen(replacement);
+    string_rope_node_t *inserted    = NULL;
+    if(replacement_length > 0) {
+        inserted = string_rope_node_create(rope, rope->buffer->length, replacement_length);
+        if(inserted == NULL || !string_buffer_append_bytes(rope->buffer, replacement, replacement_length)) {
+            free(inserted);
+            return false;
+        }
+    }
+
+    string_rope_node_t *before, *rest, *removed, *after;
+    if(!string_rope_split(rope, rope->root, position, &before, &rest)) {
+        free(inserted);
+        return false;
+    }
+    if(!string_rope_split(rope, rest, length, &removed, &after)) {
+        rope->root = string_rope_merge(before, rest);
+        free(inserted);
+        return false;
+    }
+
+    string_rope_node_destroy(removed);
+    rope->root = string_rope_merge(string_rope_merge(before, inserted), after);
+    return true;
+}
+
+// Copies the characters in [start, end) of the subtree rooted at node, where node_start is the position of the
+// subtree's first character.
+static void string_rope_copy_range(const string_rope_t *rope, const string_rope_node_t *node, size_t node_start, size_t start, size_t end, char *out) {
+    if(node == NULL || end <= node_start || start >= node_start + node->subtree_length) {
+        return;
+    }
+
+    size_t left_length  = string_rope_node_get_length(node->left);
+    size_t piece_start  = node_start + left_length;
+    size_t piece_end    = piece_start + node->length;
+
+    string_rope_copy_range(rope, node->left, node_start, start, end, out);
+
+    size_t copy_start   = start > piece_start ? start : piece_start;
+    size_t copy_end     = end < piece_end ? end : piece_end;
+    if(copy_start < copy_end) {
+        memcpy(out + copy_start - start, rope->buffer->content + node->offset + copy_start - piece_start, copy_end - copy_start);
+    }
+
+    string_rope_copy_range(rope, node->right, piece_end, start, end, out);
+}
+
+char *string_rope_substring(const string_rope_t *rope, size_t start, size_t end) {
+    size_t rope_length = string_rope_get_length(rope);
+    if(end > rope_length) {
+        end = rope_length;
+    }
+    if(start > end) {
+        fprintf(stderr, "%s:%s:%d: invalid range [%zu, %zu)\n", __FILE__, __func__, __LINE__, start, end);
+        return NULL;
+    }
+
+    char *result = malloc(end - start + 1);
+    if(result == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for substring\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    string_rope_copy_range(rope, rope->root, 0, start, end, result);
+    result[end - start] = '\0';
+    return result;
+}
+
+char *string_rope_to_cstr(const string_rope_t *rope) {
+    return string_rope_substring(rope, 0, string_rope_get_length(rope));
+}
+
+typedef struct string_rope_search_t {
+    const char      *needle;
+    size_t          needle_length;
+    const size_t    *failure;   // The Knuth-Morris-Pratt failure function of the needle.
+    size_t          matched;    // How many characters of the needle the text scanned so far ends with.
+    size_t          from;
+    size_t          result;
+} string_rope_search_t;
+
+// Feeds the pieces of the subtree at or after search->from to the matcher, in order. Returns true once a match is found.
+static bool string_rope_search(const string_rope_t *rope, const string_rope_node_t *node, size_t node_start, string_rope_search_t *search) {
+    if(node == NULL || search->from >= node_start + node->subtree_length) {
+        return false;
+    }
+
+    size_t left_length = string_rope_node_get_length(node->left);
+    size_t piece_start = node_start + left_length;
+
+    if(string_rope_search(rope, node->left, node_start, search)) {
+        return true;
+    }
+
+    size_t skip         = search->from > piece_start ? search->from - piece_start : 0;
+    const char *piece   = rope->buffer->content + node->offset;
+    for(size_t i = skip; i < node->length; i++) {
+        while(search->matched > 0 && piece[i] != search->needle[search->matched]) {
+            search->matched = search->failure[search->matched - 1];
+        }
+        if(piece[i] == search->needle[search->matched]) {
+            search->matched++;
+        }
+        if(search->matched == search->needle_length) {
+            search->result = piece_start + i + 1 - search->needle_length;
+            return true;
+        }
+    }
+
+    return string_rope_search(rope, node->right, piece_start + node->length, search);
+}
+
+size_t string_rope_find(const string_rope_t *rope, const char *needle, size_t from) {
+    size_t needle_length = strlen(needle);
+    if(needle_length == 0) {
+        return from <= string_rope_get_length(rope) ? from : STRING_VIEW_NPOS;
+    }
+
+    size_t *failure = malloc(needle_length * sizeof(size_t));
+    if(failure == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for failure function\n", __FILE__, __func__, __LINE__);
+        return STRING_VIEW_NPOS;
+    }
+
+    failure[0] = 0;
+    for(size_t i = 1, k = 0; i < needle_length; i++) {
+        while(k > 0 && needle[i] != needle[k]) {
+            k = failure[k - 1];
+        }
+        if(needle[i] == needle[k]) {
+            k++;
+        }
+        failure[i] = k;
+    }
+
+    string_rope_search_t search = {
+        .needle         = needle,
+        .needle_length  = needle_length,
+        .failure        = failure,
+        .matched        = 0,
+        .from           = from,
+        .result         = STRING_VIEW_NPOS
+    };
+    string_rope_search(rope, rope->root, 0, &search);
+
+    free(failure);
+    return search.result;
+}
+
+struct string_matcher_t {
+    size_t      number_of_states;
+    uint32_t    *transitions;       // number_of_states rows of 256 next states. State 0 is the root.
+    int64_t     *pattern_ids;       // The pattern ending in each state, or -1 if none does.
+    uint32_t    *output_links;      // The nearest proper suffix state that ends a pattern, or 0 if there is none.
+    size_t      *pattern_lengths;
+};
+
+string_matcher_t *string_matcher_create(const char **patterns, size_t number_of_patterns) {
+    size_t max_states = 1;
+    for(size_t i = 0; i < number_of_patterns; i++) {
+        size_t length = strlen(patterns[i]);
+        if(length == 0) {
+            fprintf(stderr, "%s:%s:%d: pattern %zu is empty\n", __FILE__, __func__, __LINE__, i);
+            return NULL;
+        }
+        max_states += length;
+    }
+
+    string_matcher_t *matcher = calloc(1, sizeof(string_matcher_t));
+    uint32_t *failure_links   = calloc(max_states, sizeof(uint32_t));
+    uint32_t *queue           = malloc(max_states * sizeof(uint32_t));
+    if(matcher == NULL || failure_links == NULL || queue == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for matcher\n", __FILE__, __func__, __LINE__);
+        free(matcher);
+        free(failure_links);
+        free(queue);
+        return NULL;
+    }
+
+    matcher->transitions        = calloc(max_states * 256, sizeof(uint32_t));
+    matcher->pattern_ids        = malloc(max_states * sizeof(int64_t));
+    matcher->output_links       = calloc(max_states, sizeof(uint32_t));
+    matcher->pattern_lengths    = malloc((number_of_patterns == 0 ? 1 : number_of_patterns) * sizeof(size_t));
+    matcher->number_of_states   = 1;
+    if(matcher->transitions == NULL || matcher->pattern_ids == NULL || matcher->output_links == NULL || matcher->pattern_lengths == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for matcher tables\n", __FILE__, __func__, __LINE__);
+        free(failure_links);
+        free(queue);
+        string_matcher_destroy(matcher);
+        return NULL;
+    }
+    matcher->pattern_ids[0] = -1;
+
+    // Build the trie. While building, a transition of 0 means there is no edge, since no edge leads back to the root.
+    for(size_t i = 0; i < number_of_patterns; i++) {
+        uint32_t state = 0;
+        for(const unsigned char *c = (const unsigned char *)patterns[i]; *c != '\0'; c++) {
+            uint32_t *next = &matcher->transitions[(size_t)state * 256 + *c];
+            if(*next == 0) {
+                *next = (uint32_t)matcher->number_of_states++;
+                matcher->pattern_ids[*next] = -1;
+            }
+            state = *next;
+        }
+
+        // A duplicate pattern is reported under the id it was first given.
+        if(matcher->pattern_ids[state] < 0) {
+            matcher->pattern_ids[state] = (int64_t)i;
+        }
+        matcher->pattern_lengths[i] = strlen(patterns[i]);
+    }
+
+    // Breadth first over the trie, so the failure link of a state is final before any of its children are visited.
+    // Missing edges are filled in from the failure state, turning the trie into a complete automaton.
+    size_t head = 0, tail = 0;
+    for(size_t c = 0; c < 256; c++) {
+        uint32_t child = matcher->transitions[c];
+        if(child != 0) {
+            failure_links[child]    = 0;
+            queue[tail++]           = child;
+        }
+    }
+
+    while(head < tail) {
+        uint32_t state      = queue[head++];
+        uint32_t *row       = &matcher->transitions[(size_t)state * 256];
+        uint32_t *fail_row  = &matcher->transitions[(size_t)failure_links[state] * 256];
+
+        for(size_t c = 0; c < 256; c++) {
+            uint32_t child = row[c];
+            if(child == 0) {
+                row[c] = fail_row[c];
+                continue;
+            }
+
+            uint32_t failure                = fail_row[c];
+            failure_links[child]            = failure;
+            matcher->output_links[child]    = matcher->pattern_ids[failure] >= 0 ? failure : matcher->output_links[failure];
+            queue[tail++]                   = child;
+        }
+    }
+
+    free(failure_links);
+    free(queue);
+    return matcher;
+}
+
+void string_matcher_destroy(string_matcher_t *matcher) {
+    if(matcher == NULL) {
+        return;
+    }
+    free(matcher->transitions);
+    free(matcher->pattern_ids);
+    free(matcher->output_links);
+    free(matcher->pattern_lengths);
+    free(matcher);
+}
+
+size_t string_matcher_find_all(const string_matcher_t *matcher, const char *text, size_t length, string_match_t *out_matches, size_t max_matches) {
+    const unsigned char *bytes  = (const unsigned char *)text;
+    uint32_t state              = 0;
+    size_t number_of_matches    = 0;
+
+    for(size_t i = 0; i < length; i++) {
+        state = matcher->transitions[(size_t)state * 256 + bytes[i]];
+
+        // Every pattern ending here is on the chain of output links, longest first.
+        uint32_t output = matcher->pattern_ids[state] >= 0 ? state : matcher->output_links[state];
+        while(output != 0) {
+            if(number_of_matches < max_matches) {
+                size_t pattern_id = (size_t)matcher->pattern_ids[output];
+                out_matches[number_of_matches] = (string_match_t){
+                    .pattern_id = pattern_id,
+                    .position   = i + 1 - matcher->pattern_lengths[pattern_id]
+                };
+            }
+            number_of_matches++;
+            output = matcher->output_links[output];
+        }
+    }
+
+    return number_of_matches;
+}
+
+bool string_matcher_find_first(const string_matcher_t *matcher, const char *text, size_t length, string_match_t *out_match) {
+    const unsigned char *bytes  = (const unsigned char *)text;
+    uint32_t state              = 0;
+
+    for(size_t i = 0; i < length; i++) {
+        state = matcher->transitions[(size_t)state * 256 + bytes[i]];
+
+        uint32_t output = matcher->pattern_ids[state] >= 0 ? state : matcher->output_links[state];
+        if(output != 0) {
+            size_t pattern_id = (size_t)matcher->pattern_ids[output];
+            if(out_match != NULL) {
+                *out_match = (string_match_t){ .pattern_id = pattern_id, .position = i + 1 - matcher->pattern_lengths[pattern_id] };
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef struct string_replacement_match_t {
+    size_t position;
+    size_t length;
+    size_t pattern_id;
+} string_replacement_match_t;
+
+static int string_replacement_match_compare(const void *a, const void *b) {
+    const string_replacement_match_t *x = a;
+    const string_replacement_match_t *y = b;
+    if(x->position != y->position) {
+        return x->position < y->position ? -1 : 1;
+    }
+    // Prefer the longest pattern among those starting at the same position.
+    return x->length > y->length ? -1 : x->length < y->length ? 1 : 0;
+}
+
+char *string_replace_all_matches(const string_matcher_t *matcher, const char **replacements, const char *str) {
+    size_t str_length           = strlen(str);
+    size_t matches_capacity     = str_length + 1;
+    string_match_t *matches     = malloc(matches_capacity * sizeof(string_match_t));
+    if(matches == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for matches\n", __FILE__, __func__, __LINE__);
+        return NULL;
+    }
+
+    size_t number_of_matches = string_matcher_find_all(matcher, str, str_length, matches, matches_capacity);
+    if(number_of_matches > matches_capacity) {
+        string_match_t *new_matches = realloc(matches, number_of_matches * sizeof(string_match_t));
+        if(new_matches == NULL) {
+            fprintf(stderr, "%s:%s:%d: failed to allocate memory for matches\n", __FILE__, __func__, __LINE__);
+            free(matches);
+            return NULL;
+        }
+        matches = new_matches;
+        string_matcher_find_all(matcher, str, str_length, matches, number_of_matches);
+    }
+
+    // The automaton reports matches by where they end. Replacing needs them by where they start, leftmost first.
+    string_replacement_match_t *ordered = malloc((number_of_matches == 0 ? 1 : number_of_matches) * sizeof(string_replacement_match_t));
+    if(ordered == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for matches\n", __FILE__, __func__, __LINE__);
+        free(matches);
+        return NULL;
+    }
+    for(size_t i = 0; i < number_of_matches; i++) {
+        ordered[i] = (string_replacement_match_t){
+            .position   = matches[i].position,
+            .length     = matcher->pattern_lengths[matches[i].pattern_id],
+            .pattern_id = matches[i].pattern_id
+        };
+    }
+    free(matches);
+    qsort(ordered, number_of_matches, sizeof(string_replacement_match_t), string_replacement_match_compare);
+
+    // Keep the leftmost match, then the next one starting after it, and so on. Size the result from the kept matches.
+    size_t number_of_kept   = 0;
+    size_t result_length    = str_length;
+    size_t covered_until    = 0;
+    for(size_t i = 0; i < number_of_matches; i++) {
+        if(ordered[i].position < covered_until) {
+            continue;
+        }
+        covered_until               = ordered[i].position + ordered[i].length;
+        result_length               = result_length - ordered[i].length + strlen(replacements[ordered[i].pattern_id]);
+        ordered[number_of_kept++]   = ordered[i];
+    }
+
+    char *result = malloc(result_length + 1);
+    if(result == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to allocate memory for result\n", __FILE__, __func__, __LINE__);
+        free(ordered);
+        return NULL;
+    }
+
+    size_t read     = 0;
+    size_t write    = 0;
+    for(size_t i = 0; i < number_of_kept; i++) {
+        const char *replacement     = replacements[ordered[i].pattern_id];
+        size_t replacement_length   = strlen(replacement);
+
+        memcpy(result + write, str + read, ordered[i].position - read);
+        write   += ordered[i].position - read;
+        memcpy(result + write, replacement, replacement_length);
+        write   += replacement_length;
+        read    = ordered[i].position + ordered[i].length;
+    }
+    memcpy(result + write, str + read, str_length - read + 1);
+
+    free(ordered);
+    return result;
+}
+
+char *string_replace_all_multiple(const char *str, const char **old_strs, const char **new_strs, size_t number_of_pairs) {
+    string_matcher_t *matcher = string_matcher_create(old_strs, number_of_pairs);
+    if(matcher == NULL) {
+        return NULL;
+    }
+
+    char *result = string_replace_all_matches(matcher, new_strs, str);
+    string_matcher_destroy(matcher);
+    return result;
+}
@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testing/assertions.h"
+#include "arena4c.h"
+
+void test_arena_alloc_alignment_and_separation(size_t capacity) {
+    // assign
+    arena_t *arena = arena_create(capacity);
+    assert_not_null(arena, "%s\n", "arena_create returned null");
+    unsigned char *previous = NULL;
+    size_t previous_size    = 0;
+
+    // act
+    for(size_t i = 0; i < 1000; i++) {
+        size_t size             = 1 + (i * 37) % 300;
+        unsigned char *memory   = arena_alloc(arena, size);
+
+        // assert
+        assert_not_null(memory, "arena_alloc(%zu) returned null\n", size);
+        assert_primitive_equality((uintptr_t)memory % 16, (uintptr_t)0, "allocation %zu is not 16 byte aligned\n", i);
+        memset(memory, (int)(i & 0xFF), size);
+        if(previous != NULL) {
+            assert_primitive_equality(previous[previous_size - 1], (unsigned char)((i - 1) & 0xFF), "allocation %zu overwrote the previous one\n", i);
+        }
+        previous        = memory;
+        previous_size   = size;
+    }
+
+    assert_true((arena_get_used(arena) <= arena_get_capacity(arena)), "used %zu > capacity %zu\n", arena_get_used(arena), arena_get_capacity(arena));
+
+    printf("%s(%zu) passed\n", __func__, capacity);
+    arena_destroy(arena);
+}
+
+void test_arena_large_allocation() {
+    // assign
+    arena_t *arena = arena_create(64);
+
+    // act
+    unsigned char *memory = arena_alloc(arena, 1 << 20);
+
+    // assert
+    assert_not_null(memory, "%s\n", "arena_alloc of 1 MiB returned null");
+    memset(memory, 0xAB, 1 << 20);
+    assert_true((arena_get_used(arena) >= (1 << 20)), "used %zu < 1 MiB\n", arena_get_used(arena));
+
+    printf("%s passed\n", __func__);
+    arena_destroy(arena);
+}
+
+void test_arena_reset() {
+    // assign
+    arena_t *arena = arena_create(4096);
+    for(size_t i = 0; i < 100; i++) {
+        arena_alloc(arena, 1000);
+    }
+    size_t capacity = arena_get_capacity(arena);
+
+    // act
+    arena_reset(arena);
+
+    // assert
+    assert_primitive_equality(arena_get_used(arena), (size_t)0, "used != 0 (%zu)\n", arena_get_used(arena));
+    assert_true((arena_get_capacity(arena) <= capacity), "capacity grew from %zu to %zu\n", capacity, arena_get_capacity(arena));
+    assert_not_null(arena_alloc(arena, 1000), "%s\n", "arena_alloc after arena_reset returned null");
+
+    printf("%s passed\n", __func__);
+    arena_destroy(arena);
+}
+
+void test_arena_merge(size_t other_capacity) {
+    // assign
+    arena_t *arena  = arena_create(4096);
+    arena_t *other  = arena_create(other_capacity);
+    char *first     = arena_alloc(arena, 100);
+    char *second    = arena_alloc(other, 100);
+    memset(first, 'a', 100);
+    memset(second, 'b', 100);
+    size_t used     = arena_get_used(arena) + arena_get_used(other);
+    size_t capacity = arena_get_capacity(arena) + arena_get_capacity(other);
+
+    // act
+    arena_merge(arena, other);
+    char *third = arena_alloc(arena, 100);
+    memset(third, 'c', 100);
+
+    // assert
+    assert_primitive_equality(arena_get_used(arena), used + 112, "used != %zu (%zu)\n", used + 112, arena_get_used(arena));
+    assert_primitive_equality(arena_get_capacity(arena), capacity, "capacity != %zu (%zu)\n", capacity, arena_get_capacity(arena));
+    assert_true((first[99] == 'a' && second[99] == 'b'), "%s\n", "an allocation was overwritten");
+
+    arena_reset(arena);
+    assert_primitive_equality(arena_get_capacity(arena), (other_capacity > 4096 ? other_capacity : (size_t)4096), "the largest block was not kept (%zu)\n", arena_get_capacity(arena));
+
+    printf("%s(%zu) passed\n", __func__, other_capacity);
+    arena_destroy(arena);
+}
+
+int main() {
+    test_arena_alloc_alignment_and_separation(0);
+    test_arena_alloc_alignment_and_separation(4096);
+    test_arena_alloc_alignment_and_separation(1 << 20);
+    test_arena_large_allocation();
+    test_arena_reset();
+    test_arena_merge(4096);
+    test_arena_merge(1 << 16);
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "testing/assertions.h"
+#include "ctype4c.h"
+
+/**
+ * Checks every byte against <ctype.h>, which agrees with the table in the C locale.
+ */
+void test_ctype_classes_match_ctype_h(void) {
+    for(int c = 0; c < 256; c++) {
+        // act
+        uint8_t classes = ctype_classes[c];
+
+        // assert
+        assert_primitive_equality((isdigit(c) != 0), ((classes & CTYPE_DIGIT) != 0), "CTYPE_DIGIT is wrong for %d\n", c);
+        assert_primitive_equality((isxdigit(c) != 0), ((classes & CTYPE_HEX_DIGIT) != 0), "CTYPE_HEX_DIGIT is wrong for %d\n", c);
+        assert_primitive_equality((isspace(c) != 0), ((classes & CTYPE_SPACE) != 0), "CTYPE_SPACE is wrong for %d\n", c);
+        assert_primitive_equality((islower(c) != 0), ((classes & CTYPE_LOWER) != 0), "CTYPE_LOWER is wrong for %d\n", c);
+        assert_primitive_equality((isupper(c) != 0), ((classes & CTYPE_UPPER) != 0), "CTYPE_UPPER is wrong for %d\n", c);
+    }
+    printf("%s() passed\n", __func__);
+}
+
+void test_ctype_is(char c, uint8_t classes, bool expected_result) {
+    // act
+    bool result = ctype_is(c, classes);
+
+    // assert
+    assert_primitive_equality(expected_result, result, "ctype_is('%c', 0x%02x) != %d\n", c, classes, expected_result);
+    printf("%s('%c', 0x%02x, %d) passed\n", __func__, c, classes, expected_result);
+}
+
+void test_ctype_hex_value(char c, int expected_result) {
+    // act
+    int result = ctype_hex_value(c);
+
+    // assert
+    assert_primitive_equality(expected_result, result, "ctype_hex_value('%c') != %d (%d)\n", c, expected_result, result);
+    printf("%s('%c', %d) passed\n", __func__, c, expected_result);
+}
+
+void test_ctype_build_set(uint8_t classes) {
+    // assign
+    simd_byte_set_t set;
+
+    // act
+    ctype_build_set(&set, classes);
+
+    // assert
+    for(int c = 0; c < 256; c++) {
+        assert_primitive_equality(ctype_is((char)c, classes), simd_byte_set_contains(&set, (unsigned char)c), "ctype_build_set(0x%02x) is wrong for %d\n", classes, c);
+    }
+    printf("%s(0x%02x) passed\n", __func__, classes);
+}
+
+int main() {
+    test_ctype_classes_match_ctype_h();
+
+    test_ctype_is('a', CTYPE_VOWEL, true);
+    test_ctype_is('U', CTYPE_VOWEL, true);
+    test_ctype_is('y', CTYPE_VOWEL, false);
+    test_ctype_is('e', CTYPE_NUMBER, true);
+    test_ctype_is('x', CTYPE_NUMBER, false);
+    test_ctype_is(':', CTYPE_JSON_STRUCTURAL, true);
+    test_ctype_is('"', CTYPE_JSON_STRUCTURAL, false);
+    test_ctype_is('Q', CTYPE_ALPHA, true);
+    test_ctype_is('\xe9', CTYPE_ALPHA | CTYPE_SPACE, false);
+
+    test_ctype_hex_value('0', 0);
+    test_ctype_hex_value('9', 9);
+    test_ctype_hex_value('a', 10);
+    test_ctype_hex_value('F', 15);
+    test_ctype_hex_value('g', -1);
+    test_ctype_hex_value('\xff', -1);
+
+    test_ctype_build_set(CTYPE_VOWEL);
+    test_ctype_build_set(CTYPE_DIGIT | CTYPE_SPACE);
+    test_ctype_build_set(0xFF);
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
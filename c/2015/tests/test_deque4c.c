@@ -0,0 +1,140 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "testing/assertions.h"
+#include "deque4c.h"
+
+void test_deque_push_and_pop_both_ends(size_t capacity) {
+    // assign
+    DequeInt *deque = deque_create_DequeInt(capacity);
+    assert_not_null(deque, "%s\n", "deque_create_DequeInt returned null");
+
+    // act: 0..99 at the back and -1..-100 at the front, forcing the ring to wrap and grow.
+    for(int i = 0; i < 100; i++) {
+        deque_push_back_DequeInt(deque, i);
+        deque_push_front_DequeInt(deque, -i - 1);
+    }
+
+    // assert
+    assert_primitive_equality(deque->size, 200, "deque->size != 200 (%zu)\n", deque->size);
+    assert_primitive_equality(*deque_get_DequeInt(deque, 0), -100, "front != -100 (%d)\n", *deque_get_DequeInt(deque, 0));
+    assert_primitive_equality(*deque_get_DequeInt(deque, 199), 99, "back != 99 (%d)\n", *deque_get_DequeInt(deque, 199));
+
+    for(int i = 99; i >= 0; i--) {
+        int element = 0;
+        deque_pop_back_DequeInt(deque, &element);
+        assert_primitive_equality(element, i, "pop_back returned %d, expected %d\n", element, i);
+    }
+    for(int i = 100; i >= 1; i--) {
+        int element = 0;
+        deque_pop_front_DequeInt(deque, &element);
+        assert_primitive_equality(element, -i, "pop_front returned %d, expected %d\n", element, -i);
+    }
+    assert_primitive_equality(deque_pop_front_DequeInt(deque, NULL), false, "%s\n", "pop_front on an empty deque should fail");
+
+    printf("%s(%zu) passed\n", __func__, capacity);
+    deque_destroy_DequeInt(deque);
+}
+
+void test_deque_bulk(size_t capacity, size_t offset) {
+    // assign
+    DequeSize *deque = deque_create_DequeSize(capacity);
+    size_t elements[50];
+    for(size_t i = 0; i < 50; i++) {
+        elements[i] = i;
+    }
+
+    // Move the head away from zero so the bulk copy has to wrap.
+    for(size_t i = 0; i < offset; i++) {
+        deque_push_back_DequeSize(deque, 0);
+        deque_pop_front_DequeSize(deque, NULL);
+    }
+
+    // act
+    deque_push_back_n_DequeSize(deque, elements, 10);
+    deque_push_back_n_DequeSize(deque, elements + 10, 40);
+    size_t result[50];
+    size_t popped = deque_pop_front_n_DequeSize(deque, result, 64);
+
+    // assert
+    assert_primitive_equality(popped, 50, "popped != 50 (%zu)\n", popped);
+    for(size_t i = 0; i < 50; i++) {
+        assert_primitive_equality(result[i], i, "result[%zu] != %zu (%zu)\n", i, i, result[i]);
+    }
+
+    printf("%s(%zu, %zu) passed\n", __func__, capacity, offset);
+    deque_destroy_DequeSize(deque);
+}
+
+#define SPSC_TEST_COUNT 1000000
+
+static void *spsc_producer(void *argument) {
+    SpscQueuePointer *queue = argument;
+    for(uintptr_t i = 1; i <= SPSC_TEST_COUNT; i++) {
+        while(!spsc_queue_try_push_SpscQueuePointer(queue, (void*)i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+void test_spsc_queue_threads(size_t capacity) {
+    // assign
+    SpscQueuePointer *queue = spsc_queue_create_SpscQueuePointer(capacity);
+    pthread_t producer;
+
+    // act
+    pthread_create(&producer, NULL, spsc_producer, queue);
+    uintptr_t expected = 1;
+    void *batch[32];
+    while(expected <= SPSC_TEST_COUNT) {
+        size_t count = spsc_queue_try_pop_n_SpscQueuePointer(queue, batch, 32);
+        if(count == 0) {
+            sched_yield();
+        }
+        for(size_t i = 0; i < count; i++) {
+            // assert: elements arrive exactly once and in order.
+            assert_primitive_equality((uintptr_t)batch[i], expected, "received %lu, expected %lu\n", (uintptr_t)batch[i], expected);
+            expected++;
+        }
+    }
+    pthread_join(producer, NULL);
+
+    void *element = NULL;
+    assert_primitive_equality(spsc_queue_try_pop_SpscQueuePointer(queue, &element), false, "%s\n", "queue should be empty");
+
+    printf("%s(%zu) passed\n", __func__, capacity);
+    spsc_queue_destroy_SpscQueuePointer(queue);
+}
+
+void test_spsc_queue_full(size_t capacity) {
+    // assign
+    SpscQueuePointer *queue = spsc_queue_create_SpscQueuePointer(capacity);
+    void *elements[64] = {0};
+
+    // act
+    size_t pushed = spsc_queue_try_push_n_SpscQueuePointer(queue, elements, 64);
+
+    // assert
+    assert_primitive_equality(pushed, capacity, "pushed != %zu (%zu)\n", capacity, pushed);
+    assert_primitive_equality(spsc_queue_try_push_SpscQueuePointer(queue, NULL), false, "%s\n", "push into a full queue should fail");
+
+    printf("%s(%zu) passed\n", __func__, capacity);
+    spsc_queue_destroy_SpscQueuePointer(queue);
+}
+
+int main() {
+    test_deque_push_and_pop_both_ends(1);
+    test_deque_push_and_pop_both_ends(256);
+    test_deque_bulk(16, 0);
+    test_deque_bulk(64, 40);
+    test_spsc_queue_threads(8);
+    test_spsc_queue_threads(1024);
+    test_spsc_queue_full(16);
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "testing/assertions.h"
+#include "heap4c.h"
+
+void test_heap_pop_order(size_t arity, heap_order_t order) {
+    // assign
+    int64_t priorities[] = { 5, 3, 9, 1, 7, 3, 8, 2, 6, 4, 0 };
+    size_t length = sizeof(priorities) / sizeof(priorities[0]);
+    heap_t *heap = heap_create(arity, 2, order);
+    assert_not_null(heap, "%s\n", "heap_create returned null");
+
+    // act
+    for(size_t i = 0; i < length; i++) {
+        heap_push(heap, i, priorities[i]);
+    }
+
+    // assert
+    assert_primitive_equality(heap_get_size(heap), length, "heap size != %zu\n", length);
+    heap_entry_t previous;
+    heap_pop(heap, &previous);
+    for(size_t i = 1; i < length; i++) {
+        heap_entry_t entry;
+        assert_true(heap_pop(heap, &entry), "heap_pop failed after %zu pops\n", i);
+        bool in_order = order == HEAP_ORDER_MIN ? previous.priority <= entry.priority : previous.priority >= entry.priority;
+        assert_true(in_order, "%ld was popped after %ld\n", entry.priority, previous.priority);
+        assert_primitive_equality(priorities[entry.id], entry.priority, "entry %zu has the wrong priority %ld\n", entry.id, entry.priority);
+        previous = entry;
+    }
+    assert_primitive_equality(heap_pop(heap, NULL), false, "%s\n", "heap_pop on an empty heap should fail");
+
+    printf("%s(%zu, %d) passed\n", __func__, arity, order);
+    heap_destroy(heap);
+}
+
+void test_indexed_heap_update(size_t arity) {
+    // assign
+    indexed_heap_t *heap = indexed_heap_create(arity, 6, HEAP_ORDER_MIN);
+    for(size_t id = 0; id < 6; id++) {
+        indexed_heap_push(heap, id, 10 * (int64_t)id + 10);
+    }
+
+    // act
+    indexed_heap_decrease_key(heap, 4, 5);
+    indexed_heap_increase_key(heap, 0, 100);
+    bool rejected = indexed_heap_decrease_key(heap, 1, 50);
+
+    // assert
+    assert_primitive_equality(rejected, false, "%s\n", "decrease_key to a higher priority should fail");
+    size_t expected_ids[] = { 4, 1, 2, 3, 5, 0 };
+    for(size_t i = 0; i < 6; i++) {
+        heap_entry_t entry;
+        indexed_heap_pop(heap, &entry);
+        assert_primitive_equality(entry.id, expected_ids[i], "pop %zu returned id %zu, expected %zu\n", i, entry.id, expected_ids[i]);
+    }
+    assert_primitive_equality(indexed_heap_contains(heap, 4), false, "%s\n", "id 4 should have been popped");
+
+    printf("%s(%zu) passed\n", __func__, arity);
+    indexed_heap_destroy(heap);
+}
+
+void test_indexed_heap_remove() {
+    // assign
+    indexed_heap_t *heap = indexed_heap_create(2, 8, HEAP_ORDER_MAX);
+    for(size_t id = 0; id < 8; id++) {
+        indexed_heap_push(heap, id, (int64_t)id);
+    }
+
+    // act
+    indexed_heap_remove(heap, 7);
+    indexed_heap_remove(heap, 3);
+
+    // assert
+    heap_entry_t entry;
+    indexed_heap_peek(heap, &entry);
+    assert_primitive_equality(entry.id, 6, "top id != 6 (%zu)\n", entry.id);
+    assert_primitive_equality(indexed_heap_get_size(heap), 6, "size != 6 (%zu)\n", indexed_heap_get_size(heap));
+    size_t expected_ids[] = { 6, 5, 4, 2, 1, 0 };
+    for(size_t i = 0; i < 6; i++) {
+        indexed_heap_pop(heap, &entry);
+        assert_primitive_equality(entry.id, expected_ids[i], "pop %zu returned id %zu, expected %zu\n", i, entry.id, expected_ids[i]);
+    }
+
+    printf("%s passed\n", __func__);
+    indexed_heap_destroy(heap);
+}
+
+void test_indexed_heap_top_ties(size_t arity) {
+    // assign
+    int64_t priorities[] = { 4, 9, 2, 9, 9, 1, 9, 3 };
+    indexed_heap_t *heap = indexed_heap_create(arity, 8, HEAP_ORDER_MAX);
+    for(size_t id = 0; id < 8; id++) {
+        indexed_heap_push(heap, id, priorities[id]);
+    }
+
+    // act
+    size_t ties[8];
+    size_t number_of_ties = indexed_heap_top_ties(heap, ties, 8);
+
+    // assert
+    assert_primitive_equality(number_of_ties, 4, "number of ties != 4 (%zu)\n", number_of_ties);
+    for(size_t i = 0; i < number_of_ties; i++) {
+        assert_primitive_equality(priorities[ties[i]], 9, "id %zu is not tied for the top\n", ties[i]);
+    }
+
+    size_t truncated = indexed_heap_top_ties(heap, ties, 2);
+    assert_primitive_equality(truncated, 4, "truncated number of ties != 4 (%zu)\n", truncated);
+
+    printf("%s(%zu) passed\n", __func__, arity);
+    indexed_heap_destroy(heap);
+}
+
+int main() {
+    test_heap_pop_order(2, HEAP_ORDER_MIN);
+    test_heap_pop_order(4, HEAP_ORDER_MIN);
+    test_heap_pop_order(3, HEAP_ORDER_MAX);
+    test_indexed_heap_update(2);
+    test_indexed_heap_update(4);
+    test_indexed_heap_remove();
+    test_indexed_heap_top_ties(2);
+    test_indexed_heap_top_ties(4);
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
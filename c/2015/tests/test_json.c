@@ -1,9 +1,17 @@
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include "json/cursor.h"
+#include "json/dom.h"
+#include "json/index.h"
+#include "json/key_index.h"
 #include "json/lexer.h"
+#include "json/number.h"
 #include "json/parser.h"
+#include "json/sax.h"
 #include "json/token.h"
+#include "simd4c.h"
 
 void assert_size_and_type(const char *test_name, json_node_t *node, json_node_type_t expected_type, size_t expected_size) {
     if(node->type != expected_type) {
@@ -35,8 +43,9 @@ void assert_size_and_type(const char *test_name, json_node_t *node, json_node_ty
 void test_empty_object() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{}", &number_of_tokens);
-    json_node_t *node = json_parse(tokens, &current_token_index, true);
+    const char *str = "{}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
+    json_node_t *node = json_parse(str, tokens, &current_token_index, true);
 
     assert_size_and_type(__func__, node, JSON_NODE_TYPE_OBJECT, 0);
 
@@ -60,8 +69,9 @@ void test_json_lex(char *str, json_token_t *expected, size_t expected_len) {
             exit(EXIT_FAILURE);
         }
 
-        if(tokens[i].type == JSON_TOKEN_TYPE_STRING && strcmp(tokens[i].value.string_value, expected[i].value.string_value) != 0) {
-            printf("%s(\"%s\") failed: tokens[%zu].value.string_value != %s (%s)\n", __func__, str, i, expected[i].value.string_value, tokens[i].value.string_value);
+        if(tokens[i].offset != expected[i].offset || tokens[i].length != expected[i].length) {
+            string_view_t view = json_token_get_view(str, &tokens[i]);
+            printf("%s(\"%s\") failed: tokens[%zu] != %u+%u (%u+%u, %.*s)\n", __func__, str, i, expected[i].offset, expected[i].length, tokens[i].offset, tokens[i].length, (int)view.length, view.data);
             exit(EXIT_FAILURE);
         }
     }
@@ -70,11 +80,126 @@ void test_json_lex(char *str, json_token_t *expected, size_t expected_len) {
     free(tokens);
 }
 
+void test_json_lex_rejects(char *str) {
+    size_t len = 0;
+    json_token_t *tokens = json_lex(str, &len);
+
+    if(tokens != NULL) {
+        printf("%s(\"%s\") failed: the string was lexed into %zu tokens\n", __func__, str, len);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
+void test_json_token_size() {
+    if(sizeof(json_token_t) > 16) {
+        printf("%s failed: sizeof(json_token_t) > 16 (%zu)\n", __func__, sizeof(json_token_t));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s passed\n", __func__);
+}
+
+void test_json_number_parse(char *str, size_t expected_consumed, json_number_type_t expected_type, double expected_value) {
+    json_number_t number = { .type = JSON_NUMBER_TYPE_INTEGER };
+
+    size_t consumed = json_number_parse(str, strlen(str), &number);
+
+    if(consumed != expected_consumed) {
+        printf("%s(\"%s\") failed: consumed != %zu (%zu)\n", __func__, str, expected_consumed, consumed);
+        exit(EXIT_FAILURE);
+    }
+
+    if(expected_consumed > 0 && (number.type != expected_type || json_number_get_double(number) != expected_value
+        || (expected_type == JSON_NUMBER_TYPE_INTEGER && number.as.integer != (int64_t)expected_value))) {
+        printf("%s(\"%s\") failed: number != %d/%g (%d/%g)\n", __func__, str, expected_type, expected_value, number.type, json_number_get_double(number));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
+// Integers and doubles keep their type in every kind of tree.
+void test_json_parse_numbers() {
+    const char *str                 = "[1, -2.5, 1e2, 9223372036854775807, -9223372036854775809]";
+    json_number_type_t types[]      = { JSON_NUMBER_TYPE_INTEGER, JSON_NUMBER_TYPE_DOUBLE, JSON_NUMBER_TYPE_DOUBLE, JSON_NUMBER_TYPE_INTEGER, JSON_NUMBER_TYPE_DOUBLE };
+    double values[]                 = { 1, -2.5, 100, 9223372036854775807.0, -9223372036854775809.0 };
+    json_document_t *document       = json_document_parse(str);
+    json_node_t *root_node          = json_parse_string(str);
+
+    if(document == NULL || root_node == NULL) {
+        printf("%s failed: the numbers were not parsed\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    const json_value_t *root    = json_document_get_root(document);
+    json_array_t *root_array    = root_node->value;
+    for(size_t i = 0; i < 5; i++) {
+        const json_value_t *value   = &root->as.elements[i];
+        double real                 = value->number_type == JSON_NUMBER_TYPE_INTEGER ? (double)value->as.number : value->as.real;
+        if(value->type != JSON_VALUE_TYPE_NUMBER || value->number_type != types[i] || real != values[i]) {
+            printf("%s failed: document[%zu] != %d/%g (%d/%g)\n", __func__, i, types[i], values[i], value->number_type, real);
+            exit(EXIT_FAILURE);
+        }
+
+        json_number_t *number = root_array->nodes[i]->value;
+        if(root_array->nodes[i]->type != JSON_NODE_TYPE_NUMBER || number->type != types[i] || json_number_get_double(*number) != values[i]) {
+            printf("%s failed: node[%zu] != %d/%g (%d/%g)\n", __func__, i, types[i], values[i], number->type, json_number_get_double(*number));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if(root->as.elements[3].as.number != INT64_MAX) {
+        printf("%s failed: document[3] != INT64_MAX (%lld)\n", __func__, (long long)root->as.elements[3].as.number);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s passed\n", __func__);
+    json_document_destroy(document);
+    json_node_destroy(root_node);
+}
+
+void test_json_token_values() {
+    const char *str = "[\"a\\\"b\", -42, true, false]";
+    size_t len = 0;
+    json_token_t *tokens = json_lex(str, &len);
+
+    char *string = json_token_get_string(str, &tokens[1]);
+    if(string == NULL || strcmp(string, "a\\\"b") != 0) {
+        printf("%s failed: string != a\\\"b (%s)\n", __func__, string);
+        exit(EXIT_FAILURE);
+    }
+
+    int number = 0;
+    if(!json_token_get_int(str, &tokens[3], &number) || number != -42) {
+        printf("%s failed: number != -42 (%d)\n", __func__, number);
+        exit(EXIT_FAILURE);
+    }
+
+    bool first = false;
+    bool second = true;
+    if(!json_token_get_bool(str, &tokens[5], &first) || !json_token_get_bool(str, &tokens[7], &second) || !first || second) {
+        printf("%s failed: bools != true, false (%d, %d)\n", __func__, first, second);
+        exit(EXIT_FAILURE);
+    }
+
+    if(json_token_get_int(str, &tokens[1], &number) || json_token_get_string(str, &tokens[3]) != NULL) {
+        printf("%s failed: a token was decoded as the wrong type\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s passed\n", __func__);
+    free(string);
+    free(tokens);
+}
+
 void test_basic_object() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"foo\": \"bar\"}", &number_of_tokens);
-    json_node_t *node = json_parse(tokens, &current_token_index, true);
+    const char *str = "{\"foo\": \"bar\"}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
+    json_node_t *node = json_parse(str, tokens, &current_token_index, true);
 
     assert_size_and_type(__func__, node, JSON_NODE_TYPE_OBJECT, 1);
 
@@ -108,8 +233,9 @@ void test_basic_object() {
 void test_basic_object_with_single_character_property() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"f\": \"b\"}", &number_of_tokens);
-    json_node_t *node = json_parse(tokens, &current_token_index, true);
+    const char *str = "{\"f\": \"b\"}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
+    json_node_t *node = json_parse(str, tokens, &current_token_index, true);
 
     assert_size_and_type(__func__, node, JSON_NODE_TYPE_OBJECT, 1);
 
@@ -138,8 +264,9 @@ void test_basic_object_with_single_character_property() {
 void test_number_object() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"foo\": 1}", &number_of_tokens);
-    json_node_t *node = json_parse(tokens, &current_token_index, true);
+    const char *str = "{\"foo\": 1}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
+    json_node_t *node = json_parse(str, tokens, &current_token_index, true);
 
     assert_size_and_type(__func__, node, JSON_NODE_TYPE_OBJECT, 1);
 
@@ -150,8 +277,8 @@ void test_number_object() {
         exit(EXIT_FAILURE);
     }
 
-    if(*(int*)foo->value != 1) {
-        printf("%s failed: int value != 1 (%d)\n", __func__, *(int*)foo->value);
+    if((int)((json_number_t*)foo->value)->as.integer != 1) {
+        printf("%s failed: int value != 1 (%d)\n", __func__, (int)((json_number_t*)foo->value)->as.integer);
         exit(EXIT_FAILURE);
     }
 
@@ -163,8 +290,9 @@ void test_number_object() {
 void test_empty_array() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"foo\": []}", &number_of_tokens);
-    json_node_t *node = json_parse(tokens, &current_token_index, true);
+    const char *str = "{\"foo\": []}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
+    json_node_t *node = json_parse(str, tokens, &current_token_index, true);
 
     assert_size_and_type(__func__, node, JSON_NODE_TYPE_OBJECT, 1);
 
@@ -181,8 +309,9 @@ void test_empty_array() {
 void test_basic_array() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"foo\": [1,2,\"three\"]}", &number_of_tokens);
-    json_node_t *node = json_parse(tokens, &current_token_index, true);
+    const char *str = "{\"foo\": [1,2,\"three\"]}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
+    json_node_t *node = json_parse(str, tokens, &current_token_index, true);
 
     assert_size_and_type(__func__, node, JSON_NODE_TYPE_OBJECT, 1);
 
@@ -199,9 +328,10 @@ void test_basic_array() {
 void test_nested_object() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"foo\": {\"bar\": 2}}", &number_of_tokens);
+    const char *str = "{\"foo\": {\"bar\": 2}}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
 
-    json_node_t *root_node = json_parse(tokens, &current_token_index, true);
+    json_node_t *root_node = json_parse(str, tokens, &current_token_index, true);
     assert_size_and_type(__func__, root_node, JSON_NODE_TYPE_OBJECT, 1);
     json_object_t *root_object = (json_object_t*)root_node->value;
 
@@ -210,7 +340,7 @@ void test_nested_object() {
     json_object_t *foo_object = (json_object_t*)foo_node->value;
 
     json_node_t *bar_node = json_object_get(foo_object, "bar");
-    int bar_number = *(int*)bar_node->value;
+    int bar_number = (int)((json_number_t*)bar_node->value)->as.integer;
 
     if(bar_number != 2) {
         printf("%s failed: number != 2 (%d)\n", __func__, bar_number);
@@ -227,9 +357,10 @@ void test_bool(char *bool_value, bool expected) {
     sprintf(json_string, "{\"foo\": %s}", bool_value);
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex(json_string, &number_of_tokens);
+    const char *str = json_string;
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
 
-    json_node_t *root_node = json_parse(tokens, &current_token_index, true);
+    json_node_t *root_node = json_parse(str, tokens, &current_token_index, true);
     assert_size_and_type(__func__, root_node, JSON_NODE_TYPE_OBJECT, 1);
     json_object_t *root_object = (json_object_t*)root_node->value;
 
@@ -249,9 +380,10 @@ void test_bool(char *bool_value, bool expected) {
 void test_null() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"foo\": null}", &number_of_tokens);
+    const char *str = "{\"foo\": null}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
     
-    json_node_t *root_node = json_parse(tokens, &current_token_index, true);
+    json_node_t *root_node = json_parse(str, tokens, &current_token_index, true);
     assert_size_and_type(__func__, root_node, JSON_NODE_TYPE_OBJECT, 1);
     json_object_t *root_object = (json_object_t*)root_node->value;
 
@@ -269,9 +401,10 @@ void test_null() {
 void test_object_with_multiple_properties() {
     size_t number_of_tokens = 0;
     size_t current_token_index = 0;
-    json_token_t *tokens = json_lex("{\"e\": \"green\", \"a\": 77}", &number_of_tokens);
+    const char *str = "{\"e\": \"green\", \"a\": 77}";
+    json_token_t *tokens = json_lex(str, &number_of_tokens);
 
-    json_node_t *root_node = json_parse(tokens, &current_token_index, true);
+    json_node_t *root_node = json_parse(str, tokens, &current_token_index, true);
     assert_size_and_type(__func__, root_node, JSON_NODE_TYPE_OBJECT, 2);
     json_object_t *root_object = (json_object_t*)root_node->value;
 
@@ -286,7 +419,7 @@ void test_object_with_multiple_properties() {
     }
 
     json_node_t *a_node = json_object_get(root_object, "a");
-    int a_number = *(int*)a_node->value;
+    int a_number = (int)((json_number_t*)a_node->value)->as.integer;
     if(a_number != 77) {
         printf("%s failed: a != 77 (%d)\n", __func__, a_number);
         exit(EXIT_FAILURE);
@@ -297,39 +430,789 @@ void test_object_with_multiple_properties() {
     free(tokens);
 }
 
+void test_json_index_build(char *str, uint32_t *expected, size_t expected_len) {
+    size_t len = 0;
+    uint32_t *index = json_index_build(str, strlen(str), &len);
+
+    if(len != expected_len) {
+        printf("%s(\"%s\") failed: length != %zu (%zu)\n", __func__, str, expected_len, len);
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t i = 0; i < len; i++) {
+        if(index[i] != expected[i]) {
+            printf("%s(\"%s\") failed: index[%zu] != %u (%u)\n", __func__, str, i, expected[i], index[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+    free(index);
+}
+
+// Builds the index one byte at a time, as a reference for the block-wise version.
+static size_t json_index_build_reference(const char *str, size_t length, uint32_t *out_index, bool *out_in_string) {
+    size_t len          = 0;
+    bool escaped        = false;
+    bool in_string      = false;
+    bool in_scalar      = false;
+
+    for(size_t i = 0; i < length; i++) {
+        char c          = str[i];
+        bool is_quote   = c == '"' && !escaped;
+        escaped         = c == '\\' && !escaped;
+
+        if(in_string || is_quote) {
+            if(is_quote) {
+                out_index[len++]    = (uint32_t)i;
+                in_string           = !in_string;
+            }
+            in_scalar = false;
+        }
+        else if(strchr("{}[]:,", c) != NULL) {
+            out_index[len++]    = (uint32_t)i;
+            in_scalar           = false;
+        }
+        else if(strchr(" \t\n\r", c) != NULL) {
+            in_scalar = false;
+        }
+        else {
+            if(!in_scalar) {
+                out_index[len++] = (uint32_t)i;
+            }
+            in_scalar = true;
+        }
+    }
+
+    *out_in_string = in_string;
+    return len;
+}
+
+/**
+ * Builds the index of random documents made of the bytes that matter to it, with long runs of backslashes and strings
+ * crossing block boundaries, and compares it with the byte at a time reference on every supported instruction set.
+ */
+void test_json_index_matches_reference(simd_isa_t isa) {
+    const char *alphabet    = "\"\\\\\\{}[]:, \n1a";
+    size_t alphabet_length  = strlen(alphabet);
+    char str[300];
+    uint32_t expected[300];
+    uint32_t state          = 12345;
+    simd_isa_t detected_isa = simd_get_isa();
+
+    if(!simd_set_isa(isa)) {
+        printf("%s skipped instruction set %d, which is not supported on this CPU\n", __func__, isa);
+        return;
+    }
+
+    for(size_t round = 0; round < 2000; round++) {
+        size_t length = round % 300;
+        for(size_t i = 0; i < length; i++) {
+            state   = state * 1103515245u + 12345u;
+            str[i]  = alphabet[(state >> 16) % alphabet_length];
+        }
+
+        // Unterminated strings are rejected, which is covered elsewhere.
+        bool in_string          = false;
+        size_t expected_len     = json_index_build_reference(str, length, expected, &in_string);
+        if(in_string) {
+            continue;
+        }
+
+        size_t len              = 0;
+        uint32_t *index         = json_index_build(str, length, &len);
+
+        if(index == NULL || len != expected_len || memcmp(index, expected, len * sizeof(uint32_t)) != 0) {
+            printf("%s failed: round %zu (\"%.*s\") differs from the reference\n", __func__, round, (int)length, str);
+            exit(EXIT_FAILURE);
+        }
+        free(index);
+    }
+
+    simd_set_isa(detected_isa);
+    printf("%s(%d) passed\n", __func__, isa);
+}
+
+void test_json_document_parse() {
+    json_document_t *document = json_document_parse("{\"a\": [1, -2, {\"b\": \"red\"}], \"c\": true, \"d\": null, \"e\": {}, \"f\": []}");
+    if(document == NULL) {
+        printf("%s failed: document == NULL\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    const json_value_t *root = json_document_get_root(document);
+    if(root->type != JSON_VALUE_TYPE_OBJECT || root->length != 5) {
+        printf("%s failed: root is not an object with 5 members (%d, %u)\n", __func__, root->type, root->length);
+        exit(EXIT_FAILURE);
+    }
+
+    const json_value_t *a = json_value_get(root, "a");
+    if(a == NULL || a->type != JSON_VALUE_TYPE_ARRAY || a->length != 3 || a->as.elements[0].as.number != 1 || a->as.elements[1].as.number != -2) {
+        printf("%s failed: a != [1, -2, {...}]\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    const json_value_t *b = json_value_get(&a->as.elements[2], "b");
+    if(b == NULL || b->type != JSON_VALUE_TYPE_STRING || b->length != 3 || strcmp(b->as.string, "red") != 0) {
+        printf("%s failed: a[2].b != red\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    const json_value_t *c = json_value_get(root, "c");
+    const json_value_t *d = json_value_get(root, "d");
+    const json_value_t *e = json_value_get(root, "e");
+    const json_value_t *f = json_value_get(root, "f");
+    if(c == NULL || c->type != JSON_VALUE_TYPE_BOOL || !c->as.boolean || d == NULL || d->type != JSON_VALUE_TYPE_NULL) {
+        printf("%s failed: c != true or d != null\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+    if(e == NULL || e->type != JSON_VALUE_TYPE_OBJECT || e->length != 0 || f == NULL || f->type != JSON_VALUE_TYPE_ARRAY || f->length != 0) {
+        printf("%s failed: e != {} or f != []\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    if(json_value_get(root, "missing") != NULL || json_value_get(a, "a") != NULL) {
+        printf("%s failed: a missing member was found\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s passed\n", __func__);
+    json_document_destroy(document);
+}
+
+void test_json_document_parse_rejects(char *str) {
+    json_document_t *document = json_document_parse(str);
+
+    if(document != NULL) {
+        printf("%s(\"%s\") failed: the document was accepted\n", __func__, str);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
+// Builds a document wide enough to make the builder grow its scratch stack many times.
+void test_json_document_parse_large() {
+    size_t count    = 20000;
+    char *str       = malloc(count * 16 + 16);
+    size_t length   = 0;
+
+    str[length++] = '[';
+    for(size_t i = 0; i < count; i++) {
+        length += sprintf(str + length, "%s[{\"n\": %zu}]", i > 0 ? "," : "", i);
+    }
+    str[length++] = ']';
+    str[length]   = '\0';
+
+    json_document_t *document   = json_document_parse(str);
+    const json_value_t *root    = document != NULL ? json_document_get_root(document) : NULL;
+    if(root == NULL || root->length != count) {
+        printf("%s failed: root does not have %zu elements\n", __func__, count);
+        exit(EXIT_FAILURE);
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        const json_value_t *n = json_value_get(&root->as.elements[i].as.elements[0], "n");
+        if(n == NULL || n->as.number != (int64_t)i) {
+            printf("%s failed: element %zu is wrong\n", __func__, i);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    printf("%s passed\n", __func__);
+    json_document_destroy(document);
+    free(str);
+}
+
+// Builds an object with enough keys to get a hash index, ending with a duplicate of an earlier key.
+static char *create_wide_object(size_t number_of_keys) {
+    char *str       = malloc(number_of_keys * 24 + 32);
+    size_t length   = 0;
+
+    str[length++] = '{';
+    for(size_t i = 0; i < number_of_keys; i++) {
+        length += sprintf(str + length, "\"key%zu\": %zu, ", i, i);
+    }
+    length += sprintf(str + length, "\"key5\": -1}");
+    return str;
+}
+
+void test_object_get_with_index(size_t number_of_keys) {
+    char *str = create_wide_object(number_of_keys);
+    json_node_t *root_node = json_parse_string(str);
+    assert_size_and_type(__func__, root_node, JSON_NODE_TYPE_OBJECT, number_of_keys + 1);
+    json_object_t *root_object = (json_object_t*)root_node->value;
+
+    for(size_t i = 0; i < number_of_keys; i++) {
+        char key[32];
+        sprintf(key, "key%zu", i);
+        json_node_t *node = json_object_get(root_object, key);
+        if(node == NULL || (int)((json_number_t*)node->value)->as.integer != (int)i) {
+            printf("%s(%zu) failed: %s != %zu\n", __func__, number_of_keys, key, i);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if(json_object_get(root_object, "key") != NULL || json_object_get(root_object, "missing") != NULL) {
+        printf("%s(%zu) failed: a missing key was found\n", __func__, number_of_keys);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(%zu) passed\n", __func__, number_of_keys);
+    json_node_destroy(root_node);
+    free(str);
+}
+
+void test_json_value_get_with_index(size_t number_of_keys) {
+    char *str = create_wide_object(number_of_keys);
+    json_document_t *document = json_document_parse(str);
+    const json_value_t *root = json_document_get_root(document);
+
+    for(size_t i = 0; i < number_of_keys; i++) {
+        char key[32];
+        sprintf(key, "key%zu", i);
+        const json_value_t *value = json_value_get(root, key);
+        if(value == NULL || value->as.number != (int64_t)i) {
+            printf("%s(%zu) failed: %s != %zu\n", __func__, number_of_keys, key, i);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if(json_value_get(root, "key") != NULL || json_value_get(root, "missing") != NULL) {
+        printf("%s(%zu) failed: a missing key was found\n", __func__, number_of_keys);
+        exit(EXIT_FAILURE);
+    }
+
+    // Members keep the order they were written in.
+    if(strcmp(root->as.members[0].key, "key0") != 0 || strcmp(root->as.members[number_of_keys].key, "key5") != 0) {
+        printf("%s(%zu) failed: the members are out of order\n", __func__, number_of_keys);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(%zu) passed\n", __func__, number_of_keys);
+    json_document_destroy(document);
+    free(str);
+}
+
+// Records every event as one character, with keys, strings and numbers written out, so a whole parse can be compared
+// with a single string.
+typedef struct sax_recorder_t {
+    char    events[1024];
+    size_t  length;
+    size_t  stop_after;
+} sax_recorder_t;
+
+static bool sax_record(sax_recorder_t *recorder, const char *format, size_t length, const char *text) {
+    recorder->length += snprintf(recorder->events + recorder->length, sizeof(recorder->events) - recorder->length, format, (int)length, text);
+    return recorder->stop_after == 0 || --recorder->stop_after > 0;
+}
+
+static bool sax_on_object_start(void *context) { return sax_record(context, "{%.*s", 0, ""); }
+static bool sax_on_object_end(void *context) { return sax_record(context, "}%.*s", 0, ""); }
+static bool sax_on_array_start(void *context) { return sax_record(context, "[%.*s", 0, ""); }
+static bool sax_on_array_end(void *context) { return sax_record(context, "]%.*s", 0, ""); }
+static bool sax_on_key(string_view_t key, void *context) { return sax_record(context, "k%.*s", key.length, key.data); }
+static bool sax_on_string(string_view_t value, void *context) { return sax_record(context, "s%.*s", value.length, value.data); }
+static bool sax_on_bool(bool value, void *context) { return sax_record(context, "b%.*s", 1, value ? "1" : "0"); }
+static bool sax_on_null(void *context) { return sax_record(context, "n%.*s", 0, ""); }
+
+static bool sax_on_number(int64_t value, void *context) {
+    char number[32];
+    int length = snprintf(number, sizeof(number), "%lld", (long long)value);
+    return sax_record(context, "i%.*s", length, number);
+}
+
+static bool sax_on_double(double value, void *context) {
+    char number[32];
+    int length = snprintf(number, sizeof(number), "%g", value);
+    return sax_record(context, "d%.*s", length, number);
+}
+
+static const json_sax_handler_t sax_recording_handler = {
+    .on_object_start    = sax_on_object_start,
+    .on_object_end      = sax_on_object_end,
+    .on_array_start     = sax_on_array_start,
+    .on_array_end       = sax_on_array_end,
+    .on_key             = sax_on_key,
+    .on_number          = sax_on_number,
+    .on_double          = sax_on_double,
+    .on_string          = sax_on_string,
+    .on_bool            = sax_on_bool,
+    .on_null            = sax_on_null
+};
+
+void test_json_sax_parse(char *str, bool expected_result, char *expected_events, size_t stop_after) {
+    sax_recorder_t recorder = { .length = 0, .stop_after = stop_after };
+    recorder.events[0]      = '\0';
+
+    bool result = json_sax_parse(str, strlen(str), &sax_recording_handler, &recorder);
+
+    if(result != expected_result) {
+        printf("%s(\"%s\") failed: result != %d\n", __func__, str, expected_result);
+        exit(EXIT_FAILURE);
+    }
+
+    if(expected_events != NULL && strcmp(recorder.events, expected_events) != 0) {
+        printf("%s(\"%s\") failed: events != %s (%s)\n", __func__, str, expected_events, recorder.events);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
+static bool sax_sum_number(int64_t value, void *context) {
+    *(int64_t*)context += value;
+    return true;
+}
+
+// Nests arrays deeper than the container stack starts out with, so it has to grow onto the heap.
+void test_json_sax_parse_deep_nesting() {
+    size_t depth    = 10000;
+    char *str       = malloc(2 * depth + 2);
+    memset(str, '[', depth);
+    str[depth] = '7';
+    memset(str + depth + 1, ']', depth);
+    str[2 * depth + 1] = '\0';
+
+    int64_t sum = 0;
+    json_sax_handler_t handler = { .on_number = sax_sum_number };
+    if(!json_sax_parse(str, strlen(str), &handler, &sum) || sum != 7) {
+        printf("%s failed: sum != 7 (%lld)\n", __func__, (long long)sum);
+        exit(EXIT_FAILURE);
+    }
+
+    str[2 * depth] = '\0'; // One closing bracket short.
+    if(json_sax_parse(str, strlen(str), &handler, &sum)) {
+        printf("%s failed: an unclosed array was accepted\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s passed\n", __func__);
+    free(str);
+}
+
+// Walks a document with the cursor and raises the same events a SAX parse would, so the two can be compared.
+static bool cursor_replay(json_cursor_t *cursor, const json_sax_handler_t *handler, void *context) {
+    json_value_type_t type;
+    string_view_t view;
+    json_number_t number;
+    bool boolean;
+
+    if(!json_cursor_peek(cursor, &type)) {
+        return false;
+    }
+    switch(type) {
+        case JSON_VALUE_TYPE_OBJECT:
+        case JSON_VALUE_TYPE_ARRAY:
+            if(type == JSON_VALUE_TYPE_OBJECT ? !handler->on_object_start(context) : !handler->on_array_start(context)) {
+                return false;
+            }
+            json_cursor_enter(cursor);
+            while(json_cursor_next(cursor, &view)) {
+                if(type == JSON_VALUE_TYPE_OBJECT) {
+                    handler->on_key(view, context);
+                }
+                if(!cursor_replay(cursor, handler, context)) {
+                    return false;
+                }
+            }
+            if(cursor->error) {
+                return false;
+            }
+            return type == JSON_VALUE_TYPE_OBJECT ? handler->on_object_end(context) : handler->on_array_end(context);
+        case JSON_VALUE_TYPE_STRING:
+            return json_cursor_get_string(cursor, &view) && handler->on_string(view, context);
+        case JSON_VALUE_TYPE_NUMBER:
+            if(!json_cursor_get_number(cursor, &number)) {
+                return false;
+            }
+            return number.type == JSON_NUMBER_TYPE_INTEGER ? handler->on_number(number.as.integer, context) : handler->on_double(number.as.real, context);
+        case JSON_VALUE_TYPE_BOOL:
+            return json_cursor_get_bool(cursor, &boolean) && handler->on_bool(boolean, context);
+        default:
+            return json_cursor_skip(cursor) && handler->on_null(context);
+    }
+}
+
+void test_json_cursor_matches_sax(char *str, bool expected_result) {
+    sax_recorder_t expected = { .length = 0 };
+    sax_recorder_t actual   = { .length = 0 };
+    expected.events[0]      = '\0';
+    actual.events[0]        = '\0';
+    json_cursor_t cursor;
+
+    json_sax_parse(str, strlen(str), &sax_recording_handler, &expected);
+    bool result = json_cursor_init(&cursor, str, strlen(str)) && cursor_replay(&cursor, &sax_recording_handler, &actual);
+
+    if(result != expected_result) {
+        printf("%s(\"%s\") failed: result != %d\n", __func__, str, expected_result);
+        exit(EXIT_FAILURE);
+    }
+
+    if(expected_result && strcmp(actual.events, expected.events) != 0) {
+        printf("%s(\"%s\") failed: events != %s (%s)\n", __func__, str, expected.events, actual.events);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+    json_cursor_free(&cursor);
+}
+
+// The value is identified by the text it starts with, or NULL if the pointer must not resolve.
+void test_json_cursor_find(char *str, char *pointer, char *expected) {
+    json_cursor_t cursor;
+    json_cursor_init(&cursor, str, strlen(str));
+
+    bool found = json_cursor_find(&cursor, pointer);
+
+    if(found != (expected != NULL)) {
+        printf("%s(\"%s\", \"%s\") failed: found != %d\n", __func__, str, pointer, expected != NULL);
+        exit(EXIT_FAILURE);
+    }
+
+    if(found && strncmp(str + cursor.index[cursor.position], expected, strlen(expected)) != 0) {
+        printf("%s(\"%s\", \"%s\") failed: value != %s (%s)\n", __func__, str, pointer, expected, str + cursor.index[cursor.position]);
+        exit(EXIT_FAILURE);
+    }
+
+    if(!found && cursor.position != 0) {
+        printf("%s(\"%s\", \"%s\") failed: the cursor moved to entry %zu\n", __func__, str, pointer, cursor.position);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\", \"%s\") passed\n", __func__, str, pointer);
+    json_cursor_free(&cursor);
+}
+
+// Sums every number outside of objects with a "red" value, leaving such an object as soon as the value is seen.
+static int64_t cursor_sum_without_red(json_cursor_t *cursor) {
+    json_value_type_t type;
+    json_value_type_t member_type;
+    string_view_t value;
+    int64_t sum = 0;
+
+    json_cursor_peek(cursor, &type);
+    switch(type) {
+        case JSON_VALUE_TYPE_NUMBER:
+            json_cursor_get_int64(cursor, &sum);
+            return sum;
+        case JSON_VALUE_TYPE_ARRAY:
+        case JSON_VALUE_TYPE_OBJECT:
+            json_cursor_enter(cursor);
+            while(json_cursor_next(cursor, NULL)) {
+                if(type == JSON_VALUE_TYPE_OBJECT && json_cursor_peek(cursor, &member_type) && member_type == JSON_VALUE_TYPE_STRING) {
+                    json_cursor_get_string(cursor, &value);
+                    if(string_view_equals_cstr(value, "red")) {
+                        json_cursor_leave(cursor);
+                        return 0;
+                    }
+                    continue;
+                }
+                sum += cursor_sum_without_red(cursor);
+            }
+            return sum;
+        default:
+            json_cursor_skip(cursor);
+            return 0;
+    }
+}
+
+void test_json_cursor_leave(char *str, int64_t expected) {
+    json_cursor_t cursor;
+    json_cursor_init(&cursor, str, strlen(str));
+
+    int64_t sum = cursor_sum_without_red(&cursor);
+
+    if(sum != expected || cursor.error || cursor.position != cursor.index_length) {
+        printf("%s(\"%s\") failed: sum != %lld (%lld), or the cursor stopped at entry %zu of %zu\n", __func__, str, (long long)expected, (long long)sum, cursor.position, cursor.index_length);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+    json_cursor_free(&cursor);
+}
+
+void test_json_cursor_next_without_key(char *str) {
+    json_cursor_t cursor;
+    json_cursor_init(&cursor, str, strlen(str));
+
+    string_view_t key = string_view_create(str, strlen(str));
+    bool result = json_cursor_enter(&cursor) && json_cursor_next(&cursor, &key);
+
+    if(result && key.length != 0) {
+        printf("%s(\"%s\") failed: key != \"\" (\"%.*s\")\n", __func__, str, (int)key.length, key.data);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+    json_cursor_free(&cursor);
+}
+
+static char *create_nested_arrays(size_t depth) {
+    char *str = malloc(2 * depth + 2);
+    memset(str, '[', depth);
+    str[depth] = '7';
+    memset(str + depth + 1, ']', depth);
+    str[2 * depth + 1] = '\0';
+    return str;
+}
+
+// Nests far deeper than the C stack could take one call per level.
+void test_json_parse_string_deep_nesting() {
+    size_t depth        = 1000000;
+    char *str           = create_nested_arrays(depth);
+    size_t max_depth    = 0;
+
+    json_node_t *root = json_parse_string_with_depth(str, &max_depth);
+
+    if(root == NULL || max_depth != depth) {
+        printf("%s failed: max_depth != %zu (%zu)\n", __func__, depth, max_depth);
+        exit(EXIT_FAILURE);
+    }
+
+    json_node_t *node = root;
+    for(size_t i = 0; i < depth; i++) {
+        json_array_t *array = node->value;
+        if(node->type != JSON_NODE_TYPE_ARRAY || array->size != 1) {
+            printf("%s failed: level %zu is not an array with one element\n", __func__, i);
+            exit(EXIT_FAILURE);
+        }
+        node = array->nodes[0];
+    }
+    if(node->type != JSON_NODE_TYPE_NUMBER || (int)((json_number_t*)node->value)->as.integer != 7) {
+        printf("%s failed: the innermost value is not 7\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+    json_node_destroy(root);
+
+    str[2 * depth] = '\0'; // One closing bracket short.
+    if((root = json_parse_string(str)) != NULL) {
+        printf("%s failed: an unclosed array was accepted\n", __func__);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s passed\n", __func__);
+    free(str);
+}
+
+void test_json_parse_rejects(char *str) {
+    json_node_t *node = json_parse_string(str);
+
+    if(node != NULL) {
+        printf("%s(\"%s\") failed: the string was parsed\n", __func__, str);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
+typedef struct visit_recorder_t {
+    int64_t sum;
+    size_t  visited;
+    size_t  deepest;
+    size_t  stop_after;
+} visit_recorder_t;
+
+// Sums numbers, leaving out objects with a member called "skip".
+static json_visit_t visit_sum(const json_value_t *value, const char *key, size_t depth, void *context) {
+    visit_recorder_t *recorder = context;
+    (void)key;
+
+    recorder->visited++;
+    recorder->deepest = depth > recorder->deepest ? depth : recorder->deepest;
+    if(recorder->stop_after != 0 && recorder->visited == recorder->stop_after) {
+        return JSON_VISIT_STOP;
+    }
+    if(value->type == JSON_VALUE_TYPE_NUMBER) {
+        recorder->sum += value->as.number;
+    }
+    if(value->type == JSON_VALUE_TYPE_OBJECT && json_value_get(value, "skip") != NULL) {
+        return JSON_VISIT_SKIP;
+    }
+    return JSON_VISIT_CONTINUE;
+}
+
+void test_json_value_visit(char *str, int64_t expected_sum, size_t expected_visited, size_t expected_max_depth, size_t stop_after) {
+    json_document_t *document   = json_document_parse(str);
+    visit_recorder_t recorder   = { .stop_after = stop_after };
+    size_t max_depth            = 0;
+
+    bool completed = json_value_visit(json_document_get_root(document), visit_sum, &recorder, &max_depth);
+
+    if(completed != (stop_after == 0) || recorder.sum != expected_sum || recorder.visited != expected_visited) {
+        printf("%s(\"%s\") failed: completed, sum, visited != %d, %lld, %zu (%d, %lld, %zu)\n", __func__, str, stop_after == 0, (long long)expected_sum, expected_visited, completed, (long long)recorder.sum, recorder.visited);
+        exit(EXIT_FAILURE);
+    }
+
+    if(stop_after == 0 && (max_depth != expected_max_depth || json_document_get_depth(document) != expected_max_depth)) {
+        printf("%s(\"%s\") failed: max_depth != %zu (%zu, document %zu)\n", __func__, str, expected_max_depth, max_depth, json_document_get_depth(document));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, str);
+    json_document_destroy(document);
+}
+
+void test_json_value_visit_deep_nesting() {
+    size_t depth                = 1000000;
+    char *str                   = create_nested_arrays(depth);
+    json_document_t *document   = json_document_parse(str);
+    visit_recorder_t recorder   = { .stop_after = 0 };
+    size_t max_depth            = 0;
+
+    if(document == NULL || json_document_get_depth(document) != depth) {
+        printf("%s failed: the document is not %zu levels deep\n", __func__, depth);
+        exit(EXIT_FAILURE);
+    }
+
+    if(!json_value_visit(json_document_get_root(document), visit_sum, &recorder, &max_depth) || recorder.sum != 7 || max_depth != depth || recorder.deepest != depth) {
+        printf("%s failed: sum, max_depth != 7, %zu (%lld, %zu)\n", __func__, depth, (long long)recorder.sum, max_depth);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s passed\n", __func__);
+    json_document_destroy(document);
+    free(str);
+}
+
+static bool json_values_equal(const json_value_t *a, const json_value_t *b) {
+    if(a->type != b->type) {
+        return false;
+    }
+    switch(a->type) {
+        case JSON_VALUE_TYPE_BOOL:
+            return a->as.boolean == b->as.boolean;
+        case JSON_VALUE_TYPE_NUMBER:
+            return a->number_type == b->number_type && (a->number_type == JSON_NUMBER_TYPE_INTEGER ? a->as.number == b->as.number : a->as.real == b->as.real);
+        case JSON_VALUE_TYPE_STRING:
+            return a->length == b->length && memcmp(a->as.string, b->as.string, a->length + 1) == 0;
+        case JSON_VALUE_TYPE_ARRAY:
+            for(uint32_t i = 0; a->length == b->length && i < a->length; i++) {
+                if(!json_values_equal(&a->as.elements[i], &b->as.elements[i])) {
+                    return false;
+                }
+            }
+            return a->length == b->length;
+        case JSON_VALUE_TYPE_OBJECT:
+            for(uint32_t i = 0; a->length == b->length && i < a->length; i++) {
+                if(strcmp(a->as.members[i].key, b->as.members[i].key) != 0 || !json_values_equal(&a->as.members[i].value, &b->as.members[i].value)) {
+                    return false;
+                }
+            }
+            return a->length == b->length && (a->length < JSON_KEY_INDEX_THRESHOLD || json_value_get(b, a->as.members[0].key) == &b->as.members[0].value);
+        default:
+            return true;
+    }
+}
+
+// An array of records large enough to be split across several threads.
+static char *create_records(size_t number_of_records) {
+    size_t capacity = number_of_records * 128 + 16;
+    char *str       = malloc(capacity);
+    size_t length   = 0;
+
+    str[length++] = '[';
+    for(size_t i = 0; i < number_of_records; i++) {
+        length += snprintf(str + length, capacity - length, "%s{\"id\": %zu, \"name\": \"record \\\"%zu\\\"\", \"score\": %zu.%02zu, \"tags\": [%s, null, [%zu]]}\n",
+            i == 0 ? "" : ", ", i, i, i % 100, i % 97, i % 2 == 0 ? "true" : "false", i);
+    }
+    str[length++] = ']';
+    str[length]   = '\0';
+    return str;
+}
+
+void test_json_document_parse_parallel(size_t number_of_records, size_t number_of_threads) {
+    char *str                   = create_records(number_of_records);
+    json_document_t *expected   = json_document_parse(str);
+
+    json_document_t *document = json_document_parse_parallel(str, number_of_threads);
+
+    if(document == NULL || !json_values_equal(json_document_get_root(expected), json_document_get_root(document))) {
+        printf("%s(%zu, %zu) failed: the document differs from the one parsed on one thread\n", __func__, number_of_records, number_of_threads);
+        exit(EXIT_FAILURE);
+    }
+
+    if(json_document_get_depth(document) != json_document_get_depth(expected)) {
+        printf("%s(%zu, %zu) failed: depth != %zu (%zu)\n", __func__, number_of_records, number_of_threads, json_document_get_depth(expected), json_document_get_depth(document));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(%zu, %zu) passed\n", __func__, number_of_records, number_of_threads);
+    json_document_destroy(expected);
+    json_document_destroy(document);
+    free(str);
+}
+
+// Breaks a large array in the middle or at the end, where one of the threads has to notice.
+void test_json_document_parse_parallel_rejects(char *damage, bool at_end) {
+    char *str       = create_records(20000);
+    size_t length   = strlen(str);
+    char *position  = at_end ? str + length - strlen(damage) : strstr(str + length / 2, ", {");
+    memcpy(position, damage, strlen(damage));
+
+    json_document_t *document = json_document_parse_parallel(str, 4);
+
+    if(document != NULL) {
+        printf("%s(\"%s\") failed: the damaged document was parsed\n", __func__, damage);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s(\"%s\") passed\n", __func__, damage);
+    free(str);
+}
+
 int main(void) {
     test_json_lex("{}", (json_token_t[]){
-        (json_token_t){
-            .type = JSON_TOKEN_TYPE_LEFT_BRACE,
-            .value.string_value = "{"
-        },
-        (json_token_t){
-            .type = JSON_TOKEN_TYPE_RIGHT_BRACE,
-            .value.string_value = "}"
-        }
+        { .type = JSON_TOKEN_TYPE_LEFT_BRACE, .offset = 0, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_RIGHT_BRACE, .offset = 1, .length = 1 }
     }, 2);
     test_json_lex("{\"foo\": \"bar\"}", (json_token_t[]){
-        (json_token_t){
-            .type = JSON_TOKEN_TYPE_LEFT_BRACE,
-            .value.string_value = "{"
-        },
-        (json_token_t){
-            .type = JSON_TOKEN_TYPE_STRING,
-            .value.string_value = "foo"
-        },
-        (json_token_t){
-            .type = JSON_TOKEN_TYPE_COLON,
-            .value.string_value = ":"
-        },
-        (json_token_t){
-            .type = JSON_TOKEN_TYPE_STRING,
-            .value.string_value = "bar"
-        },
-        (json_token_t){
-            .type = JSON_TOKEN_TYPE_RIGHT_BRACE,
-            .value.string_value = "}"
-        }
+        { .type = JSON_TOKEN_TYPE_LEFT_BRACE, .offset = 0, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_STRING, .offset = 2, .length = 3 },
+        { .type = JSON_TOKEN_TYPE_COLON, .offset = 6, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_STRING, .offset = 9, .length = 3 },
+        { .type = JSON_TOKEN_TYPE_RIGHT_BRACE, .offset = 13, .length = 1 }
+    }, 5);
+    test_json_lex("[-12, true, null]", (json_token_t[]){
+        { .type = JSON_TOKEN_TYPE_LEFT_BRACKET, .offset = 0, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_NUMBER, .offset = 1, .length = 3 },
+        { .type = JSON_TOKEN_TYPE_COMMA, .offset = 4, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_BOOL, .offset = 6, .length = 4 },
+        { .type = JSON_TOKEN_TYPE_COMMA, .offset = 10, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_NULL, .offset = 12, .length = 4 },
+        { .type = JSON_TOKEN_TYPE_RIGHT_BRACKET, .offset = 16, .length = 1 }
+    }, 7);
+    test_json_lex("[1.5e3, -0]", (json_token_t[]){
+        { .type = JSON_TOKEN_TYPE_LEFT_BRACKET, .offset = 0, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_NUMBER, .offset = 1, .length = 5 },
+        { .type = JSON_TOKEN_TYPE_COMMA, .offset = 6, .length = 1 },
+        { .type = JSON_TOKEN_TYPE_NUMBER, .offset = 8, .length = 2 },
+        { .type = JSON_TOKEN_TYPE_RIGHT_BRACKET, .offset = 10, .length = 1 }
     }, 5);
+    test_json_number_parse("0", 1, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_number_parse("-42,", 3, JSON_NUMBER_TYPE_INTEGER, -42);
+    test_json_number_parse("-9223372036854775808", 20, JSON_NUMBER_TYPE_INTEGER, -9223372036854775808.0);
+    test_json_number_parse("9223372036854775808", 19, JSON_NUMBER_TYPE_DOUBLE, 9223372036854775808.0);
+    test_json_number_parse("0.5]", 3, JSON_NUMBER_TYPE_DOUBLE, 0.5);
+    test_json_number_parse("-1.25e-2", 8, JSON_NUMBER_TYPE_DOUBLE, -0.0125);
+    test_json_number_parse("1E+3", 4, JSON_NUMBER_TYPE_DOUBLE, 1000);
+    test_json_number_parse("01", 0, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_number_parse("-01.5", 0, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_number_parse("+1", 0, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_number_parse(".5", 0, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_number_parse("1.", 0, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_number_parse("1e", 0, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_number_parse("-", 0, JSON_NUMBER_TYPE_INTEGER, 0);
+    test_json_parse_numbers();
+    test_json_index_build("{\"a\": [1, true]}", (uint32_t[]){ 0, 1, 3, 4, 6, 7, 8, 10, 14, 15 }, 10);
+    test_json_index_build("[\"x\\\"{,}\", \"\\\\\"]", (uint32_t[]){ 0, 1, 8, 9, 11, 14, 15 }, 7);
+    test_json_index_build("  -12.5e3  ", (uint32_t[]){ 2 }, 1);
+    test_json_index_build("", NULL, 0);
+    test_json_index_matches_reference(SIMD_ISA_SCALAR);
+    test_json_index_matches_reference(SIMD_ISA_SSE2);
+    test_json_index_matches_reference(SIMD_ISA_AVX2);
+    test_json_token_size();
+    test_json_token_values();
     test_empty_object();
     test_basic_object();
     test_basic_object_with_single_character_property();
@@ -341,6 +1224,90 @@ int main(void) {
     test_bool("false", false);
     test_null();
     test_object_with_multiple_properties();
+    test_json_lex_rejects("[1 2x]");
+    test_json_lex_rejects("[\"unterminated]");
+    test_json_lex_rejects("[nul]");
+    test_json_sax_parse("{}", true, "{}", 0);
+    test_json_sax_parse(" [ ] ", true, "[]", 0);
+    test_json_sax_parse("{\"a\": [1, -2, {\"b\": \"red\"}], \"c\": true, \"d\": null}", true, "{ka[i1i-2{kbsred}]kcb1kdn}", 0);
+    test_json_sax_parse("[\"a\\\"b\", false]", true, "[sa\\\"bb0]", 0);
+    test_json_sax_parse("42", true, "i42", 0);
+    test_json_sax_parse("[1, 2, 3]", false, "[i1i2", 3);
+    test_json_sax_parse("", false, "", 0);
+    test_json_sax_parse("[1, 2", false, NULL, 0);
+    test_json_sax_parse("[1 2]", false, NULL, 0);
+    test_json_sax_parse("{\"a\" 1}", false, NULL, 0);
+    test_json_sax_parse("{\"a\": 1]", false, NULL, 0);
+    test_json_sax_parse("[1.5, -0.25e2, 1E3, 9223372036854775808]", true, "[d1.5d-25d1000d9.22337e+18]", 0);
+    test_json_sax_parse("[1.]", false, NULL, 0);
+    test_json_sax_parse("[01]", false, NULL, 0);
+    test_json_sax_parse("[+1]", false, NULL, 0);
+    test_json_sax_parse("[tru]", false, NULL, 0);
+    test_json_sax_parse("[\"unterminated]", false, NULL, 0);
+    test_json_sax_parse("{} {}", false, NULL, 0);
+    test_json_sax_parse("\v[]", false, NULL, 0);
+    test_json_sax_parse("[1\f]", false, NULL, 0);
+    test_json_sax_parse_deep_nesting();
+    test_json_cursor_matches_sax("{\"a\": [1, -2, {\"b\": \"red\"}], \"c\": true, \"d\": null}", true);
+    test_json_cursor_matches_sax("[[], {}, [[\"x\\\"]\"]], 0]", true);
+    test_json_cursor_matches_sax("[1 2]", false);
+    test_json_cursor_matches_sax("[1, 2.5, -3e-2, 18446744073709551616]", true);
+    test_json_cursor_matches_sax("[1, 2.]", false);
+    test_json_cursor_matches_sax("[-01]", false);
+    test_json_cursor_matches_sax("[1,, 2]", false);
+    test_json_cursor_matches_sax("[tru]", false);
+    test_json_cursor_find("{\"a\": [1, {\"b\": 2}], \"c\": \"d\"}", "", "{\"a\"");
+    test_json_cursor_find("{\"a\": [1, {\"b\": 2}], \"c\": \"d\"}", "/a/1/b", "2");
+    test_json_cursor_find("{\"a\": [1, {\"b\": 2}], \"c\": \"d\"}", "/c", "\"d\"");
+    test_json_cursor_find("{\"a\": [1, {\"b\": 2}], \"c\": \"d\"}", "/a/2", NULL);
+    test_json_cursor_find("{\"a\": [1, {\"b\": 2}], \"c\": \"d\"}", "/a/01", NULL);
+    test_json_cursor_find("{\"a\": [1, {\"b\": 2}], \"c\": \"d\"}", "/b", NULL);
+    test_json_cursor_find("{\"a\": [1, {\"b\": 2}], \"c\": \"d\"}", "a", NULL);
+    test_json_cursor_find("{\"a/b\": 1, \"m~n\": 2, \"\": 3}", "/m~0n", "2");
+    test_json_cursor_find("{\"a/b\": 1, \"m~n\": 2, \"\": 3}", "/a~1b", "1");
+    test_json_cursor_find("{\"a/b\": 1, \"m~n\": 2, \"\": 3}", "/", "3");
+    test_json_cursor_leave("[1, {\"c\": \"red\", \"b\": 2}, 3]", 4);
+    test_json_cursor_leave("{\"d\": \"red\", \"e\": [1, 2, 3, 4], \"f\": 5}", 0);
+    test_json_cursor_leave("[1, \"red\", 5]", 6);
+    test_json_cursor_leave("{\"a\": {\"b\": [{\"c\": 1}, 2]}, \"d\": [3, {\"e\": [4], \"f\": \"red\"}]}", 6);
+    test_json_cursor_next_without_key("{1}");
+    test_json_document_parse();
+    test_json_document_parse_rejects("[1, 2");
+    test_json_document_parse_rejects("{\"a\" 1}");
+    test_json_document_parse_rejects("{\"a\": 1]");
+    test_json_document_parse_rejects("[1,]");
+    test_json_document_parse_rejects("{} []");
+    test_json_document_parse_rejects("");
+    test_json_document_parse_rejects("[1\v]");
+    test_json_document_parse_large();
+    test_json_parse_rejects("[1, 2");
+    test_json_parse_rejects("{\"a\" 1}");
+    test_json_parse_rejects("{\"a\": [1}");
+    test_json_parse_rejects("[1,]");
+    test_json_parse_rejects("42");
+    test_json_parse_rejects("[1]]");
+    test_json_parse_rejects("{} {}");
+    test_json_parse_string_deep_nesting();
+    test_json_value_visit("{\"a\": [1, 2, {\"b\": 3}], \"c\": 4}", 10, 7, 3, 0);
+    test_json_value_visit("[1, {\"skip\": 1, \"a\": 2}, [3, [4]]]", 8, 7, 3, 0);
+    test_json_value_visit("5", 5, 1, 0, 0);
+    test_json_value_visit("[]", 0, 1, 1, 0);
+    test_json_value_visit("[1, 2, 3, 4]", 3, 4, 0, 4);
+    test_json_value_visit_deep_nesting();
+    test_json_document_parse_parallel(10, 4);
+    test_json_document_parse_parallel(20000, 1);
+    test_json_document_parse_parallel(20000, 2);
+    test_json_document_parse_parallel(20000, 7);
+    test_json_document_parse_parallel(20000, 1000000);
+    test_json_document_parse_parallel_rejects(",,{", false);
+    test_json_document_parse_parallel_rejects(", }", false);
+    test_json_document_parse_parallel_rejects("]]", true);
+    test_json_document_parse_parallel_rejects(",]", true);
+    test_json_document_parse_parallel_rejects("}", true);
+    test_object_get_with_index(8);
+    test_object_get_with_index(1000);
+    test_json_value_get_with_index(8);
+    test_json_value_get_with_index(1000);
 
     printf("All tests passed\n");
     return EXIT_SUCCESS;
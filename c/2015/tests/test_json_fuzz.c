@@ -0,0 +1,426 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json/cursor.h"
+#include "json/dom.h"
+#include "json/index.h"
+#include "json/lexer.h"
+#include "json/parser.h"
+#include "json/sax.h"
+
+/*
+ * Runs every JSON reader over the same input and checks that they agree on it. Built as a test, it replays a seed corpus
+ * and a fixed number of random mutations of it, or the files given on the command line, which is how a crash found by a
+ * longer run is reproduced. Configured with -DAOC_FUZZ=ON and Clang, the same checks are built into json_fuzzer, which
+ * libFuzzer drives for as long as it is left running:
+ *
+ *  bin/json_fuzzer -max_len=4096 corpus/
+ */
+
+#define FUZZ_MAX_LENGTH 4096
+#ifndef FUZZ_ITERATIONS
+#define FUZZ_ITERATIONS 20000 // Enough for a smoke run under ctest. Build with a larger number for a longer one.
+#endif
+#define FUZZ_PARALLEL_PADDING   (64 * 1024) // Bytes of filler that make a thread's worth of work for dom.c.
+#define FUZZ_PARALLEL_FILLER    "\"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\"" // 63 bytes, and a comma.
+#define FUZZ_PARALLEL_EVERY     256         // Every how many mutations also go through the parallel parser.
+
+static void fuzz_fail(const char *data, size_t length, const char *message) {
+    printf("%s failed: %s on \"%.*s\"\n", __func__, message, (int)length, data);
+    fflush(stdout);
+    abort();
+}
+
+static bool fuzz_count_value(void *context) {
+    (*(size_t*)context)++;
+    return true;
+}
+
+static bool fuzz_count_number(int64_t value, void *context) {
+    (void)value;
+    return fuzz_count_value(context);
+}
+
+static bool fuzz_count_double(double value, void *context) {
+    (void)value;
+    return fuzz_count_value(context);
+}
+
+static bool fuzz_count_string(string_view_t value, void *context) {
+    (void)value;
+    return fuzz_count_value(context);
+}
+
+static bool fuzz_count_bool(bool value, void *context) {
+    (void)value;
+    return fuzz_count_value(context);
+}
+
+static const json_sax_handler_t fuzz_counting_handler = {
+    .on_object_start    = fuzz_count_value,
+    .on_array_start     = fuzz_count_value,
+    .on_number          = fuzz_count_number,
+    .on_double          = fuzz_count_double,
+    .on_string          = fuzz_count_string,
+    .on_bool            = fuzz_count_bool,
+    .on_null            = fuzz_count_value
+};
+
+static json_visit_t fuzz_visit_count(const json_value_t *value, const char *key, size_t depth, void *context) {
+    (void)value;
+    (void)key;
+    (void)depth;
+    (*(size_t*)context)++;
+    return JSON_VISIT_CONTINUE;
+}
+
+/**
+ * fuzz_cursor_walk: Read every value of a document with the cursor, keeping track of the open containers with a counter
+ * so that deeply nested input cannot overflow the stack.
+ */
+static bool fuzz_cursor_walk(json_cursor_t *cursor, size_t *out_count) {
+    size_t depth = 0;
+    json_value_type_t type;
+    string_view_t view;
+    json_number_t number;
+    bool boolean;
+
+    do {
+        if(!json_cursor_peek(cursor, &type)) {
+            return false;
+        }
+        (*out_count)++;
+
+        switch(type) {
+            case JSON_VALUE_TYPE_OBJECT:
+            case JSON_VALUE_TYPE_ARRAY:
+                json_cursor_enter(cursor);
+                depth++;
+                break;
+            case JSON_VALUE_TYPE_STRING:
+                if(!json_cursor_get_string(cursor, &view)) {
+                    return false;
+                }
+                break;
+            case JSON_VALUE_TYPE_NUMBER:
+                if(!json_cursor_get_number(cursor, &number)) {
+                    return false;
+                }
+                break;
+            case JSON_VALUE_TYPE_BOOL:
+                if(!json_cursor_get_bool(cursor, &boolean)) {
+                    return false;
+                }
+                break;
+            default:
+                if(!json_cursor_skip(cursor)) {
+                    return false;
+                }
+                break;
+        }
+
+        // Close every container that has run out of elements, until one has another element or the root is done.
+        while(depth > 0 && !json_cursor_next(cursor, &view)) {
+            if(cursor->error) {
+                return false;
+            }
+            depth--;
+        }
+    } while(depth > 0);
+
+    return cursor->position == cursor->index_length;
+}
+
+static bool fuzz_values_equal(const json_value_t *a, const json_value_t *b) {
+    if(a->type != b->type) {
+        return false;
+    }
+    switch(a->type) {
+        case JSON_VALUE_TYPE_BOOL:
+            return a->as.boolean == b->as.boolean;
+        case JSON_VALUE_TYPE_NUMBER:
+            return a->number_type == b->number_type && (a->number_type == JSON_NUMBER_TYPE_INTEGER ? a->as.number == b->as.number : a->as.real == b->as.real);
+        case JSON_VALUE_TYPE_STRING:
+            return a->length == b->length && memcmp(a->as.string, b->as.string, a->length + 1) == 0;
+        case JSON_VALUE_TYPE_ARRAY:
+            for(uint32_t i = 0; a->length == b->length && i < a->length; i++) {
+                if(!fuzz_values_equal(&a->as.elements[i], &b->as.elements[i])) {
+                    return false;
+                }
+            }
+            return a->length == b->length;
+        case JSON_VALUE_TYPE_OBJECT:
+            for(uint32_t i = 0; a->length == b->length && i < a->length; i++) {
+                if(strcmp(a->as.members[i].key, b->as.members[i].key) != 0 || !fuzz_values_equal(&a->as.members[i].value, &b->as.members[i].value)) {
+                    return false;
+                }
+            }
+            return a->length == b->length;
+        default:
+            return true;
+    }
+}
+
+/**
+ * fuzz_parallel: Splice the input into an array that is large enough to be split across threads, and check that the
+ * parallel parser agrees with the sequential one.
+ * @param padding Bytes of filler after the input, out of two threads' worth. With half of them after it, a chunk boundary
+ * falls on or next to the input.
+ * @param closer The byte that ends the array. A brace makes the document malformed however the input ends.
+ */
+static void fuzz_parallel(const char *data, size_t length, size_t padding, char closer) {
+    size_t before           = 2 * FUZZ_PARALLEL_PADDING - padding;
+    size_t wrapped_length   = 1 + before + length + padding + 1;
+    char *wrapped           = malloc(wrapped_length + 1);
+    wrapped[0]              = '[';
+    // Long strings rather than small numbers, so that the filler is quick to parse.
+    for(size_t i = 0; i < before; i += 64) {
+        memcpy(wrapped + 1 + i, FUZZ_PARALLEL_FILLER ",", 64);
+    }
+    memcpy(wrapped + 1 + before, data, length);
+    for(size_t i = 0; i < padding; i += 64) {
+        memcpy(wrapped + 1 + before + length + i, "," FUZZ_PARALLEL_FILLER, 64);
+    }
+    wrapped[wrapped_length - 1] = closer;
+    wrapped[wrapped_length]     = '\0';
+
+    json_document_t *expected   = json_document_parse(wrapped);
+    json_document_t *document   = json_document_parse_parallel(wrapped, 4);
+    if((expected == NULL) != (document == NULL)) {
+        fuzz_fail(data, length, expected == NULL ? "the parallel parser accepts what the DOM rejects" : "the parallel parser rejects what the DOM accepts");
+    }
+    if(expected != NULL && (!fuzz_values_equal(json_document_get_root(expected), json_document_get_root(document))
+        || json_document_get_depth(expected) != json_document_get_depth(document))) {
+        fuzz_fail(data, length, "the parallel parser disagrees with the DOM");
+    }
+
+    json_document_destroy(expected);
+    json_document_destroy(document);
+    free(wrapped);
+}
+
+/**
+ * fuzz_one: Check one input. The readers that need a null terminated string only see the input up to its first null
+ * byte, so all of them are given that much.
+ * @param parallel Whether to also check the parallel parser, which has to parse arrays a few hundred times larger.
+ */
+static void fuzz_one(const uint8_t *input, size_t size, bool parallel) {
+    char *data = malloc(size + 1);
+    memcpy(data, input, size);
+    data[size]      = '\0';
+    size_t length   = strlen(data);
+
+    size_t index_length = 0;
+    uint32_t *index     = json_index_build(data, length, &index_length);
+    free(index);
+
+    size_t number_of_tokens = 0;
+    json_token_t *tokens    = json_lex(data, &number_of_tokens);
+    free(tokens);
+
+    json_node_t *node = json_parse_string(data);
+
+    size_t sax_count    = 0;
+    bool sax_accepted   = json_sax_parse(data, length, &fuzz_counting_handler, &sax_count);
+
+    size_t cursor_count = 0;
+    json_cursor_t cursor;
+    bool cursor_read    = json_cursor_init(&cursor, data, length) && fuzz_cursor_walk(&cursor, &cursor_count);
+    json_cursor_free(&cursor);
+
+    json_document_t *document = json_document_parse(data);
+    if(document != NULL) {
+        size_t dom_count = 0;
+        json_value_visit(json_document_get_root(document), fuzz_visit_count, &dom_count, NULL);
+
+        // The tree parser only takes documents whose root is an array or an object.
+        json_value_type_t root_type = json_document_get_root(document)->type;
+        if(node == NULL && (root_type == JSON_VALUE_TYPE_ARRAY || root_type == JSON_VALUE_TYPE_OBJECT)) {
+            fuzz_fail(data, length, "the tree parser rejects what the DOM accepts");
+        }
+        if(!sax_accepted || sax_count != dom_count) {
+            fuzz_fail(data, length, "the SAX parser disagrees with the DOM");
+        }
+        // The cursor validates lazily and accepts some input the DOM rejects, such as ["a":1], so it is only checked
+        // against documents the DOM accepts.
+        if(!cursor_read || cursor_count != dom_count) {
+            fuzz_fail(data, length, "the cursor disagrees with the DOM");
+        }
+        json_document_destroy(document);
+    }
+    else if(sax_accepted) {
+        fuzz_fail(data, length, "the SAX parser accepts what the DOM rejects");
+    }
+    else if(node != NULL) {
+        fuzz_fail(data, length, "the tree parser accepts what the DOM rejects");
+    }
+
+    json_node_destroy(node);
+
+    if(parallel) {
+        fuzz_parallel(data, length, FUZZ_PARALLEL_PADDING, ']');
+        fuzz_parallel(data, length, 0, '}');
+    }
+
+    free(data);
+}
+
+#ifdef JSON_FUZZ_WITH_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    fuzz_one(data, size, true);
+    return 0;
+}
+
+#else
+
+static const char *fuzz_seeds[] = {
+    "{}",
+    "[]",
+    "null",
+    "\"\"",
+    "[true, false, null]",
+    "{\"a\": {\"b\": [1, 2, {\"c\": \"d\"}]}, \"e\": []}",
+    "[\"escaped \\\" quote\", \"back\\\\slash\\\\\", \"\\u00e6\\n\\t\", \"{[,:]}\"]",
+    "[0, -0, 1.5, -2.25e-3, 1E+2, 4.9e-324, 1.7976931348623157e308, 9007199254740993]",
+    "[9223372036854775807, -9223372036854775808, 9223372036854775808, 123456789012345678901234567890]",
+    "{\"k00\": 0, \"k01\": 1, \"k02\": 2, \"k03\": 3, \"k04\": 4, \"k05\": 5, \"k06\": 6, \"k07\": 7, \"k08\": 8, \"k09\": 9,"
+    " \"k10\": 10, \"k11\": 11, \"k12\": 12, \"k13\": 13, \"k14\": 14, \"k15\": 15, \"k16\": 16, \"k17\": 17}",
+    "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]",
+    "{\"red\": [{\"red\": \"red\"}, \"blue\"], \"nested\": {\"deeper\": {\"deepest\": [-1, 0.5]}}}",
+    " \t\n[ 1 , \"two\" , { \"three\" : 3 } ]\r\n "
+};
+
+// Bytes that change the structure of a document when they are inserted.
+static const char fuzz_alphabet[] = "{}[]\",:\\ 0123456789-+.eEtrufalsn";
+
+/**
+ * fuzz_next: xorshift64, seeded the same way every run so that a failure is reproducible.
+ */
+static uint64_t fuzz_next(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static size_t fuzz_mutate(uint8_t *data, size_t length, uint64_t *state) {
+    size_t position = length == 0 ? 0 : fuzz_next(state) % length;
+
+    switch(fuzz_next(state) % 5) {
+        case 0: // Replace a byte with any byte.
+            if(length > 0) {
+                data[position] = (uint8_t)fuzz_next(state);
+            }
+            return length;
+        case 1: // Replace a byte with one that means something to a parser.
+            if(length > 0) {
+                data[position] = fuzz_alphabet[fuzz_next(state) % (sizeof(fuzz_alphabet) - 1)];
+            }
+            return length;
+        case 2: // Insert a byte that means something to a parser.
+            if(length == FUZZ_MAX_LENGTH) {
+                return length;
+            }
+            memmove(data + position + 1, data + position, length - position);
+            data[position] = fuzz_alphabet[fuzz_next(state) % (sizeof(fuzz_alphabet) - 1)];
+            return length + 1;
+        case 3: // Delete a run of bytes.
+            if(length == 0) {
+                return length;
+            }
+            size_t run = 1 + fuzz_next(state) % (length - position);
+            memmove(data + position, data + position + run, length - position - run);
+            return length - run;
+        default: // Copy a run of bytes over another place, which nests and repeats structure.
+            if(length == 0) {
+                return length;
+            }
+            size_t from     = fuzz_next(state) % length;
+            size_t count    = 1 + fuzz_next(state) % (length - from);
+            if(position + count > FUZZ_MAX_LENGTH) {
+                count = FUZZ_MAX_LENGTH - position;
+            }
+            memmove(data + position, data + from, count);
+            return position + count > length ? position + count : length;
+    }
+}
+
+static void fuzz_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if(file == NULL) {
+        fprintf(stderr, "%s:%s:%d: failed to open %s\n", __FILE__, __func__, __LINE__, path);
+        exit(EXIT_FAILURE);
+    }
+
+    uint8_t *data   = NULL;
+    size_t length   = 0;
+    size_t capacity = 0;
+    size_t read;
+    do {
+        if(length == capacity) {
+            capacity    = capacity == 0 ? 4096 : capacity * 2;
+            data        = realloc(data, capacity);
+        }
+        read    = fread(data + length, 1, capacity - length, file);
+        length  += read;
+    } while(read > 0);
+    fclose(file);
+
+    fuzz_one(data, length, true);
+    printf("%s(\"%s\") passed\n", __func__, path);
+    free(data);
+}
+
+void test_json_fuzz_seeds() {
+    for(size_t i = 0; i < sizeof(fuzz_seeds) / sizeof(fuzz_seeds[0]); i++) {
+        json_document_t *document = json_document_parse(fuzz_seeds[i]);
+        if(document == NULL) {
+            printf("%s failed: seed %zu is not valid JSON\n", __func__, i);
+            exit(EXIT_FAILURE);
+        }
+        json_document_destroy(document);
+
+        fuzz_one((const uint8_t*)fuzz_seeds[i], strlen(fuzz_seeds[i]), true);
+    }
+
+    printf("%s passed\n", __func__);
+}
+
+void test_json_fuzz_mutations(size_t iterations) {
+    static uint8_t data[FUZZ_MAX_LENGTH];
+    uint64_t state                  = 0x9e3779b97f4a7c15;
+    size_t number_of_seeds          = sizeof(fuzz_seeds) / sizeof(fuzz_seeds[0]);
+
+    for(size_t i = 0; i < iterations; i++) {
+        const char *seed    = fuzz_seeds[fuzz_next(&state) % number_of_seeds];
+        size_t length       = strlen(seed);
+        memcpy(data, seed, length);
+
+        size_t number_of_mutations = 1 + fuzz_next(&state) % 4;
+        for(size_t k = 0; k < number_of_mutations; k++) {
+            length = fuzz_mutate(data, length, &state);
+        }
+        fuzz_one(data, length, i % FUZZ_PARALLEL_EVERY == 0);
+    }
+
+    printf("%s(%zu) passed\n", __func__, iterations);
+}
+
+int main(int argc, char **argv) {
+    if(argc > 1) {
+        for(int i = 1; i < argc; i++) {
+            fuzz_file(argv[i]);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    test_json_fuzz_seeds();
+    test_json_fuzz_mutations(FUZZ_ITERATIONS);
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
+
+#endif
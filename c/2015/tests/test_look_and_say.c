@@ -0,0 +1,102 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "testing/assertions.h"
+#include "look_and_say.h"
+
+/**
+ * look_and_say_reference: The straightforward string to string step the engine replaces.
+ */
+static char *look_and_say_reference(const char *input) {
+    size_t length   = strlen(input);
+    char *result    = malloc(length * 3 + 1);
+    size_t position = 0;
+
+    for(size_t i = 0; i < length;) {
+        size_t run = 1;
+        while(i + run < length && input[i + run] == input[i]) {
+            run++;
+        }
+        position    += (size_t)sprintf(result + position, "%zu%c", run, input[i]);
+        i           += run;
+    }
+    result[position] = '\0';
+    return result;
+}
+
+void test_look_and_say_step(const char *input, const char *expected_result) {
+    // assign
+    look_and_say_t *sequence = look_and_say_create(input, strlen(input));
+
+    // act
+    look_and_say_step(sequence);
+    char *result = look_and_say_to_string(sequence);
+
+    // assert
+    assert_string_equality(expected_result, result, "look_and_say_step(\"%s\") != %s (%s)\n", input, expected_result, result);
+    assert_primitive_equality(strlen(expected_result), look_and_say_get_length(sequence), "look_and_say_get_length after \"%s\" was %zu\n", input, look_and_say_get_length(sequence));
+    printf("%s(\"%s\", \"%s\") passed\n", __func__, input, expected_result);
+    free(result);
+    look_and_say_destroy(sequence);
+}
+
+void test_look_and_say_create_rejects(const char *input) {
+    // assign, act
+    look_and_say_t *sequence = look_and_say_create(input, strlen(input));
+
+    // assert
+    assert_true((sequence == NULL), "look_and_say_create(\"%s\") should have failed\n", input);
+    printf("%s(\"%s\") passed\n", __func__, input);
+}
+
+/**
+ * Steps a sequence far enough that the threaded path splits it into chunks, and checks every term against the
+ * reference implementation.
+ */
+void test_look_and_say_matches_reference(const char *input, size_t steps, size_t number_of_threads) {
+    // assign
+    look_and_say_t *sequence    = look_and_say_create(input, strlen(input));
+    char *expected              = strdup(input);
+    look_and_say_set_number_of_threads(sequence, number_of_threads);
+
+    for(size_t i = 0; i < steps; i++) {
+        // act
+        bool stepped    = look_and_say_step(sequence);
+        char *next      = look_and_say_reference(expected);
+        free(expected);
+        expected        = next;
+
+        // assert
+        assert_true(stepped, "look_and_say_step failed at step %zu\n", i);
+        assert_primitive_equality(strlen(expected), look_and_say_get_length(sequence), "the length differs at step %zu\n", i);
+    }
+
+    char *result = look_and_say_to_string(sequence);
+    assert_string_equality(expected, result, "the term differs after %zu steps\n", steps);
+    printf("%s(\"%s\", %zu, %zu) passed\n", __func__, input, steps, number_of_threads);
+    free(result);
+    free(expected);
+    look_and_say_destroy(sequence);
+}
+
+int main() {
+    test_look_and_say_step("1", "11");
+    test_look_and_say_step("11", "21");
+    test_look_and_say_step("21", "1211");
+    test_look_and_say_step("1211", "111221");
+    test_look_and_say_step("111221", "312211");
+    test_look_and_say_step("222222222222", "122");
+    test_look_and_say_step("0", "10");
+
+    test_look_and_say_create_rejects("");
+    test_look_and_say_create_rejects("12a");
+    test_look_and_say_create_rejects("1111111111111111");
+
+    test_look_and_say_matches_reference("1113222113", 40, 1);
+    test_look_and_say_matches_reference("1113222113", 40, 4);
+    test_look_and_say_matches_reference("3113322113", 38, 3);
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "testing/assertions.h"
+#include "number4c.h"
+
+void test_number_parse_u64(const char *str, size_t expected_consumed, uint64_t expected_value) {
+    // assign
+    uint64_t value = 0;
+
+    // act
+    size_t consumed = number_parse_u64(str, strlen(str), &value);
+
+    // assert
+    assert_primitive_equality(expected_consumed, consumed, "number_parse_u64(\"%s\") consumed %zu bytes\n", str, consumed);
+    if(expected_consumed > 0) {
+        assert_primitive_equality(expected_value, value, "number_parse_u64(\"%s\") != %" PRIu64 " (%" PRIu64 ")\n", str, expected_value, value);
+    }
+    printf("%s(\"%s\", %zu) passed\n", __func__, str, expected_consumed);
+}
+
+void test_number_parse_i64(const char *str, size_t expected_consumed, int64_t expected_value) {
+    // assign
+    int64_t value = 0;
+
+    // act
+    size_t consumed = number_parse_i64(str, strlen(str), &value);
+
+    // assert
+    assert_primitive_equality(expected_consumed, consumed, "number_parse_i64(\"%s\") consumed %zu bytes\n", str, consumed);
+    if(expected_consumed > 0) {
+        assert_primitive_equality(expected_value, value, "number_parse_i64(\"%s\") != %" PRId64 " (%" PRId64 ")\n", str, expected_value, value);
+    }
+    printf("%s(\"%s\", %zu) passed\n", __func__, str, expected_consumed);
+}
+
+void test_number_parse_i32(const char *str, size_t expected_consumed, int32_t expected_value) {
+    // assign
+    int32_t value = 0;
+
+    // act
+    size_t consumed = number_parse_i32(str, strlen(str), &value);
+
+    // assert
+    assert_primitive_equality(expected_consumed, consumed, "number_parse_i32(\"%s\") consumed %zu bytes\n", str, consumed);
+    if(expected_consumed > 0) {
+        assert_primitive_equality(expected_value, value, "number_parse_i32(\"%s\") != %" PRId32 " (%" PRId32 ")\n", str, expected_value, value);
+    }
+    printf("%s(\"%s\", %zu) passed\n", __func__, str, expected_consumed);
+}
+
+/**
+ * Formats numbers of every length from 1 to 20 digits with snprintf and checks that parsing them gives the same value.
+ * This exercises the eight digit fast path with every possible remainder.
+ */
+void test_number_parse_u64_round_trip(void) {
+    // assign
+    uint64_t value = 0;
+    char buffer[32];
+
+    for(int digits = 1; digits <= 20; digits++) {
+        for(int variant = 0; variant < 10; variant++) {
+            value = 0;
+            for(int d = 0; d < digits; d++) {
+                value = value * 10 + (uint64_t)((d * 7 + variant * 3 + 1) % 10);
+            }
+            if(digits == 20 && value < 10000000000000000000ull) {
+                continue;
+            }
+            snprintf(buffer, sizeof(buffer), "%" PRIu64 ",", value);
+
+            // act
+            uint64_t result = 0;
+            size_t consumed = number_parse_u64(buffer, strlen(buffer), &result);
+
+            // assert
+            assert_primitive_equality(strlen(buffer) - 1, consumed, "number_parse_u64(\"%s\") consumed %zu bytes\n", buffer, consumed);
+            assert_primitive_equality(value, result, "number_parse_u64(\"%s\") != %" PRIu64 "\n", buffer, result);
+        }
+    }
+
+    printf("%s() passed\n", __func__);
+}
+
+void test_number_parse_f64(const char *str, size_t expected_consumed) {
+    // assign
+    double value    = 0;
+    double expected = strtod(str, NULL);
+
+    // act
+    size_t consumed = number_parse_f64(str, strlen(str), &value);
+
+    // assert
+    assert_primitive_equality(expected_consumed, consumed, "number_parse_f64(\"%s\") consumed %zu bytes\n", str, consumed);
+    if(expected_consumed > 0) {
+        assert_true((memcmp(&value, &expected, sizeof(double)) == 0), "number_parse_f64(\"%s\") != %a (%a)\n", str, expected, value);
+    }
+    printf("%s(\"%s\", %zu) passed\n", __func__, str, expected_consumed);
+}
+
+/**
+ * Formats random doubles with every precision from 1 to 17 significant digits, plus random significands with random
+ * exponents, and checks that parsing them gives exactly the double strtod does.
+ */
+void test_number_parse_f64_matches_strtod(void) {
+    // assign
+    uint64_t state = 88172645463325252ull;
+    char str[64];
+
+    for(size_t i = 0; i < 200000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        double random;
+        memcpy(&random, &state, sizeof(random));
+        if(i % 2 == 0 && isfinite(random)) {
+            snprintf(str, sizeof(str), "%.*g", (int)(i % 17) + 1, random);
+        }
+        else {
+            snprintf(str, sizeof(str), "%" PRIu64 "e%d", state >> (state % 64), (int)(state % 700) - 350);
+        }
+
+        // act
+        double value    = 0;
+        double expected = strtod(str, NULL);
+        size_t consumed = number_parse_f64(str, strlen(str), &value);
+
+        // assert
+        assert_primitive_equality(strlen(str), consumed, "number_parse_f64(\"%s\") consumed %zu bytes\n", str, consumed);
+        assert_true((memcmp(&value, &expected, sizeof(double)) == 0), "number_parse_f64(\"%s\") != %a (%a)\n", str, expected, value);
+    }
+    printf("%s passed\n", __func__);
+}
+
+void test_number_extract_i64(const char *str, size_t expected_result_length, int64_t *expected_result) {
+    // assign
+    int64_t result[16];
+
+    // act
+    size_t result_length = number_extract_i64(str, strlen(str), result, 16);
+
+    // assert
+    assert_primitive_equality(expected_result_length, result_length, "number_extract_i64(\"%s\") found %zu numbers\n", str, result_length);
+    for(size_t i = 0; i < result_length; i++) {
+        assert_primitive_equality(expected_result[i], result[i], "number %zu of \"%s\" was %" PRId64 "\n", i, str, result[i]);
+    }
+    printf("%s(\"%s\", %zu) passed\n", __func__, str, expected_result_length);
+}
+
+int main() {
+    test_number_parse_u64("0", 1, 0);
+    test_number_parse_u64("42", 2, 42);
+    test_number_parse_u64("123x", 3, 123);
+    test_number_parse_u64("12345678", 8, 12345678);
+    test_number_parse_u64("1234567890123456", 16, 1234567890123456ull);
+    test_number_parse_u64("18446744073709551615", 20, UINT64_MAX);
+    test_number_parse_u64("18446744073709551616", 0, 0);
+    test_number_parse_u64("100000000000000000000", 0, 0);
+    test_number_parse_u64("1234567:", 7, 1234567);
+    test_number_parse_u64("", 0, 0);
+    test_number_parse_u64("x1", 0, 0);
+    test_number_parse_u64("-1", 0, 0);
+
+    test_number_parse_i64("-42", 3, -42);
+    test_number_parse_i64("+42", 3, 42);
+    test_number_parse_i64("9223372036854775807", 19, INT64_MAX);
+    test_number_parse_i64("-9223372036854775808", 20, INT64_MIN);
+    test_number_parse_i64("9223372036854775808", 0, 0);
+    test_number_parse_i64("-", 0, 0);
+
+    test_number_parse_i32("2147483647", 10, INT32_MAX);
+    test_number_parse_i32("-2147483648", 11, INT32_MIN);
+    test_number_parse_i32("2147483648", 0, 0);
+
+    test_number_parse_u64_round_trip();
+
+    test_number_parse_f64("0", 1);
+    test_number_parse_f64("-0", 2);
+    test_number_parse_f64("1.5", 3);
+    test_number_parse_f64("-12.5e-3", 8);
+    test_number_parse_f64("1E+2,", 4);
+    test_number_parse_f64("0.1", 3);
+    test_number_parse_f64("1e23", 4);
+    test_number_parse_f64("9007199254740993", 16);
+    test_number_parse_f64("2.2250738585072011e-308", 23);
+    test_number_parse_f64("4.9e-324", 8);
+    test_number_parse_f64("2.4703282292062327e-324", 23);
+    test_number_parse_f64("1.7976931348623157e308", 22);
+    test_number_parse_f64("1.8e308", 7);
+    test_number_parse_f64("1e-400", 6);
+    test_number_parse_f64("123456789012345678901234567890", 30);
+    test_number_parse_f64("0.000000000000000000000000000000001234", 38);
+    test_number_parse_f64("1.", 0);
+    test_number_parse_f64(".5", 0);
+    test_number_parse_f64("1e", 0);
+    test_number_parse_f64("-", 0);
+    test_number_parse_f64_matches_strtod();
+
+    test_number_extract_i64("2x3x4", 3, (int64_t[]){ 2, 3, 4 });
+    test_number_extract_i64("Butterscotch: capacity -1, durability -2, flavor 6, texture 3, calories 8", 5, (int64_t[]){ -1, -2, 6, 3, 8 });
+    test_number_extract_i64("Vixen can fly 19 km/s for 7 seconds, but then must rest for 124 seconds.", 3, (int64_t[]){ 19, 7, 124 });
+    test_number_extract_i64("turn on 0,0 through 999,999", 4, (int64_t[]){ 0, 0, 999, 999 });
+    test_number_extract_i64("1 99999999999999999999 2", 2, (int64_t[]){ 1, 2 });
+    test_number_extract_i64("no numbers here", 0, NULL);
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "testing/assertions.h"
+#include "pattern4c.h"
+
+void test_pattern_compile(const char *format, bool expected_success, size_t expected_number_of_fields) {
+    // act
+    pattern_t *pattern = pattern_compile(format);
+
+    // assert
+    assert_primitive_equality(expected_success, (pattern != NULL), "pattern_compile(\"%s\") != %d\n", format, expected_success);
+    if(pattern != NULL) {
+        size_t number_of_fields = pattern_get_number_of_fields(pattern);
+        assert_primitive_equality(expected_number_of_fields, number_of_fields, "pattern_compile(\"%s\") has %zu fields\n", format, number_of_fields);
+    }
+    pattern_destroy(pattern);
+    printf("%s(\"%s\", %d) passed\n", __func__, format, expected_success);
+}
+
+/**
+ * Matches a line and compares every field against its expected value, formatted as a string so the expectations of
+ * every kind of field fit in one array.
+ */
+void test_pattern_match(const char *format, const char *line, bool expected_result, const char **expected_values) {
+    // assign
+    pattern_t *pattern = pattern_compile(format);
+    pattern_value_t values[16];
+    assert_not_null(pattern, "pattern_compile(\"%s\") failed\n", format);
+
+    // act
+    bool result = pattern_match(pattern, string_view_from_cstr(line), values);
+
+    // assert
+    assert_primitive_equality(expected_result, result, "pattern_match(\"%s\", \"%s\") != %d\n", format, line, expected_result);
+    for(size_t i = 0; result && i < pattern_get_number_of_fields(pattern); i++) {
+        char actual[64];
+        if(strncmp(expected_values[i], "word:", 5) == 0) {
+            snprintf(actual, sizeof(actual), "word:%.*s", (int)values[i].word.length, values[i].word.data);
+        }
+        else if(strncmp(expected_values[i], "choice:", 7) == 0) {
+            snprintf(actual, sizeof(actual), "choice:%zu", values[i].choice);
+        }
+        else {
+            snprintf(actual, sizeof(actual), "%" PRId64, values[i].integer);
+        }
+        assert_string_equality(expected_values[i], actual, "field %zu of \"%s\" != %s (%s)\n", i, line, expected_values[i], actual);
+    }
+    pattern_destroy(pattern);
+    printf("%s(\"%s\", \"%s\", %d) passed\n", __func__, format, line, expected_result);
+}
+
+void test_pattern_match_lines(void) {
+    // assign
+    pattern_t *pattern  = pattern_compile("{word} to {word} = {int}");
+    const char *text    = "London to Dublin = 464\r\nLondon to Belfast = 518\n\nDublin to Belfast = 141\nnot a route\nDublin to London = 1\n";
+    pattern_value_t values[5 * 3];
+
+    // act
+    size_t number_of_lines = pattern_match_lines(pattern, text, strlen(text), values, 5);
+
+    // assert
+    assert_primitive_equality((size_t)3, number_of_lines, "pattern_match_lines matched %zu lines\n", number_of_lines);
+    assert_primitive_equality((int64_t)518, values[1 * 3 + 2].integer, "the second distance is %" PRId64 "\n", values[1 * 3 + 2].integer);
+    assert_true(string_view_equals_cstr(values[2 * 3 + 1].word, "Belfast"), "the third destination is %.*s\n", (int)values[2 * 3 + 1].word.length, values[2 * 3 + 1].word.data);
+    pattern_destroy(pattern);
+    printf("%s() passed\n", __func__);
+}
+
+int main() {
+    test_pattern_compile("{word} to {word} = {int}", true, 3);
+    test_pattern_compile("{turn on|turn off|toggle} {int},{int}", true, 3);
+    test_pattern_compile("{{literal}} only", true, 0);
+    test_pattern_compile("{float}", false, 0);
+    test_pattern_compile("{a||b}", false, 0);
+    test_pattern_compile("{int", false, 0);
+    test_pattern_compile("int}", false, 0);
+
+    test_pattern_match("{word} to {word} = {int}", "London to Dublin = 464", true, (const char *[]){ "word:London", "word:Dublin", "464" });
+    test_pattern_match("{word} to {word} = {int}", "London to Dublin = 464 ", false, NULL);
+    test_pattern_match("{word} to {word} = {int}", "London to Dublin = x", false, NULL);
+    test_pattern_match("{turn on|turn off|toggle} {int},{int} through {int},{int}", "turn off 963,52 through 979,502", true, (const char *[]){ "choice:1", "963", "52", "979", "502" });
+    test_pattern_match("{turn on|turn off|toggle} {int},{int} through {int},{int}", "toggle 276,956 through 631,964", true, (const char *[]){ "choice:2", "276", "956", "631", "964" });
+    test_pattern_match("{turn on|turn off|toggle} {int},{int} through {int},{int}", "turn up 1,1 through 2,2", false, NULL);
+    test_pattern_match("{word}: capacity {int}, calories {int}", "Butterscotch: capacity -1, calories 8", true, (const char *[]){ "word:Butterscotch", "-1", "8" });
+    test_pattern_match("{word} would {gain|lose} {int} happiness units by sitting next to {word}.", "Alice would lose 79 happiness units by sitting next to Carol.", true, (const char *[]){ "word:Alice", "choice:1", "79", "word:Carol" });
+    test_pattern_match("{{{int}}}", "{42}", true, (const char *[]){ "42" });
+
+    test_pattern_match_lines();
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "testing/assertions.h"
+#include "simd4c.h"
+
+static const char *isa_names[] = { "scalar", "sse2", "avx2" };
+
+void test_simd_count_byte(simd_isa_t isa, const char *str, char c, size_t expected_result) {
+    // assign
+    simd_set_isa(isa);
+
+    // act
+    size_t result = simd_count_byte(str, strlen(str), c);
+
+    // assert
+    assert_primitive_equality(expected_result, result, "simd_count_byte(\"%s\", '%c') != %zu (%zu) on %s\n", str, c, expected_result, result, isa_names[isa]);
+    printf("%s(%s, \"%s\", '%c', %zu) passed\n", __func__, isa_names[isa], str, c, expected_result);
+}
+
+void test_simd_find_any(simd_isa_t isa, const char *str, const char *set, size_t expected_result) {
+    // assign
+    simd_set_isa(isa);
+
+    // act
+    size_t result = simd_find_any(str, strlen(str), set, strlen(set));
+
+    // assert
+    assert_primitive_equality(expected_result, result, "simd_find_any(\"%s\", \"%s\") != %zu (%zu) on %s\n", str, set, expected_result, result, isa_names[isa]);
+    printf("%s(%s, \"%s\", \"%s\", %zu) passed\n", __func__, isa_names[isa], str, set, expected_result);
+}
+
+void test_simd_all_in_range(simd_isa_t isa, const char *str, char low, char high, bool expected_result) {
+    // assign
+    simd_set_isa(isa);
+
+    // act
+    bool result = simd_all_in_range(str, strlen(str), (unsigned char)low, (unsigned char)high);
+
+    // assert
+    assert_primitive_equality(expected_result, result, "simd_all_in_range(\"%s\", '%c', '%c') != %d on %s\n", str, low, high, expected_result, isa_names[isa]);
+    printf("%s(%s, \"%s\", '%c', '%c', %d) passed\n", __func__, isa_names[isa], str, low, high, expected_result);
+}
+
+void test_simd_byte_set(simd_isa_t isa) {
+    // assign
+    simd_set_isa(isa);
+    simd_byte_set_t set = {0};
+    for(int c = 0; c < 256; c += 3) {
+        simd_byte_set_add(&set, (unsigned char)c);
+    }
+    char all_bytes[256];
+    for(int c = 0; c < 256; c++) {
+        all_bytes[c] = (char)c;
+    }
+
+    // act
+    size_t count = simd_count_in_set(all_bytes, sizeof(all_bytes), &set);
+
+    // assert
+    assert_primitive_equality((size_t)86, count, "simd_count_in_set counted %zu of the 256 bytes on %s\n", count, isa_names[isa]);
+    for(int c = 0; c < 256; c++) {
+        assert_primitive_equality((c % 3 == 0), simd_byte_set_contains(&set, (unsigned char)c), "simd_byte_set_contains(%d) is wrong\n", c);
+    }
+    assert_primitive_equality((size_t)1, simd_find_not_in_set(all_bytes, sizeof(all_bytes), &set), "simd_find_not_in_set did not stop at 1 on %s\n", isa_names[isa]);
+    printf("%s(%s) passed\n", __func__, isa_names[isa]);
+}
+
+/**
+ * Runs every kernel on random buffers of every length up to a few blocks, at every offset into the buffer, and checks
+ * that the vector paths agree with the scalar path. This covers the partial block at the end and unaligned loads.
+ */
+void test_simd_matches_scalar(simd_isa_t isa) {
+    // assign
+    char buffer[200];
+    uint32_t state = 12345;
+    for(size_t i = 0; i < sizeof(buffer); i++) {
+        state = state * 1103515245u + 12345u;
+        buffer[i] = (char)((state >> 16) % 8 == 0 ? 'x' : (state >> 8) & 0xFF);
+    }
+    const char *set     = "x\0\xff" "aeiou";
+    size_t set_length   = 8;
+    const char *big_set = "abcdefghijklmnopqrstuvwxyz";
+    // A set spread over every row of both tables, including the bytes the sign bit sends to the second one.
+    simd_byte_set_t byte_set = {0};
+    for(int c = 0; c < 256; c += 7) {
+        simd_byte_set_add(&byte_set, (unsigned char)c);
+    }
+    simd_byte_set_add(&byte_set, 'x');
+    simd_byte_set_add(&byte_set, 0xff);
+    simd_byte_set_t block_sets[2] = {0};
+    block_sets[0] = byte_set;
+    simd_byte_set_add(&block_sets[1], '\0');
+
+    for(size_t offset = 0; offset < 33; offset++) {
+        for(size_t length = 0; offset + length <= 160; length++) {
+            const char *data = buffer + offset;
+
+            // act
+            simd_set_isa(SIMD_ISA_SCALAR);
+            size_t expected_count       = simd_count_any(data, length, set, set_length);
+            size_t expected_big_count   = simd_count_any(data, length, big_set, 26);
+            size_t expected_find        = simd_find_any(data, length, set, set_length);
+            size_t expected_byte        = simd_find_byte(data, length, 'x');
+            size_t expected_range       = simd_find_not_in_range(data, length, 0x20, 0x7e);
+            size_t expected_in_set      = simd_count_in_set(data, length, &byte_set);
+            size_t expected_find_in_set = simd_find_in_set(data, length, &byte_set);
+            size_t expected_not_in_set  = simd_find_not_in_set(data, length, &byte_set);
+            uint64_t expected_masks[2];
+            simd_classify_block(data, length, block_sets, 2, expected_masks);
+
+            simd_set_isa(isa);
+            size_t count        = simd_count_any(data, length, set, set_length);
+            size_t big_count    = simd_count_any(data, length, big_set, 26);
+            size_t find         = simd_find_any(data, length, set, set_length);
+            size_t byte         = simd_find_byte(data, length, 'x');
+            size_t range        = simd_find_not_in_range(data, length, 0x20, 0x7e);
+            size_t in_set       = simd_count_in_set(data, length, &byte_set);
+            size_t find_in_set  = simd_find_in_set(data, length, &byte_set);
+            size_t not_in_set   = simd_find_not_in_set(data, length, &byte_set);
+            uint64_t masks[2];
+            simd_classify_block(data, length, block_sets, 2, masks);
+
+            // assert
+            assert_primitive_equality(expected_count, count, "simd_count_any differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_big_count, big_count, "simd_count_any with a large set differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_find, find, "simd_find_any differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_byte, byte, "simd_find_byte differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_range, range, "simd_find_not_in_range differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_in_set, in_set, "simd_count_in_set differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_find_in_set, find_in_set, "simd_find_in_set differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_not_in_set, not_in_set, "simd_find_not_in_set differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_masks[0], masks[0], "simd_classify_block differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+            assert_primitive_equality(expected_masks[1], masks[1], "simd_classify_block differs at offset %zu, length %zu on %s\n", offset, length, isa_names[isa]);
+        }
+    }
+
+    printf("%s(%s) passed\n", __func__, isa_names[isa]);
+}
+
+int main() {
+    simd_isa_t detected_isa = simd_get_isa();
+    printf("Detected instruction set: %s\n", isa_names[detected_isa]);
+
+    for(int isa = SIMD_ISA_SCALAR; isa <= SIMD_ISA_AVX2; isa++) {
+        if(!simd_set_isa((simd_isa_t)isa)) {
+            printf("Skipping %s, which is not supported on this CPU\n", isa_names[isa]);
+            continue;
+        }
+
+        test_simd_count_byte((simd_isa_t)isa, "", '(', 0);
+        test_simd_count_byte((simd_isa_t)isa, "(()(()(", '(', 5);
+        test_simd_count_byte((simd_isa_t)isa, "((((((((((((((((((((((((((((((((((((((((((()", ')', 1);
+
+        test_simd_find_any((simd_isa_t)isa, "hello world", "ow", 4);
+        test_simd_find_any((simd_isa_t)isa, "the quick brown fox jumps over the lazy dog", "z", 37);
+        test_simd_find_any((simd_isa_t)isa, "foobar", "xyz", 6);
+
+        test_simd_all_in_range((simd_isa_t)isa, "0123456789", '0', '9', true);
+        test_simd_all_in_range((simd_isa_t)isa, "01234567890123456789012345678901234567a9", '0', '9', false);
+        test_simd_all_in_range((simd_isa_t)isa, "", '0', '9', true);
+
+        test_simd_byte_set((simd_isa_t)isa);
+        test_simd_matches_scalar((simd_isa_t)isa);
+    }
+
+    simd_set_isa(detected_isa);
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "testing/assertions.h"
+#include "soa4c.h"
+
+#define POINT_FIELDS(X) \
+    X(int, x)           \
+    X(int, y)           \
+    X(char, label)
+
+typedef SOA_RECORD_OF_TYPE(POINT_FIELDS) point_record_t;
+typedef SOA_OF_TYPE(POINT_FIELDS) point_soa_t;
+
+CREATE_SOA_IMPL_FOR(point_soa_t, point_record_t, POINT_FIELDS)
+
+void test_soa_push_and_get(size_t capacity, size_t number_of_records) {
+    // assign
+    point_soa_t *soa = soa_create_point_soa_t(capacity);
+    assert_not_null(soa, "%s\n", "soa_create_point_soa_t returned null");
+
+    // act
+    for(size_t i = 0; i < number_of_records; i++) {
+        bool result = soa_push_point_soa_t(soa, (point_record_t){ .x = (int)i, .y = (int)(i * 2), .label = 'a' + (i % 26) });
+        assert_true(result, "soa_push_point_soa_t failed at index %zu\n", i);
+    }
+
+    // assert
+    assert_primitive_equality(soa->size, number_of_records, "soa->size != %zu (%zu)\n", number_of_records, soa->size);
+    for(size_t i = 0; i < number_of_records; i++) {
+        point_record_t record = soa_get_point_soa_t(soa, i);
+        assert_primitive_equality(record.x, (int)i, "record.x != %zu (%d)\n", i, record.x);
+        assert_primitive_equality(soa->y[i], (int)(i * 2), "soa->y[%zu] != %zu (%d)\n", i, i * 2, soa->y[i]);
+        assert_primitive_equality(soa->label[i], (char)('a' + (i % 26)), "soa->label[%zu] was %c\n", i, soa->label[i]);
+    }
+
+    printf("%s(%zu, %zu) passed\n", __func__, capacity, number_of_records);
+    soa_destroy_point_soa_t(soa);
+}
+
+void test_soa_set() {
+    // assign
+    point_soa_t *soa = soa_create_point_soa_t(2);
+    soa_push_point_soa_t(soa, (point_record_t){ .x = 1, .y = 2, .label = 'a' });
+    soa_push_point_soa_t(soa, (point_record_t){ .x = 3, .y = 4, .label = 'b' });
+
+    // act
+    soa_set_point_soa_t(soa, 0, (point_record_t){ .x = 5, .y = 6, .label = 'c' });
+
+    // assert
+    assert_primitive_equality(soa->x[0], 5, "soa->x[0] != 5 (%d)\n", soa->x[0]);
+    assert_primitive_equality(soa->y[0], 6, "soa->y[0] != 6 (%d)\n", soa->y[0]);
+    assert_primitive_equality(soa->x[1], 3, "soa->x[1] != 3 (%d)\n", soa->x[1]);
+
+    printf("%s passed\n", __func__);
+    soa_destroy_point_soa_t(soa);
+}
+
+void test_soa_resize_below_size() {
+    // assign
+    point_soa_t *soa = soa_create_point_soa_t(4);
+    for(int i = 0; i < 4; i++) {
+        soa_push_point_soa_t(soa, (point_record_t){ .x = i, .y = i, .label = 'a' });
+    }
+
+    // act
+    bool result = soa_resize_point_soa_t(soa, 2);
+
+    // assert
+    assert_primitive_equality(result, false, "%s\n", "soa_resize_point_soa_t(soa, 2) should fail when size is 4");
+    assert_primitive_equality(soa->allocated, 4, "soa->allocated != 4 (%zu)\n", soa->allocated);
+
+    printf("%s passed\n", __func__);
+    soa_destroy_point_soa_t(soa);
+}
+
+int main() {
+    test_soa_push_and_get(0, 1);
+    test_soa_push_and_get(1, 100);
+    test_soa_push_and_get(128, 128);
+    test_soa_set();
+    test_soa_resize_below_size();
+
+    printf("All tests passed\n");
+    return EXIT_SUCCESS;
+}
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "testing/assertions.h"
+#include "fnv.h"
 #include "string4c.h"
 
 void test_string_from_number(uint64_t n, char *expected_result) {
@@ -61,6 +62,60 @@ void test_string_buffer_append(const char *s1, const char *s2, const char *expec
     string_buffer_destroy(sb);
 }
 
+void test_string_buffer_append_number(int64_t n, const char *expected_result) {
+    // assign
+    string_buffer_t *sb = string_buffer_create(0);
+
+    // act
+    if(n >= 0) {
+        string_buffer_append_u64(sb, (uint64_t)n);
+    }
+    else {
+        string_buffer_append_i64(sb, n);
+    }
+
+    // assert
+    assert_string_equality(expected_result, sb->content, "appending %lld gave %s\n", (long long)n, sb->content);
+    assert_primitive_equality(strlen(expected_result), sb->length, "appending %lld gave length %zu\n", (long long)n, sb->length);
+    printf("%s(%lld, \"%s\") passed\n", __func__, (long long)n, expected_result);
+    string_buffer_destroy(sb);
+}
+
+void test_string_buffer_append_char(size_t count) {
+    // assign
+    string_buffer_t *sb = string_buffer_create(0);
+
+    // act
+    for(size_t i = 0; i < count; i++) {
+        string_buffer_append_char(sb, (char)('a' + i % 26));
+    }
+
+    // assert
+    assert_primitive_equality(count, sb->length, "string_buffer_append_char gave length %zu\n", sb->length);
+    assert_primitive_equality(count, strlen(sb->content), "the content of the buffer is not terminated at %zu\n", count);
+    for(size_t i = 0; i < count; i++) {
+        assert_primitive_equality((char)('a' + i % 26), sb->content[i], "unexpected character at index %zu\n", i);
+    }
+    printf("%s(%zu) passed\n", __func__, count);
+    string_buffer_destroy(sb);
+}
+
+void test_string_buffer_reserve_exact(size_t initial_capacity, size_t additional_length, size_t expected_capacity) {
+    // assign
+    string_buffer_t *sb = string_buffer_create(initial_capacity);
+    string_buffer_append_bytes(sb, "abc", 3);
+
+    // act
+    bool result = string_buffer_reserve_exact(sb, additional_length);
+
+    // assert
+    assert_true(result, "string_buffer_reserve_exact(%zu) failed\n", additional_length);
+    assert_primitive_equality(expected_capacity, sb->capacity, "string_buffer_reserve_exact(%zu) gave capacity %zu\n", additional_length, sb->capacity);
+    assert_string_equality("abc", sb->content, "string_buffer_reserve_exact changed the content to %s\n", sb->content);
+    printf("%s(%zu, %zu, %zu) passed\n", __func__, initial_capacity, additional_length, expected_capacity);
+    string_buffer_destroy(sb);
+}
+
 void test_string_unescape(const char *str, const char *expected_result) {
     // assign, act
     char *result = string_unescape(str);
@@ -81,6 +136,45 @@ void test_string_escape(const char *str, const char *expected_result) {
     free(result);
 }
 
+void test_string_escaped_lengths(const char *str) {
+    // assign
+    char *unescaped = string_unescape(str);
+    char *escaped   = string_escape(str);
+
+    // act
+    size_t unescaped_length = string_unescaped_length(str, strlen(str));
+    size_t escaped_length   = string_escaped_length(str, strlen(str));
+
+    // assert
+    assert_primitive_equality(strlen(unescaped), unescaped_length, "string_unescaped_length(\"%s\") != %zu (%zu)\n", str, strlen(unescaped), unescaped_length);
+    assert_primitive_equality(strlen(escaped), escaped_length, "string_escaped_length(\"%s\") != %zu (%zu)\n", str, strlen(escaped), escaped_length);
+    free(unescaped);
+    free(escaped);
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
+void test_string_owned(const char *str) {
+    // assign
+    string_owned_t owned;
+    string_owned_t other;
+    size_t length = strlen(str);
+
+    // act
+    bool result = string_owned_init(&owned, str, length);
+    string_owned_init(&other, str, length > 0 ? length - 1 : 0);
+
+    // assert
+    assert_true(result, "string_owned_init(\"%s\") failed\n", str);
+    assert_string_equality(str, string_owned_get(&owned), "string_owned_get(\"%s\") != %s\n", str, string_owned_get(&owned));
+    assert_primitive_equality((length <= STRING_OWNED_INLINE_CAPACITY), (string_owned_get(&owned) == owned.data.inline_data), "\"%s\" was not stored where expected\n", str);
+    assert_true(string_owned_equals(&owned, string_view_from_cstr(str)), "\"%s\" does not equal itself\n", str);
+    assert_primitive_equality(fnv1a_bytes(str, length), string_owned_hash(&owned), "string_owned_hash(\"%s\") is wrong\n", str);
+    assert_true((length == 0 || string_owned_compare(&other, &owned) < 0), "a prefix of \"%s\" does not sort first\n", str);
+    string_owned_free(&owned);
+    string_owned_free(&other);
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
 void test_string_trim(char *str, char *expected_result) {
     // assign, act
     char *result = string_trim(str);
@@ -139,6 +233,222 @@ void test_string_slice(const char *str, size_t start, size_t end, char *expected
     free(slice);
 }
 
+void test_string_view_trim(const char *str, const char *expected_result) {
+    // assign, act
+    string_view_t result = string_view_trim(string_view_from_cstr(str));
+
+    // assert
+    assert_true(string_view_equals_cstr(result, expected_result), "string_view_trim(\"%s\") != %s (%.*s)\n", str, expected_result, (int)result.length, result.data);
+    printf("%s(\"%s\", \"%s\") passed\n", __func__, str, expected_result);
+}
+
+void test_string_view_compare(const char *a, const char *b, int expected_sign) {
+    // assign, act
+    int result = string_view_compare(string_view_from_cstr(a), string_view_from_cstr(b));
+    int sign   = (result > 0) - (result < 0);
+
+    // assert
+    assert_primitive_equality(expected_sign, sign, "string_view_compare(\"%s\", \"%s\") had sign %d\n", a, b, sign);
+    printf("%s(\"%s\", \"%s\", %d) passed\n", __func__, a, b, expected_sign);
+}
+
+void test_string_view_find(const char *str, const char *needle, size_t expected_result) {
+    // assign, act
+    size_t result = string_view_find(string_view_from_cstr(str), string_view_from_cstr(needle));
+
+    // assert
+    assert_primitive_equality(expected_result, result, "string_view_find(\"%s\", \"%s\") != %zu (%zu)\n", str, needle, expected_result, result);
+    printf("%s(\"%s\", \"%s\", %zu) passed\n", __func__, str, needle, expected_result);
+}
+
+void test_string_view_parse_int(const char *str, bool expected_success, int64_t expected_value) {
+    // assign
+    int64_t value = 0;
+
+    // act
+    bool success = string_view_parse_int(string_view_from_cstr(str), &value);
+
+    // assert
+    assert_primitive_equality(expected_success, success, "string_view_parse_int(\"%s\") returned %d\n", str, success);
+    if(expected_success) {
+        assert_primitive_equality(expected_value, value, "string_view_parse_int(\"%s\") != %lld (%lld)\n", str, (long long)expected_value, (long long)value);
+    }
+    printf("%s(\"%s\") passed\n", __func__, str);
+}
+
+void test_string_tokenizer_next(const char *str, const char *delimiters, size_t expected_result_length, char **expected_result) {
+    // assign
+    string_tokenizer_t tokenizer    = string_tokenizer_create(string_view_from_cstr(str), delimiters);
+    string_view_t token;
+    size_t result_length            = 0;
+
+    // act, assert
+    while(string_tokenizer_next(&tokenizer, &token)) {
+        assert_true((result_length < expected_result_length), "string_tokenizer_next produced more than %zu tokens for \"%s\"\n", expected_result_length, str);
+        assert_true(string_view_equals_cstr(token, expected_result[result_length]), "token %zu was \"%.*s\", expected \"%s\"\n", result_length, (int)token.length, token.data, expected_result[result_length]);
+        assert_true((token.data >= str && token.data + token.length <= str + strlen(str)), "token %zu does not point into the input\n", result_length);
+        result_length++;
+    }
+
+    assert_primitive_equality(expected_result_length, result_length, "string_tokenizer_next produced %zu tokens for \"%s\"\n", result_length, str);
+    printf("%s(\"%s\", \"%s\", %zu) passed\n", __func__, str, delimiters, expected_result_length);
+}
+
+void test_string_view_split(const char *str, size_t max_tokens, size_t expected_result_length) {
+    // assign
+    string_view_t tokens[8];
+
+    // act
+    size_t result_length = string_view_split(string_view_from_cstr(str), " ", tokens, max_tokens);
+
+    // assert
+    assert_primitive_equality(expected_result_length, result_length, "string_view_split(\"%s\", %zu) produced %zu tokens\n", str, max_tokens, result_length);
+    printf("%s(\"%s\", %zu, %zu) passed\n", __func__, str, max_tokens, expected_result_length);
+}
+
+void test_string_rope_replace_at(const char *str, size_t position, size_t length, const char *replacement, const char *expected_result) {
+    // assign
+    string_rope_t *rope = string_rope_create(str);
+
+    // act
+    string_rope_replace_at(rope, position, length, replacement);
+    char *result = string_rope_to_cstr(rope);
+
+    // assert
+    assert_string_equality(expected_result, result, "string_rope_replace_at(\"%s\", %zu, %zu, \"%s\") != %s (%s)\n", str, position, length, replacement, expected_result, result);
+    assert_primitive_equality(strlen(expected_result), string_rope_get_length(rope), "string_rope_get_length after replacing in \"%s\" was %zu\n", str, string_rope_get_length(rope));
+    printf("%s(\"%s\", %zu, %zu, \"%s\", \"%s\") passed\n", __func__, str, position, length, replacement, expected_result);
+    free(result);
+    string_rope_destroy(rope);
+}
+
+/**
+ * Applies a long sequence of random replacements to a rope and to a plain character array, checking that lookups,
+ * substrings and searches agree after every edit.
+ */
+void test_string_rope_matches_array(size_t number_of_edits) {
+    // assign
+    static char expected[4096];
+    strcpy(expected, "HOHOHOHOHO");
+    string_rope_t *rope     = string_rope_create(expected);
+    const char *replacements[] = { "", "H", "O", "HO", "OH", "HOH", "e" };
+    uint32_t state          = 7;
+
+    for(size_t edit = 0; edit < number_of_edits; edit++) {
+        state = state * 1103515245u + 12345u;
+        size_t expected_length      = strlen(expected);
+        size_t position             = (state >> 8) % (expected_length + 1);
+        size_t length               = (state >> 20) % 4;
+        const char *replacement     = replacements[(state >> 4) % 7];
+        if(length > expected_length - position) {
+            length = expected_length - position;
+        }
+        if(expected_length - length + strlen(replacement) >= sizeof(expected)) {
+            continue;
+        }
+
+        // act
+        bool result = string_rope_replace_at(rope, position, length, replacement);
+        memmove(expected + position + strlen(replacement), expected + position + length, expected_length - position - length + 1);
+        memcpy(expected + position, replacement, strlen(replacement));
+
+        // assert
+        expected_length = strlen(expected);
+        assert_true(result, "string_rope_replace_at failed at edit %zu\n", edit);
+        assert_primitive_equality(expected_length, string_rope_get_length(rope), "unexpected length after edit %zu\n", edit);
+        if(expected_length > 0) {
+            size_t index = (state >> 3) % expected_length;
+            assert_primitive_equality(expected[index], string_rope_char_at(rope, index), "unexpected character at %zu after edit %zu\n", index, edit);
+        }
+
+        size_t from             = position > 2 ? position - 2 : 0;
+        const char *expected_match = strstr(expected + (from < expected_length ? from : expected_length), "HOH");
+        size_t expected_index   = expected_match == NULL ? STRING_VIEW_NPOS : (size_t)(expected_match - expected);
+        size_t index            = string_rope_find(rope, "HOH", from);
+        assert_primitive_equality(expected_index, index, "string_rope_find from %zu returned %zu after edit %zu\n", from, index, edit);
+    }
+
+    char *result = string_rope_to_cstr(rope);
+    char *middle = string_rope_substring(rope, strlen(expected) / 3, strlen(expected) / 2);
+    assert_string_equality(expected, result, "the rope differs from the reference after %zu edits\n", number_of_edits);
+    assert_primitive_equality(0, strncmp(middle, expected + strlen(expected) / 3, strlen(middle)), "string_rope_substring differs from the reference: %s\n", middle);
+    printf("%s(%zu) passed\n", __func__, number_of_edits);
+    free(middle);
+    free(result);
+    string_rope_destroy(rope);
+}
+
+void test_string_matcher_find_all(const char **patterns, size_t number_of_patterns, const char *text, size_t expected_result_length, string_match_t *expected_result) {
+    // assign
+    string_matcher_t *matcher   = string_matcher_create(patterns, number_of_patterns);
+    string_match_t result[16];
+
+    // act
+    size_t result_length = string_matcher_find_all(matcher, text, strlen(text), result, 16);
+
+    // assert
+    assert_primitive_equality(expected_result_length, result_length, "string_matcher_find_all(\"%s\") found %zu matches\n", text, result_length);
+    for(size_t i = 0; i < result_length; i++) {
+        assert_primitive_equality(expected_result[i].pattern_id, result[i].pattern_id, "match %zu had pattern id %zu\n", i, result[i].pattern_id);
+        assert_primitive_equality(expected_result[i].position, result[i].position, "match %zu had position %zu\n", i, result[i].position);
+    }
+    printf("%s(\"%s\", %zu) passed\n", __func__, text, expected_result_length);
+    string_matcher_destroy(matcher);
+}
+
+/**
+ * Checks the matcher against a strstr loop per pattern on random text over a small alphabet, where matches overlap a lot.
+ */
+void test_string_matcher_matches_strstr(size_t text_length) {
+    // assign
+    const char *patterns[]  = { "a", "ab", "bab", "abba", "bb", "aaa", "ba", "abab" };
+    size_t number_of_patterns = sizeof(patterns) / sizeof(patterns[0]);
+    char text[512];
+    uint32_t state = 99;
+    for(size_t i = 0; i < text_length; i++) {
+        state       = state * 1103515245u + 12345u;
+        text[i]     = (state >> 16) & 1 ? 'a' : 'b';
+    }
+    text[text_length] = '\0';
+
+    size_t expected_counts[8] = {0};
+    for(size_t p = 0; p < number_of_patterns; p++) {
+        for(const char *match = strstr(text, patterns[p]); match != NULL; match = strstr(match + 1, patterns[p])) {
+            expected_counts[p]++;
+        }
+    }
+
+    string_matcher_t *matcher   = string_matcher_create(patterns, number_of_patterns);
+    string_match_t *matches     = malloc(text_length * number_of_patterns * sizeof(string_match_t));
+
+    // act
+    size_t number_of_matches = string_matcher_find_all(matcher, text, text_length, matches, text_length * number_of_patterns);
+
+    // assert
+    size_t counts[8] = {0};
+    for(size_t i = 0; i < number_of_matches; i++) {
+        const char *pattern = patterns[matches[i].pattern_id];
+        assert_primitive_equality(0, strncmp(text + matches[i].position, pattern, strlen(pattern)), "match %zu of \"%s\" at %zu is not an occurrence\n", i, pattern, matches[i].position);
+        counts[matches[i].pattern_id]++;
+    }
+    for(size_t p = 0; p < number_of_patterns; p++) {
+        assert_primitive_equality(expected_counts[p], counts[p], "pattern \"%s\" was found %zu times instead of %zu\n", patterns[p], counts[p], expected_counts[p]);
+    }
+    printf("%s(%zu) passed\n", __func__, text_length);
+    free(matches);
+    string_matcher_destroy(matcher);
+}
+
+void test_string_replace_all_multiple(const char *str, const char **old_strs, const char **new_strs, size_t number_of_pairs, const char *expected) {
+    // assign, act
+    char *result = string_replace_all_multiple(str, old_strs, new_strs, number_of_pairs);
+
+    // assert
+    assert_string_equality(expected, result, "string_replace_all_multiple(\"%s\") != %s (%s)\n", str, expected, result);
+    printf("%s(\"%s\", \"%s\") passed\n", __func__, str, expected);
+    free(result);
+}
+
 int main() {
     test_string_from_number(0, "0");
     test_string_from_number(1, "1");
@@ -158,6 +468,21 @@ int main() {
    
     test_string_buffer_append("foo", "bar", "foobar");
 
+    test_string_buffer_append_number(0, "0");
+    test_string_buffer_append_number(7, "7");
+    test_string_buffer_append_number(42, "42");
+    test_string_buffer_append_number(100, "100");
+    test_string_buffer_append_number(1234567890123, "1234567890123");
+    test_string_buffer_append_number(INT64_MAX, "9223372036854775807");
+    test_string_buffer_append_number(-5, "-5");
+    test_string_buffer_append_number(INT64_MIN, "-9223372036854775808");
+
+    test_string_buffer_append_char(0);
+    test_string_buffer_append_char(1000);
+
+    test_string_buffer_reserve_exact(4, 100, 104);
+    test_string_buffer_reserve_exact(200, 100, 200);
+
     test_string_unescape("\\\"\\\"", "\"\"");
     test_string_unescape("\\\"abc\\\"", "\"abc\"");
     test_string_unescape("aaa\\\"aaa", "aaa\"aaa");
@@ -167,6 +492,22 @@ int main() {
     test_string_escape("\"abc\"", "\"\\\"abc\\\"\"");
     test_string_escape("\"aaa\\\"aaa\"", "\"\\\"aaa\\\\\\\"aaa\\\"\"");
     test_string_escape("\"\\x27\"", "\"\\\"\\\\x27\\\"\"");
+
+    test_string_owned("");
+    test_string_owned("London");
+    test_string_owned("12345678901234567890123");
+    test_string_owned("123456789012345678901234");
+    test_string_owned("a string much longer than fits inside the struct");
+
+    test_string_escaped_lengths("\"\"");
+    test_string_escaped_lengths("\"abc\"");
+    test_string_escaped_lengths("\"aaa\\\"aaa\"");
+    test_string_escaped_lengths("\"\\x27\"");
+    test_string_escaped_lengths("\"\\x00\\\\\"");
+    test_string_escaped_lengths("\"\\xg7\\q\"");
+    test_string_escaped_lengths("\"a long line without any escapes that spans more than one vector\"");
+    test_string_escaped_lengths("\"\\x4");
+    test_string_escaped_lengths("\\");
     
     test_string_split("foobar", "", 0, (char *[]){});
     
@@ -194,6 +535,15 @@ int main() {
     test_string_replace("foobarbaz", "foo", "lorem", "lorembarbaz");
     
     test_string_replace_all("foobarbazfoobarbaz", "foo", "loremipsum", "loremipsumbarbazloremipsumbarbaz");
+    test_string_replace_all("foobarbazfoobarbaz", "foo", "x", "xbarbazxbarbaz");
+    test_string_replace_all("aaaa", "aa", "b", "bb");
+    test_string_replace_all("abc", "abc", "", "");
+    test_string_replace_all("HOH", "H", "HO", "HOOHO");
+    test_string_replace_all("foobar", "baz", "qux", "foobar");
+
+    test_string_replace_all_multiple("CRnFYFYFAr", (const char *[]){ "Rn", "Y", "Ar" }, (const char *[]){ "(", ",", ")" }, 3, "C(F,F,F)");
+    test_string_replace_all_multiple("abcd", (const char *[]){ "bc", "abc", "cd" }, (const char *[]){ "1", "2", "3" }, 3, "2d");
+    test_string_replace_all_multiple("xyz", (const char *[]){ "q" }, (const char *[]){ "r" }, 1, "xyz");
 /*    test_string_replace_at("Hello World!", "Farewell", 0, 5, "Farewell World!");
     test_string_replace_at("Lorem Ipsum", "Dolor", 6, 1, "Lorem Dolorpsum");
     test_string_replace_at("HOH", "HO", 0, 1, "HOOH");
@@ -204,6 +554,68 @@ int main() {
 
     test_string_slice("foo bar baz", 4, 7, "bar");
 
+    test_string_view_trim("foobar", "foobar");
+    test_string_view_trim("  foo bar \t\n", "foo bar");
+    test_string_view_trim("   ", "");
+    test_string_view_trim("", "");
+
+    test_string_view_compare("abc", "abc", 0);
+    test_string_view_compare("abc", "abd", -1);
+    test_string_view_compare("abc", "ab", 1);
+    test_string_view_compare("", "a", -1);
+
+    test_string_view_find("foo bar baz", "bar", 4);
+    test_string_view_find("foo bar baz", "baz", 8);
+    test_string_view_find("aaab", "aab", 1);
+    test_string_view_find("foo", "foobar", STRING_VIEW_NPOS);
+    test_string_view_find("foo", "", 0);
+
+    test_string_view_parse_int("0", true, 0);
+    test_string_view_parse_int("123", true, 123);
+    test_string_view_parse_int("-42", true, -42);
+    test_string_view_parse_int("+7", true, 7);
+    test_string_view_parse_int("9223372036854775807", true, INT64_MAX);
+    test_string_view_parse_int("-9223372036854775808", true, INT64_MIN);
+    test_string_view_parse_int("9223372036854775808", false, 0);
+    test_string_view_parse_int("", false, 0);
+    test_string_view_parse_int("-", false, 0);
+    test_string_view_parse_int("12a", false, 0);
+
+    test_string_tokenizer_next("he ll o wo rld", " ", 5, (char *[]){ "he", "ll", "o", "wo", "rld" });
+    test_string_tokenizer_next("  leading and  trailing  ", " ", 3, (char *[]){ "leading", "and", "trailing" });
+    test_string_tokenizer_next("a -> b\r\nc", " ->\r\n", 3, (char *[]){ "a", "b", "c" });
+    test_string_tokenizer_next("", " ", 0, (char *[]){ NULL });
+
+    test_string_view_split("a b c", 8, 3);
+    test_string_view_split("a b c d e", 2, 2);
+    test_string_view_split("   ", 8, 0);
+
+    test_string_rope_replace_at("Hello World!", 0, 5, "Farewell", "Farewell World!");
+    test_string_rope_replace_at("Lorem Ipsum", 6, 1, "Dolor", "Lorem Dolorpsum");
+    test_string_rope_replace_at("HOH", 2, 1, "HO", "HOHO");
+    test_string_rope_replace_at("HOH", 3, 0, "H", "HOHH");
+    test_string_rope_replace_at("HOH", 1, 5, "", "H");
+    test_string_rope_replace_at("", 0, 0, "e", "e");
+
+    test_string_rope_matches_array(20000);
+
+    test_string_matcher_find_all((const char *[]){ "he", "she", "his", "hers" }, 4, "ushers", 3, (string_match_t[]){
+        { .pattern_id = 1, .position = 1 },
+        { .pattern_id = 0, .position = 2 },
+        { .pattern_id = 3, .position = 2 }
+    });
+    test_string_matcher_find_all((const char *[]){ "ab", "cd", "pq", "xy" }, 4, "haegwjzuvuyypxyu", 1, (string_match_t[]){
+        { .pattern_id = 3, .position = 13 }
+    });
+    test_string_matcher_find_all((const char *[]){ "ab", "cd", "pq", "xy" }, 4, "ugknbfddgicrmopn", 0, NULL);
+    test_string_matcher_find_all((const char *[]){ "H", "HO", "O" }, 3, "HOH", 4, (string_match_t[]){
+        { .pattern_id = 0, .position = 0 },
+        { .pattern_id = 1, .position = 0 },
+        { .pattern_id = 2, .position = 1 },
+        { .pattern_id = 0, .position = 2 }
+    });
+    test_string_matcher_matches_strstr(400);
+
     printf("All tests passed\n");
     return EXIT_SUCCESS;
 }